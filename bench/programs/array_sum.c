@@ -0,0 +1,25 @@
+#include <stdio.h>
+
+static long values[4096];
+
+int main(void) {
+    long rounds = 0;
+    if (scanf("%ld", &rounds) != 1) {
+        return 1;
+    }
+
+    for (long i = 0; i < 4096; ++i) {
+        values[i] = (i * 40503) ^ (long)((unsigned long)i >> 3);
+    }
+
+    long sum = 0;
+    for (long round = 0; round < rounds; ++round) {
+        for (long i = 0; i < 4096; ++i) {
+            sum += values[i];
+        }
+        sum ^= round;
+    }
+
+    printf("%ld\n", sum);
+    return 0;
+}
@@ -0,0 +1,22 @@
+#include <stdio.h>
+
+int main(void) {
+    long n = 0;
+    if (scanf("%ld", &n) != 1) {
+        return 1;
+    }
+
+    unsigned long state = 88172645;
+    long bits = 0;
+    for (long i = 0; i < n; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        for (unsigned long x = state; x != 0; x >>= 1) {
+            bits += (long)(x & 1);
+        }
+    }
+
+    printf("%ld %ld\n", bits, (long)state);
+    return 0;
+}
@@ -0,0 +1,20 @@
+#include <stdio.h>
+
+static long factorial(long x) {
+    return x < 2 ? x : x * factorial(x - 1);
+}
+
+int main(void) {
+    long n = 0;
+    if (scanf("%ld", &n) != 1) {
+        return 1;
+    }
+
+    long sum = 0;
+    for (long i = 0; i < n; ++i) {
+        sum += factorial(i % 20 + 1);
+    }
+
+    printf("%ld\n", sum);
+    return 0;
+}
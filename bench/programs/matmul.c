@@ -0,0 +1,35 @@
+#include <stdio.h>
+
+static long a[4096];
+static long b[4096];
+static long c[4096];
+
+int main(void) {
+    long n = 0;
+    long rounds = 0;
+    if (scanf("%ld %ld", &n, &rounds) != 2) {
+        return 1;
+    }
+
+    for (long i = 0; i < n * n; ++i) {
+        a[i] = (i & 15) - 7;
+        b[i] = ((i * 7) & 31) - 16;
+    }
+
+    long checksum = 0;
+    for (long round = 0; round < rounds; ++round) {
+        for (long i = 0; i < n; ++i) {
+            for (long j = 0; j < n; ++j) {
+                long acc = 0;
+                for (long k = 0; k < n; ++k) {
+                    acc += a[i * n + k] * b[k * n + j];
+                }
+                c[i * n + j] = acc + round;
+            }
+        }
+        checksum += c[(round * 97) & (n * n - 1)];
+    }
+
+    printf("%ld\n", checksum);
+    return 0;
+}
@@ -0,0 +1,20 @@
+#include <stdio.h>
+
+int main(void) {
+    long n = 0;
+    if (scanf("%ld", &n) != 1) {
+        return 1;
+    }
+
+    long sum = 0;
+    for (long i = 0; i < n; ++i) {
+        for (long j = 0; j < n; ++j) {
+            for (long k = 0; k < n; ++k) {
+                sum += (i * j) ^ k;
+            }
+        }
+    }
+
+    printf("%ld\n", sum);
+    return 0;
+}
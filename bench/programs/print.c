@@ -0,0 +1,13 @@
+#include <stdio.h>
+
+int main(void) {
+    long n = 0;
+    if (scanf("%ld", &n) != 1) {
+        return 1;
+    }
+
+    for (long i = 0; i < n; ++i) {
+        printf("line %ld: %ld %s\n", i, i * i, "morning");
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+"""
+Runtime benchmarks of generated code
+====================================
+Compiles every kernel in this directory with morninglang at each
+optimization level, and its C reference with the C compiler at the same
+level. Each binary runs several times on the kernel's input; the report
+shows median runtime and binary size side by side, and flags kernels
+whose output differs from the C reference.
+
+Usage:
+  bench/programs/run.py [--compiler ./build/bin/morninglang] [--runs 5]
+                        [--levels 0,1,2,3,s] [--json results.json]
+"""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+PROGRAMS_DIR = Path(__file__).resolve().parent
+
+# Input fed to stdin, sized for runs of roughly 0.1-1 s at -O2
+INPUTS = {
+    "fib": "35\n",
+    "factorial": "5000000\n",
+    "nested_loops": "400\n",
+    "array_sum": "20000\n",
+    "matmul": "64 200\n",
+    "bits": "2000000\n",
+    "print": "500000\n",
+}
+
+
+def compile_morning(compiler, source, level, workdir):
+    """Compile a kernel; morninglang writes the binary to the working directory."""
+    name = f"{source.stem}-morning-O{level}"
+    result = subprocess.run(
+        [compiler, "--no-cache", "--log-level", "error", "-f", str(source), "-o", name, "-O", level],
+        cwd=workdir,
+        capture_output=True,
+        text=True,
+    )
+    binary = workdir / name
+    if result.returncode != 0 or not binary.exists():
+        sys.stderr.write(f"morninglang failed on {source.name} at -O{level} (exit code {result.returncode}):\n"
+                         f"{result.stdout}{result.stderr}\n")
+        return None
+    return binary
+
+
+def compile_c(cc, source, level, workdir):
+    binary = workdir / f"{source.stem}-c-O{level}"
+    result = subprocess.run([cc, f"-O{level}", str(source), "-o", str(binary)], capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.stderr.write(f"{cc} failed on {source.name} at -O{level}:\n{result.stderr}\n")
+        return None
+    return binary
+
+
+def measure(binary, stdin, runs):
+    """Run binary repeatedly, return median wall time in ms and the output of the first run."""
+    times = []
+    output = None
+    for _ in range(runs):
+        start = time.perf_counter()
+        result = subprocess.run([str(binary)], input=stdin, capture_output=True, text=True)
+        times.append((time.perf_counter() - start) * 1000.0)
+        if output is None:
+            output = result.stdout
+    return statistics.median(times), output
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Runtime benchmarks of Morning programs against C references")
+    parser.add_argument("--compiler", default="./build/bin/morninglang", help="morninglang binary")
+    parser.add_argument("--cc", default=os.environ.get("CC", "cc"), help="C compiler for the references")
+    parser.add_argument("--runs", type=int, default=5, help="runs per binary, the median is reported")
+    parser.add_argument("--levels", default="0,1,2,3,s", help="comma separated optimization levels")
+    parser.add_argument("--filter", default="", help="only run kernels whose name contains this")
+    parser.add_argument("--json", help="write results to this file")
+    args = parser.parse_args()
+
+    compiler = str(Path(args.compiler).resolve())
+    levels = args.levels.split(",")
+    results = []
+    failed = False
+
+    print(f"{'Kernel':<14}{'Level':>6}{'Morning ms':>12}{'C ms':>10}{'Ratio':>8}"
+          f"{'Morning B':>12}{'C B':>10}  Output")
+
+    with tempfile.TemporaryDirectory(prefix="morning-bench-") as tmp:
+        workdir = Path(tmp)
+
+        for name, stdin in INPUTS.items():
+            if args.filter not in name:
+                continue
+
+            for level in levels:
+                morning_bin = compile_morning(compiler, PROGRAMS_DIR / f"{name}.morning", level, workdir)
+                c_bin = compile_c(args.cc, PROGRAMS_DIR / f"{name}.c", level, workdir)
+                if morning_bin is None or c_bin is None:
+                    failed = True
+                    continue
+
+                morning_ms, morning_out = measure(morning_bin, stdin, args.runs)
+                c_ms, c_out = measure(c_bin, stdin, args.runs)
+                entry = {
+                    "kernel": name,
+                    "level": level,
+                    "morning_ms": morning_ms,
+                    "c_ms": c_ms,
+                    "ratio": morning_ms / c_ms if c_ms > 0 else None,
+                    "morning_bytes": morning_bin.stat().st_size,
+                    "c_bytes": c_bin.stat().st_size,
+                    "output_matches": morning_out == c_out,
+                }
+                results.append(entry)
+                failed = failed or not entry["output_matches"]
+
+                ratio = f"{entry['ratio']:.2f}" if entry["ratio"] is not None else "-"
+                print(f"{name:<14}{'-O' + level:>6}{morning_ms:>12.2f}{c_ms:>10.2f}{ratio:>8}"
+                      f"{entry['morning_bytes']:>12}{entry['c_bytes']:>10}  "
+                      f"{'ok' if entry['output_matches'] else 'MISMATCH'}")
+
+    if args.json:
+        with open(args.json, "w") as out:
+            json.dump({"runs": args.runs, "results": results}, out, indent=2)
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
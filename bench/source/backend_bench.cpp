@@ -0,0 +1,91 @@
+#include <chrono>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "compiler.hpp"
+#include "generators.hpp"
+#include "logger.hpp"
+#include "morningllvm.hpp"
+
+namespace {
+    /**
+     * @brief Time the optimizer and object emission on a verified module
+     *
+     * The frontend runs outside the measured time for every iteration, since
+     * both the pass pipeline and the code generator modify the module.
+     * Argument 0 selects O0 or O2 for both.
+     */
+    void bm_backend_workload(benchmark::State& state, bench::generator generate, size_t size) {
+        const std::string SOURCE = generate(size);
+        const bool OPTIMIZE = state.range(0) != 0;
+        Logger::set_level(Logger::Level::ERROR);
+
+        llvm_compiler backend;
+        if (backend.get_target_machine() == nullptr) {
+            state.SkipWithError("Native target is not available");
+            return;
+        }
+        backend.set_opt_level(OPTIMIZE ? llvm::CodeGenOptLevel::Default : llvm::CodeGenOptLevel::None);
+
+        size_t object_bytes = 0;
+
+        for (auto _ : state) {
+            MorningLanguageLLVM compiler;
+            if (compiler.execute(SOURCE) != 0) {
+                state.SkipWithError("Program failed to compile");
+                break;
+            }
+
+            const auto START = std::chrono::steady_clock::now();
+
+            compiler.optimize(OPTIMIZE ? llvm::OptimizationLevel::O2 : llvm::OptimizationLevel::O0,
+                              backend.get_target_machine());
+
+            llvm::SmallVector<char, 0> object;
+            if (!backend.compile_module_to_buffer(compiler.get_module(), object)) {
+                state.SkipWithError("Object code generation failed");
+                break;
+            }
+
+            state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - START).count());
+            object_bytes = object.size();
+        }
+
+        Logger::set_level(Logger::Level::NOTE);
+        state.counters["object_bytes"] = static_cast<double>(object_bytes);
+    }
+}    // namespace
+
+// Code generation of large modules takes seconds, so the function count
+// stays an order of magnitude below the frontend benchmarks
+BENCHMARK_CAPTURE(bm_backend_workload, nested_scopes, &bench::generate_nested_scopes, 1024)
+    ->Arg(0)
+    ->Arg(2)
+    ->ArgName("opt")
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bm_backend_workload, functions, &bench::generate_program, 1000)
+    ->Arg(0)
+    ->Arg(2)
+    ->ArgName("opt")
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bm_backend_workload, string_table, &bench::generate_string_table, 10000)
+    ->Arg(0)
+    ->Arg(2)
+    ->ArgName("opt")
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bm_backend_workload, big_array, &bench::generate_big_array, 10000)
+    ->Arg(0)
+    ->Arg(2)
+    ->ArgName("opt")
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bm_backend_workload, arithmetic_chain, &bench::generate_arithmetic_chain, 4096)
+    ->Arg(0)
+    ->Arg(2)
+    ->ArgName("opt")
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
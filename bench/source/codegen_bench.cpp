@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include "generators.hpp"
+#include "logger.hpp"
+#include "morningllvm.hpp"
+#include "time_report.hpp"
+
+namespace {
+    /**
+     * @brief Points stdout at /dev/null while alive, so logging is measured without a terminal
+     */
+    class silenced_stdout {
+      public:
+        silenced_stdout()
+            : m_SAVED_FD(dup(STDOUT_FILENO)) {
+            std::fflush(stdout);
+            const int NULL_FD = open("/dev/null", O_WRONLY);
+            dup2(NULL_FD, STDOUT_FILENO);
+            close(NULL_FD);
+        }
+
+        ~silenced_stdout() {
+            std::fflush(stdout);
+            dup2(m_SAVED_FD, STDOUT_FILENO);
+            close(m_SAVED_FD);
+        }
+
+        silenced_stdout(const silenced_stdout&) = delete;
+        auto operator=(const silenced_stdout&) -> silenced_stdout& = delete;
+
+      private:
+        int m_SAVED_FD;
+    };
+
+    // Levels below MORNING_LOG_LEVEL are compiled out, so "logging on" only
+    // shows the DEBUG cost in builds configured with morninglang_LOG_LEVEL=NOTE
+    void bm_codegen(benchmark::State& state) {
+        const std::string SOURCE = bench::generate_program(static_cast<size_t>(state.range(0)));
+        Logger::set_level(state.range(1) != 0 ? Logger::Level::NOTE : Logger::Level::ERROR);
+
+        {
+            silenced_stdout silenced;
+
+            for (auto _ : state) {
+                MorningLanguageLLVM compiler;
+                benchmark::DoNotOptimize(compiler.execute(SOURCE));
+            }
+        }
+
+        Logger::set_level(Logger::Level::NOTE);
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(SOURCE.size()));
+    }
+
+    /**
+     * @brief Time generate_expression over the whole program, without parsing and verification
+     *
+     * execute() records its phases in a time_report; only the codegen phase
+     * is reported as the iteration time.
+     */
+    void bm_generate_workload(benchmark::State& state, bench::generator generate, size_t size) {
+        const std::string SOURCE = generate(size);
+        Logger::set_level(Logger::Level::ERROR);
+
+        for (auto _ : state) {
+            time_report report;
+            MorningLanguageLLVM compiler;
+            compiler.set_time_report(&report);
+
+            if (compiler.execute(SOURCE) != 0) {
+                state.SkipWithError("Program failed to compile");
+                break;
+            }
+
+            const auto& phases = report.phases();
+            const auto CODEGEN = std::find_if(
+                phases.begin(), phases.end(), [](const time_report::phase& entry) { return entry.name == "codegen"; });
+            state.SetIterationTime(CODEGEN->wall_ms / 1000.0);
+        }
+
+        Logger::set_level(Logger::Level::NOTE);
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(SOURCE.size()));
+    }
+}    // namespace
+
+BENCHMARK(bm_codegen)
+    ->ArgsProduct({{16, 256}, {0, 1}})
+    ->ArgNames({"functions", "logging"})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(bm_generate_workload, nested_scopes, &bench::generate_nested_scopes, 1024)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bm_generate_workload, functions, &bench::generate_program, 10000)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bm_generate_workload, string_table, &bench::generate_string_table, 10000)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bm_generate_workload, big_array, &bench::generate_big_array, 10000)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bm_generate_workload, arithmetic_chain, &bench::generate_arithmetic_chain, 4096)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
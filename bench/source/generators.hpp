@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace bench {
+    /**
+     * @brief Source generator taking the workload size, passed to BENCHMARK_CAPTURE
+     */
+    using generator = std::string (*)(size_t);
+
+    /**
+     * @brief Generate source of roughly the given size covering all token classes
+     */
+    inline auto generate_source(size_t size) -> std::string {
+        std::string source;
+        source.reserve(size + 256);
+
+        for (size_t i = 0; source.size() < size; ++i) {
+            const std::string INDEX = std::to_string(i);
+            source += "// function " + INDEX + "\n";
+            source += "[func f" + INDEX + " [(x !int) (y !frac)] -> !int\n";
+            source += "  /* body */ [scope [var (z !int) 0x1F] [set z [+ z 0b101]]\n";
+            source += "    [fprint \"v=%d %f\\n\" [* z 017] [+ y 3.25e2]]]]\n";
+        }
+
+        return source;
+    }
+
+    /**
+     * @brief Generate a program with the given number of functions that compiles cleanly
+     */
+    inline auto generate_program(size_t functions) -> std::string {
+        std::string source;
+
+        for (size_t i = 0; i < functions; ++i) {
+            const std::string INDEX = std::to_string(i);
+            source += "[func f" + INDEX + " ((x !int64) (y !int64)) -> !int64\n";
+            source += "  [scope [var (z !int64) [+ x y]] [set z [* z x]]\n";
+            source += "    [while [> z y] [set z [- z y]]]\n";
+            source += "    [fprint \"f" + INDEX + "=%d\\n\" z] z]]\n";
+        }
+
+        return source;
+    }
+
+    // Number literals below take !int64 from the declaration or the other operand
+
+    /**
+     * @brief Generate scopes nested the given number of levels, each shadowing its parent's variable
+     */
+    inline auto generate_nested_scopes(size_t depth) -> std::string {
+        std::string source = "[var (v !int64) 1]\n";
+
+        for (size_t i = 0; i < depth; ++i) {
+            source += "[scope [var (v !int64) [+ v 1]] [var (w" + std::to_string(i) + " !int64) v]\n";
+        }
+        source += "[fprint \"v=%d\\n\" v]";
+        source.append(depth, ']');
+
+        return source + "\n";
+    }
+
+    /**
+     * @brief Generate a table of distinct string literals, every one bound to a variable
+     */
+    inline auto generate_string_table(size_t count) -> std::string {
+        std::string source;
+
+        for (size_t i = 0; i < count; ++i) {
+            const std::string INDEX = std::to_string(i);
+            source += "[var (s" + INDEX + " !str) \"string table entry " + INDEX + ": lorem ipsum dolor sit amet\\n\"]\n";
+        }
+        source += "[fprint \"%s\" s0]\n";
+
+        return source;
+    }
+
+    /**
+     * @brief Generate one array literal with the given number of elements
+     */
+    inline auto generate_big_array(size_t size) -> std::string {
+        std::string source = "[var (arr !array<!int8," + std::to_string(size) + ">) (array";
+
+        for (size_t i = 0; i < size; ++i) {
+            source += " " + std::to_string(i % 100);
+        }
+        source += ")]\n[fprint \"last=%d\\n\" (index arr " + std::to_string(size - 1) + ")]\n";
+
+        return source;
+    }
+
+    /**
+     * @brief Generate one expression of the given number of nested binary operations
+     */
+    inline auto generate_arithmetic_chain(size_t length) -> std::string {
+        static constexpr const char* OPERATORS[] = {"+", "-", "*"};
+        std::string source = "[var (x !int64) ";
+
+        for (size_t i = 0; i < length; ++i) {
+            source += "[" + std::string(OPERATORS[i % 3]) + " " + std::to_string(i % 7 + 2) + " ";
+        }
+        source += "3";
+        source.append(length, ']');
+        source += "]\n[fprint \"x=%d\\n\" x]\n";
+
+        return source;
+    }
+}    // namespace bench
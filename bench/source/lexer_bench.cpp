@@ -0,0 +1,46 @@
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "generators.hpp"
+#include "parser/MorningLangGrammar.h"
+
+namespace {
+    void tokenize(benchmark::State& state, const std::string& source) {
+        syntax::Tokenizer tokenizer;
+        size_t tokens = 0;
+
+        for (auto _ : state) {
+            tokenizer.initString(source);
+            tokens = 0;
+
+            while (tokenizer.getNextToken().type != syntax::TokenType::__EOF) {
+                ++tokens;
+            }
+
+            benchmark::DoNotOptimize(tokens);
+        }
+
+        state.counters["tokens"] = static_cast<double>(tokens);
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(source.size()));
+    }
+
+    void bm_tokenize(benchmark::State& state) {
+        const std::string SOURCE = bench::generate_source(static_cast<size_t>(state.range(0)));
+        tokenize(state, SOURCE);
+        state.SetComplexityN(static_cast<int64_t>(SOURCE.size()));
+    }
+
+    void bm_tokenize_workload(benchmark::State& state, bench::generator generate, size_t size) {
+        tokenize(state, generate(size));
+    }
+}    // namespace
+
+// Linear scaling up to 1 MB is checked by the O(N) complexity fit
+BENCHMARK(bm_tokenize)->RangeMultiplier(4)->Range(16 << 10, 1 << 20)->Complexity(benchmark::oN);
+
+BENCHMARK_CAPTURE(bm_tokenize_workload, nested_scopes, &bench::generate_nested_scopes, 1024);
+BENCHMARK_CAPTURE(bm_tokenize_workload, functions, &bench::generate_program, 10000);
+BENCHMARK_CAPTURE(bm_tokenize_workload, string_table, &bench::generate_string_table, 10000);
+BENCHMARK_CAPTURE(bm_tokenize_workload, big_array, &bench::generate_big_array, 10000);
+BENCHMARK_CAPTURE(bm_tokenize_workload, arithmetic_chain, &bench::generate_arithmetic_chain, 4096);
@@ -0,0 +1,39 @@
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "generators.hpp"
+#include "parser/MorningLangGrammar.h"
+
+namespace {
+    void parse(benchmark::State& state, const std::string& source) {
+        syntax::MorningLangGrammar parser;
+
+        for (auto _ : state) {
+            auto ast = parser.parse(source);
+            benchmark::DoNotOptimize(ast.list.size());
+        }
+
+        state.counters["ast_bytes"] = static_cast<double>(parser.arena.bytesReserved());
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(source.size()));
+    }
+
+    void bm_parse(benchmark::State& state) {
+        const std::string SOURCE = "[scope " + bench::generate_source(static_cast<size_t>(state.range(0))) + "]";
+        parse(state, SOURCE);
+        state.SetComplexityN(static_cast<int64_t>(SOURCE.size()));
+    }
+
+    // The compiler wraps programs in a scope the same way
+    void bm_parse_workload(benchmark::State& state, bench::generator generate, size_t size) {
+        parse(state, "[scope " + generate(size) + "]");
+    }
+}    // namespace
+
+BENCHMARK(bm_parse)->RangeMultiplier(4)->Range(16 << 10, 4 << 20)->Complexity(benchmark::oN);
+
+BENCHMARK_CAPTURE(bm_parse_workload, nested_scopes, &bench::generate_nested_scopes, 1024);
+BENCHMARK_CAPTURE(bm_parse_workload, functions, &bench::generate_program, 10000);
+BENCHMARK_CAPTURE(bm_parse_workload, string_table, &bench::generate_string_table, 10000);
+BENCHMARK_CAPTURE(bm_parse_workload, big_array, &bench::generate_big_array, 10000);
+BENCHMARK_CAPTURE(bm_parse_workload, arithmetic_chain, &bench::generate_arithmetic_chain, 4096);
@@ -8,6 +8,20 @@ if(PROJECT_IS_TOP_LEVEL)
   option(morninglang_DEVELOPER_MODE "Enable developer mode" OFF)
 endif()
 
+# ---- Log level ----
+
+# Log calls below this level are compiled out entirely, --log-level can only
+# raise the threshold at runtime. Empty keeps every level in Debug builds and
+# drops NOTE and DEBUG otherwise
+set(
+    morninglang_LOG_LEVEL ""
+    CACHE STRING "Lowest log level compiled in (NOTE, DEBUG, INFO, WARNING, ERROR)"
+)
+set_property(
+    CACHE morninglang_LOG_LEVEL
+    PROPERTY STRINGS "" NOTE DEBUG INFO WARNING ERROR
+)
+
 # ---- Warning guard ----
 
 # target_include_directories with the SYSTEM modifier will request the compiler
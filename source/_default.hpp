@@ -2,14 +2,6 @@
 
 // #define __DEBUG
 
-#define START_INDENT_SYMBOL "├─"
-#define INDENT_SYMBOL "──"
-
-enum
-{
-    INDENT_LENGTH = 6
-};
-
 #define RED_COLOR "\033[1;31m"
 #define GREEN_COLOR "\033[1;32m"
 #define YELLOW_COLOR "\033[1;33m"
@@ -0,0 +1,210 @@
+#include "cache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/SHA256.h>
+#include <llvm/TargetParser/Host.h>
+
+#include "logger.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+    const char* const STATS_FILE = "stats";
+    const char* const ENTRY_SUFFIX = ".entry";
+
+    /**
+     * @brief Resolve cache directory from environment
+     */
+    auto default_directory() -> fs::path {
+        if (const char* dir = std::getenv("MORNING_CACHE_DIR")) {
+            return dir;
+        }
+        if (const char* xdg = std::getenv("XDG_CACHE_HOME")) {
+            return fs::path(xdg) / "morninglang";
+        }
+        if (const char* home = std::getenv("HOME")) {
+            return fs::path(home) / ".cache" / "morninglang";
+        }
+        return {};
+    }
+
+    auto is_entry(const fs::directory_entry& entry) -> bool {
+        return entry.is_regular_file() && entry.path().extension() == ENTRY_SUFFIX;
+    }
+}    // namespace
+
+compilation_cache::compilation_cache(uint64_t size_limit)
+    : m_SIZE_LIMIT(size_limit) {
+    fs::path dir = default_directory();
+    if (dir.empty()) {
+        return;
+    }
+
+    std::error_code err_code;
+    fs::create_directories(dir, err_code);
+    if (err_code) {
+        LOG_WARN("Cannot create cache directory \"%s\": %s", dir.c_str(), err_code.message().c_str());
+        return;
+    }
+
+    m_DIRECTORY = dir;
+}
+
+auto compilation_cache::make_key(const std::string& source,
+                                 const std::string& version,
+                                 const std::string& opt_level,
+                                 const std::string& target,
+                                 const std::string& artifact) -> std::string {
+    llvm::SHA256 hasher;
+
+    // Zero separators keep ("ab", "c") and ("a", "bc") apart
+    for (const auto* part : {&version, &opt_level, &target, &artifact, &source}) {
+        hasher.update(*part);
+        hasher.update(llvm::ArrayRef<uint8_t>(uint8_t {0}));
+    }
+
+    return llvm::toHex(hasher.final(), /* LowerCase */ true);
+}
+
+auto compilation_cache::host_target() -> std::string {
+    return llvm::sys::getDefaultTargetTriple() + "/" + llvm::sys::getHostCPUName().str();
+}
+
+auto compilation_cache::entry_path(const std::string& key) const -> fs::path {
+    return m_DIRECTORY / (key + ENTRY_SUFFIX);
+}
+
+auto compilation_cache::restore(const std::string& key, const fs::path& destination) -> bool {
+    if (!is_available()) {
+        return false;
+    }
+
+    std::error_code err_code;
+    const fs::path ENTRY = entry_path(key);
+
+    bool hit = fs::exists(ENTRY, err_code)
+        && fs::copy_file(ENTRY, destination, fs::copy_options::overwrite_existing, err_code);
+    count_lookup(hit);
+
+    if (hit) {
+        // Mark as recently used
+        fs::last_write_time(ENTRY, fs::file_time_type::clock::now(), err_code);
+        fs::permissions(destination, fs::status(ENTRY, err_code).permissions(), err_code);
+    }
+
+    return hit;
+}
+
+void compilation_cache::store(const std::string& key, const fs::path& artifact) {
+    if (!is_available()) {
+        return;
+    }
+
+    std::error_code err_code;
+    const fs::path ENTRY = entry_path(key);
+    const fs::path TEMP =
+        ENTRY.string() + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+
+    // Copy then rename, so concurrent builds never see partial entries
+    if (!fs::copy_file(artifact, TEMP, fs::copy_options::overwrite_existing, err_code)) {
+        LOG_WARN("Cannot add \"%s\" to cache: %s", artifact.c_str(), err_code.message().c_str());
+        return;
+    }
+
+    fs::rename(TEMP, ENTRY, err_code);
+    if (err_code) {
+        fs::remove(TEMP, err_code);
+        return;
+    }
+
+    evict();
+}
+
+void compilation_cache::evict() {
+    std::error_code err_code;
+    std::vector<std::pair<fs::file_time_type, fs::directory_entry>> entries;
+    uint64_t total_size = 0;
+
+    for (const auto& entry : fs::directory_iterator(m_DIRECTORY, err_code)) {
+        if (is_entry(entry)) {
+            entries.emplace_back(entry.last_write_time(err_code), entry);
+            total_size += entry.file_size(err_code);
+        }
+    }
+
+    if (total_size <= m_SIZE_LIMIT) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const auto& left, const auto& right) {
+        return left.first < right.first;
+    });
+
+    for (const auto& entry : entries) {
+        if (total_size <= m_SIZE_LIMIT) {
+            break;
+        }
+
+        uint64_t size = entry.second.file_size(err_code);
+        if (fs::remove(entry.second.path(), err_code)) {
+            total_size -= size;
+            LOG_DEBUG("Evicted cache entry: %s", entry.second.path().filename().c_str());
+        }
+    }
+}
+
+void compilation_cache::count_lookup(bool hit) {
+    const fs::path STATS = m_DIRECTORY / STATS_FILE;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    {
+        std::ifstream input(STATS);
+        input >> hits >> misses;
+    }
+
+    (hit ? hits : misses)++;
+
+    // Readers never see a torn file, but concurrent builds may drop each other's counts
+    const fs::path TEMP =
+        STATS.string() + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    {
+        std::ofstream output(TEMP, std::ios::trunc);
+        output << hits << " " << misses << "\n";
+    }
+
+    std::error_code err_code;
+    fs::rename(TEMP, STATS, err_code);
+    if (err_code) {
+        fs::remove(TEMP, err_code);
+    }
+}
+
+auto compilation_cache::get_stats() const -> stats {
+    stats result {0, 0, m_SIZE_LIMIT, 0, 0};
+    if (!is_available()) {
+        return result;
+    }
+
+    std::error_code err_code;
+    for (const auto& entry : fs::directory_iterator(m_DIRECTORY, err_code)) {
+        if (is_entry(entry)) {
+            result.entries++;
+            result.total_size += entry.file_size(err_code);
+        }
+    }
+
+    std::ifstream input(m_DIRECTORY / STATS_FILE);
+    input >> result.hits >> result.misses;
+
+    return result;
+}
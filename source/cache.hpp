@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+/**
+ * @brief Content-addressed on-disk cache of compiled objects and binaries
+ *
+ * Entries are keyed by a SHA-256 of everything that affects the output
+ * (source text, compiler version, optimization level, target). Hits
+ * refresh the entry's modification time, and the least recently used
+ * entries are evicted once the cache grows over its size limit.
+ *
+ * Location: $MORNING_CACHE_DIR, $XDG_CACHE_HOME/morninglang or
+ * ~/.cache/morninglang.
+ */
+class compilation_cache {
+public:
+    static const constexpr uint64_t DEFAULT_SIZE_LIMIT = 512ULL * 1024 * 1024;
+
+    /**
+     * @brief Cache usage summary
+     *
+     * Hits and misses are approximate: lookups of concurrent builds may
+     * overwrite each other's counts.
+     */
+    struct stats {
+        uint64_t entries;    ///< Number of cached artifacts
+        uint64_t total_size;    ///< Size of all artifacts in bytes
+        uint64_t size_limit;    ///< Size limit in bytes
+        uint64_t hits;    ///< Lookups served from the cache
+        uint64_t misses;    ///< Lookups that required a compilation
+    };
+
+    /**
+     * @brief Open cache directory, creating it if needed
+     *
+     * @param size_limit Size limit in bytes
+     */
+    explicit compilation_cache(uint64_t size_limit = DEFAULT_SIZE_LIMIT);
+
+    /**
+     * @brief Check if cache directory is usable
+     */
+    auto is_available() const -> bool { return !m_DIRECTORY.empty(); }
+
+    /**
+     * @brief Build cache key for compilation inputs
+     *
+     * @param source Program source text
+     * @param version Compiler version
+     * @param opt_level Optimization level name
+     * @param target Target triple and CPU
+     * @param artifact Kind of output ("object", "binary")
+     * @return std::string Hex SHA-256 digest
+     */
+    static auto make_key(const std::string& source,
+                         const std::string& version,
+                         const std::string& opt_level,
+                         const std::string& target,
+                         const std::string& artifact) -> std::string;
+
+    /**
+     * @brief Get host target description (triple and CPU) used for keys
+     */
+    static auto host_target() -> std::string;
+
+    /**
+     * @brief Copy cached artifact to destination
+     *
+     * @param key Cache key
+     * @param destination Output file
+     * @return true on cache hit
+     */
+    auto restore(const std::string& key, const std::filesystem::path& destination) -> bool;
+
+    /**
+     * @brief Add artifact to cache and evict old entries over the limit
+     *
+     * @param key Cache key
+     * @param artifact Compiled file to cache
+     */
+    void store(const std::string& key, const std::filesystem::path& artifact);
+
+    /**
+     * @brief Collect cache usage summary
+     */
+    auto get_stats() const -> stats;
+
+    /**
+     * @brief Get cache directory
+     */
+    auto get_directory() const -> const std::filesystem::path& { return m_DIRECTORY; }
+
+private:
+    std::filesystem::path m_DIRECTORY;
+    uint64_t m_SIZE_LIMIT;
+
+    void evict();
+    void count_lookup(bool hit);
+    auto entry_path(const std::string& key) const -> std::filesystem::path;
+};
@@ -24,21 +24,33 @@ auto ArithmeticCodegen::get_common_type(Value* left, Value* right) -> Type* {
     if (left_type->isDoubleTy() || right_type->isDoubleTy()) {
         return Type::getDoubleTy(left_type->getContext());
     }
+    if (left_type->isIntegerTy() && right_type->isIntegerTy()
+        && right_type->getIntegerBitWidth() > left_type->getIntegerBitWidth())
+    {
+        return right_type;
+    }
     return left_type;
 }
 
+auto ArithmeticCodegen::get_operation(const std::string& op) -> std::string {
+    if (auto it = m_OP_MAPPING.find(op); it != m_OP_MAPPING.end()) {
+        return it->second;
+    }
+    return op;
+}
+
 auto ArithmeticCodegen::generate_binary_op(const std::string& op,
                                            Value* left,
                                            Value* right,
-                                           IRBuilder<>& builder) -> Value* {
-    std::string operation = op;
-    if (auto it = m_OP_MAPPING.find(op); it != m_OP_MAPPING.end()) {
-        operation = it->second;
-    }
+                                           IRBuilder<>& builder,
+                                           bool left_unsigned,
+                                           bool right_unsigned) -> Value* {
+    auto operation = get_operation(op);
+    const bool IS_UNSIGNED = left_unsigned || right_unsigned;
 
     Type* common_type = get_common_type(left, right);
-    left = implicit_cast(left, common_type, builder);
-    right = implicit_cast(right, common_type, builder);
+    left = implicit_cast(left, common_type, builder, left_unsigned);
+    right = implicit_cast(right, common_type, builder, right_unsigned);
 
     if (common_type->isDoubleTy()) {
         if (operation == "+") {
@@ -82,19 +94,24 @@ auto ArithmeticCodegen::generate_binary_op(const std::string& op,
             return builder.CreateMul(left, right, "mul_tmp");
         }
         if (operation == "/") {
-            return builder.CreateSDiv(left, right, "div_tmp");
+            return IS_UNSIGNED ? builder.CreateUDiv(left, right, "div_tmp")
+                               : builder.CreateSDiv(left, right, "div_tmp");
         }
         if (operation == ">") {
-            return builder.CreateICmpSGT(left, right, "icmp_tmp");
+            return IS_UNSIGNED ? builder.CreateICmpUGT(left, right, "icmp_tmp")
+                               : builder.CreateICmpSGT(left, right, "icmp_tmp");
         }
         if (operation == "<") {
-            return builder.CreateICmpSLT(left, right, "icmp_tmp");
+            return IS_UNSIGNED ? builder.CreateICmpULT(left, right, "icmp_tmp")
+                               : builder.CreateICmpSLT(left, right, "icmp_tmp");
         }
         if (operation == ">=") {
-            return builder.CreateICmpSGE(left, right, "icmp_tmp");
+            return IS_UNSIGNED ? builder.CreateICmpUGE(left, right, "icmp_tmp")
+                               : builder.CreateICmpSGE(left, right, "icmp_tmp");
         }
         if (operation == "<=") {
-            return builder.CreateICmpSLE(left, right, "icmp_tmp");
+            return IS_UNSIGNED ? builder.CreateICmpULE(left, right, "icmp_tmp")
+                               : builder.CreateICmpSLE(left, right, "icmp_tmp");
         }
         if (operation == "==") {
             return builder.CreateICmpEQ(left, right, "icmp_tmp");
@@ -106,8 +123,8 @@ auto ArithmeticCodegen::generate_binary_op(const std::string& op,
 
     LOG_ERROR("Unsupported operation '%s' for types %s and %s",
                  operation.c_str(),
-                 type_to_string(left->getType()).c_str(),
-                 type_to_string(right->getType()).c_str());
+                 type_to_string(left->getType(), left_unsigned).c_str(),
+                 type_to_string(right->getType(), right_unsigned).c_str());
 
     return nullptr;
 }
@@ -11,22 +11,37 @@ class ArithmeticCodegen {
     /**
      * @brief Generate binary operation
      *
+     * Each operand is widened by its own sign. The operation is unsigned,
+     * i.e. uses udiv and unsigned comparisons, if either operand is.
+     *
      * @param op operand
      * @param left left side
      * @param right right side
      * @param builder IR builder
+     * @param left_unsigned whether left side is unsigned
+     * @param right_unsigned whether right side is unsigned
      * @return llvm::Value*
      **/
     static auto generate_binary_op(const std::string& op,
                                    llvm::Value* left,
                                    llvm::Value* right,
-                                   llvm::IRBuilder<>& builder) -> llvm::Value*;
+                                   llvm::IRBuilder<>& builder,
+                                   bool left_unsigned = false,
+                                   bool right_unsigned = false) -> llvm::Value*;
+
+    /**
+     * @brief Get operation a tag stands for, e.g. "+" for __PLUS_OPERAND__
+     *
+     * @param op operand as written
+     * @return std::string operation, op itself when it is not an alias
+     **/
+    static auto get_operation(const std::string& op) -> std::string;
 
   private:
     static const std::unordered_map<std::string, std::string> m_OP_MAPPING;
 
     /**
-     * @brief Get the common type object
+     * @brief Get the common type object, the wider one for integers
      *
      * @param left left side
      * @param right right side
@@ -0,0 +1,136 @@
+#include "../morningllvm.hpp"
+
+#include <vector>
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+
+#include "../logger.hpp"
+#include "../utils/cast.hpp"
+
+auto MorningLanguageLLVM::generate_array(const Exp& exp, llvm::Type* context_type, bool unsigned_context)
+    -> llvm::Value* {
+    LOG_DEBUG("Process array creation");
+
+    // Handle nested arrays
+    bool is_nested_array = false;
+    llvm::Type* element_type = nullptr;
+    std::vector<llvm::Constant*> elements;
+
+    // Elements of a declared array take its element type, others the type of the first element
+    auto* context_element_type =
+        context_type != nullptr && context_type->isArrayTy() ? context_type->getArrayElementType() : nullptr;
+
+    for (size_t i = 1; i < exp.list.size(); i++) {
+        auto* element_context = context_element_type != nullptr ? context_element_type : element_type;
+        auto* element_val = generate_expression(exp.list[i], element_context, unsigned_context);
+
+        if (auto* constant = llvm::dyn_cast<llvm::Constant>(element_val)) {
+            // First element determines type
+            if (element_type == nullptr) {
+                element_type = element_val->getType();
+                is_nested_array = element_type->isArrayTy();
+            }
+
+            // Validate type consistency
+            if (element_val->getType() != element_type) {
+                LOG_CRITICAL("Array element type mismatch at index %zu", i - 1);
+            }
+
+            elements.push_back(constant);
+        } else {
+            LOG_CRITICAL("Array element must be constant expression");
+        }
+    }
+
+    if (elements.empty()) {
+        LOG_CRITICAL("Array cannot be empty");
+    }
+
+    // For nested arrays, use the first element's type
+    if (is_nested_array) {
+        return llvm::ConstantArray::get(llvm::ArrayType::get(element_type, elements.size()),
+                                        elements);
+    }
+
+    // For simple arrays
+    return llvm::ConstantArray::get(llvm::ArrayType::get(element_type, elements.size()),
+                                    elements);
+}
+
+auto MorningLanguageLLVM::generate_index(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process array indexing");
+
+    if (exp.list.size() != 3) {
+        LOG_CRITICAL("index operation requires 2 arguments");
+    }
+
+    // First argument must be symbol (array name)
+    if (exp.list[1].type != ExpType::SYMBOL) {
+        LOG_CRITICAL("index: first argument must be array name");
+    }
+
+    const std::string& array_name = exp.list[1].string;
+    auto array_type_it = m_ARRAY_TYPES.find(array_name);
+    if (array_type_it == m_ARRAY_TYPES.end()) {
+        LOG_CRITICAL("Array '%s' not found", array_name.c_str());
+    }
+
+    llvm::ArrayType* array_type = array_type_it->second;
+    llvm::Value* array_ptr = m_ENV.lookup_by_name(array_name);
+    llvm::Value* index_val = generate_expression(exp.list[2]);
+
+    // Validate index type
+    if (!index_val->getType()->isIntegerTy()) {
+        LOG_CRITICAL("Array index must be integer type");
+    }
+
+    // Create GEP (getelementptr) for array element
+    llvm::Value* zero = m_IR_BUILDER->getInt64(0);
+    std::vector<llvm::Value*> indices = {zero, index_val};
+    llvm::Value* element_ptr =
+        m_IR_BUILDER->CreateInBoundsGEP(array_type, array_ptr, indices, "elementptr");
+
+    return m_IR_BUILDER->CreateLoad(array_type->getElementType(), element_ptr, "loadarray");
+}
+
+auto MorningLanguageLLVM::generate_index_store(const Exp& index_exp, const Exp& value_exp) -> llvm::Value* {
+    if (index_exp.list.size() != 3) {
+        LOG_CRITICAL("index in set requires 2 arguments");
+    }
+
+    // First argument must be symbol (array name)
+    if (index_exp.list[1].type != ExpType::SYMBOL) {
+        LOG_CRITICAL("index: first argument must be array name");
+    }
+
+    const std::string& array_name = index_exp.list[1].string;
+    auto array_type_it = m_ARRAY_TYPES.find(array_name);
+    if (array_type_it == m_ARRAY_TYPES.end()) {
+        LOG_CRITICAL("Array '%s' not found", array_name.c_str());
+    }
+
+    llvm::ArrayType* array_type = array_type_it->second;
+    llvm::Value* array_ptr = m_ENV.lookup_by_name(array_name);
+    llvm::Value* index_val = generate_expression(index_exp.list[2]);
+    const bool IS_UNSIGNED = m_ENV.is_unsigned(index_exp.list[1].string);
+    llvm::Value* value = generate_expression(value_exp, array_type->getElementType(), IS_UNSIGNED);
+
+    // Validate index type
+    if (!index_val->getType()->isIntegerTy()) {
+        LOG_CRITICAL("Array index must be integer type");
+    }
+
+    // Create GEP (getelementptr) for array element
+    llvm::Value* zero = m_IR_BUILDER->getInt64(0);
+    std::vector<llvm::Value*> indices = {zero, index_val};
+    llvm::Value* element_ptr =
+        m_IR_BUILDER->CreateInBoundsGEP(array_type, array_ptr, indices, "setptr");
+
+    // Cast value to element type if needed
+    value = implicit_cast(
+        value, array_type->getElementType(), *m_IR_BUILDER, is_unsigned_expression(value_exp, IS_UNSIGNED));
+
+    m_IR_BUILDER->CreateStore(value, element_ptr);
+    return value;
+}
@@ -0,0 +1,47 @@
+#include "../morningllvm.hpp"
+
+#include <vector>
+
+#include <llvm/IR/Function.h>
+
+#include "../logger.hpp"
+#include "../utils/cast.hpp"
+
+auto MorningLanguageLLVM::generate_function(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process function: %s", exp.list[1].string.c_str());
+
+    if (exp.list.size() < 4) {
+        LOG_CRITICAL("Function definition requires at least 3 parts (name, params, body)");
+        return m_IR_BUILDER->getInt64(0);
+    }
+
+    auto* fn = compile_function(exp, /* name */ exp.list[1].string);
+    m_ENV.define(exp.list[1].string, fn);
+    if (returns_unsigned(exp)) {
+        m_ENV.mark_unsigned(exp.list[1].string);
+    }
+    return fn;
+}
+
+auto MorningLanguageLLVM::generate_call(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process function call: %s", exp.list[0].string.c_str());
+
+    auto* callable = generate_expression(exp.list[0]);
+    auto* fn = (llvm::Function*)callable;
+    auto* fn_type = fn->getFunctionType();
+
+    std::vector<llvm::Value*> args {};
+
+    // Arguments take the parameter types, varargs keep their own
+    for (size_t i = 1; i < exp.list.size(); i++) {
+        const auto PARAM = static_cast<unsigned>(i - 1);
+        auto* param_type = PARAM < fn_type->getNumParams() ? fn_type->getParamType(PARAM) : nullptr;
+        auto* arg = generate_expression(exp.list[i], param_type);
+        if (param_type != nullptr) {
+            arg = implicit_cast(arg, param_type, *m_IR_BUILDER, is_unsigned_expression(exp.list[i]));
+        }
+        args.push_back(arg);
+    }
+
+    return m_IR_BUILDER->CreateCall(fn, args);
+}
@@ -0,0 +1,378 @@
+#include "../morningllvm.hpp"
+
+#include <vector>
+
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+
+#include "../logger.hpp"
+
+auto MorningLanguageLLVM::generate_if(const Exp& exp, llvm::Type* context_type, bool unsigned_context)
+    -> llvm::Value* {
+    LOG_DEBUG("Process if-elif-else: %s", exp.list[1].string.c_str());
+
+    if (exp.list.size() < 4) {
+        LOG_CRITICAL("if requires at least 4 arguments: condition, block, else, else_block",
+                     exp.string.c_str());
+    }
+
+    llvm::BasicBlock* merge_block = nullptr;
+    std::vector<llvm::Value*> branch_values;
+    std::vector<llvm::BasicBlock*> branch_blocks;
+
+    // Set once a branch runs whenever it is reached; later branches are never generated
+    llvm::Value* taken_value = nullptr;
+
+    // Literals in later branches take the type of the first one
+    auto* branch_type = context_type;
+    auto generate_block = [&](const Exp& block) {
+        auto* value = generate_expression(block, branch_type, unsigned_context);
+        if (branch_type == nullptr) {
+            branch_type = value->getType();
+        }
+        return value;
+    };
+
+    auto end_branch = [&](llvm::Value* value) {
+        if (merge_block == nullptr) {
+            merge_block = create_basic_block("if.end");
+        }
+        branch_values.push_back(value);
+        branch_blocks.push_back(m_IR_BUILDER->GetInsertBlock());
+        m_IR_BUILDER->CreateBr(merge_block);
+    };
+
+    auto take_branch = [&](const Exp& block) {
+        taken_value = generate_block(block);
+        if (!branch_values.empty()) {
+            end_branch(taken_value);
+        }
+    };
+
+    // Branches with a constant condition are dropped or taken without a test
+    auto generate_branch = [&](const Exp& condition, const Exp& block, const std::string& label) {
+        const auto TAKEN = fold_condition(condition);
+        if (TAKEN.has_value()) {
+            if (*TAKEN) {
+                take_branch(block);
+            }
+            return;
+        }
+
+        auto* cond = generate_expression(condition);
+        auto* then_block = create_basic_block(label + ".then", m_ACTIVE_FUNCTION);
+        auto* next_block = create_basic_block(label + ".next", m_ACTIVE_FUNCTION);
+
+        m_IR_BUILDER->CreateCondBr(cond, then_block, next_block);
+
+        m_IR_BUILDER->SetInsertPoint(then_block);
+        end_branch(generate_block(block));
+
+        m_IR_BUILDER->SetInsertPoint(next_block);
+    };
+
+    size_t i = 1;
+
+    while (i < exp.list.size() && taken_value == nullptr) {
+        auto form = exp.list[i].string.form();
+        if (form == SpecialForm::ELSE || form == SpecialForm::ELIF) {
+            break;
+        }
+
+        if (i + 1 >= exp.list.size()) {
+            LOG_CRITICAL("if: missing block for condition", exp.string.c_str());
+        }
+
+        generate_branch(exp.list[i], exp.list[i + 1], "if");
+        i += 2;
+    }
+
+    while (i < exp.list.size() && taken_value == nullptr) {
+        if (exp.list[i].string.form() == SpecialForm::ELIF) {
+            if (i + 2 >= exp.list.size()) {
+                LOG_CRITICAL("elif requires condition and block", exp.string.c_str());
+            }
+
+            generate_branch(exp.list[i + 1], exp.list[i + 2], "elif");
+            i += 3;
+        } else if (exp.list[i].string.form() == SpecialForm::ELSE) {
+            if (i + 1 >= exp.list.size()) {
+                LOG_CRITICAL("else requires block", exp.string.c_str());
+            }
+
+            take_branch(exp.list[i + 1]);
+            i += 2;
+            break;
+        } else {
+            LOG_CRITICAL("expected elif or else after if conditions", exp.string.c_str());
+        }
+    }
+
+    // Every tested condition was constant, the taken branch is all that is left
+    if (merge_block == nullptr) {
+        return taken_value != nullptr ? taken_value : m_IR_BUILDER->getInt64(0);
+    }
+
+    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), merge_block);
+    m_IR_BUILDER->SetInsertPoint(merge_block);
+
+    auto* first_type = branch_values[0]->getType();
+    for (auto* val : branch_values) {
+        if (val->getType() != first_type) {
+            LOG_CRITICAL("if: all branches must return same type", exp.string.c_str());
+        }
+    }
+
+    auto* phi = m_IR_BUILDER->CreatePHI(first_type, branch_values.size(), "if_result");
+    for (size_t idx = 0; idx < branch_values.size(); idx++) {
+        phi->addIncoming(branch_values[idx], branch_blocks[idx]);
+    }
+    return phi;
+}
+
+auto MorningLanguageLLVM::generate_check(const Exp& exp, llvm::Type* context_type, bool unsigned_context)
+    -> llvm::Value* {
+    LOG_DEBUG("Process check (if-then-else)");
+
+    // Without else a false check gives null of the then-branch type, so only a branch
+    // that exists is taken without a test
+    const auto TAKEN = fold_condition(exp.list[1]);
+    if (TAKEN == true) {
+        return generate_expression(exp.list[2], context_type, unsigned_context);
+    }
+    if (TAKEN == false && exp.list.size() > 3) {
+        return generate_expression(exp.list[3], context_type, unsigned_context);
+    }
+
+    auto* condition = generate_expression(exp.list[1]);
+
+    auto* then_block = create_basic_block("then", m_ACTIVE_FUNCTION);
+    auto* else_block = create_basic_block("else");
+    auto* if_end_block = create_basic_block("ifend");
+
+    m_IR_BUILDER->CreateCondBr(condition, then_block, else_block);
+
+    // Then branch
+    m_IR_BUILDER->SetInsertPoint(then_block);
+    auto* then_res = generate_expression(exp.list[2], context_type, unsigned_context);
+
+    if (m_IR_BUILDER->GetInsertBlock()->getTerminator() == nullptr) {
+        m_IR_BUILDER->CreateBr(if_end_block);
+    }
+    then_block = m_IR_BUILDER->GetInsertBlock();
+
+    // Else branch
+    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), else_block);
+    m_IR_BUILDER->SetInsertPoint(else_block);
+    auto* else_res = exp.list.size() > 3
+                       ? generate_expression(exp.list[3], then_res->getType(), unsigned_context)
+                       : llvm::Constant::getNullValue(then_res->getType());
+    if (m_IR_BUILDER->GetInsertBlock()->getTerminator() == nullptr) {
+        m_IR_BUILDER->CreateBr(if_end_block);
+    }
+    else_block = m_IR_BUILDER->GetInsertBlock();
+
+    // If-end block
+    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), if_end_block);
+    m_IR_BUILDER->SetInsertPoint(if_end_block);
+
+    auto* phi = m_IR_BUILDER->CreatePHI(then_res->getType(), 2, "__tmpcheck__");
+    phi->addIncoming(then_res, then_block);
+    phi->addIncoming(else_res, else_block);
+    return phi;
+}
+
+auto MorningLanguageLLVM::generate_loop(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process loop");
+    auto* loop_body = create_basic_block("loop.body", m_ACTIVE_FUNCTION);
+    auto* loop_exit = create_basic_block("loop.exit");
+
+    m_IR_BUILDER->CreateBr(loop_body);
+    m_SSA.open_block(loop_body);    // Back edge and continues come later
+    m_IR_BUILDER->SetInsertPoint(loop_body);
+
+    LoopBlocks const LOOP_BLOCKS = {loop_exit, loop_body};
+    m_LOOP_STACK.push_back(LOOP_BLOCKS);
+
+    for (size_t i = 1; i < exp.list.size(); i++) {
+        generate_expression(exp.list[i]);
+    }
+
+    if (m_IR_BUILDER->GetInsertBlock()->getTerminator() == nullptr) {
+        m_IR_BUILDER->CreateBr(loop_body);
+    }
+    m_SSA.seal_block(loop_body);
+
+    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), loop_exit);
+    m_IR_BUILDER->SetInsertPoint(loop_exit);
+    m_LOOP_STACK.pop_back();
+
+    return m_IR_BUILDER->getInt64(0);
+}
+
+auto MorningLanguageLLVM::generate_while(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process while loop");
+
+    // A loop whose condition never holds is not generated at all
+    const auto ALWAYS = fold_condition(exp.list[1]);
+    if (ALWAYS == false) {
+        return m_IR_BUILDER->getInt64(0);
+    }
+
+    auto* break_blog = create_basic_block("break");
+    auto* continue_block = create_basic_block("continue");
+    m_LOOP_STACK.push_back({break_blog, continue_block});
+
+    auto* condition_block = create_basic_block("cond", m_ACTIVE_FUNCTION);
+    m_IR_BUILDER->CreateBr(condition_block);
+    m_SSA.open_block(condition_block);    // Entered again from the continue block
+
+    auto* body_block = create_basic_block("body");
+
+    m_IR_BUILDER->SetInsertPoint(condition_block);
+    if (ALWAYS == true) {
+        m_IR_BUILDER->CreateBr(body_block);
+    } else {
+        auto* condition = generate_expression(exp.list[1]);
+        m_IR_BUILDER->CreateCondBr(condition, body_block, break_blog);
+    }
+
+    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), body_block);
+    m_IR_BUILDER->SetInsertPoint(body_block);
+    generate_expression(exp.list[2]);
+    if (m_IR_BUILDER->GetInsertBlock()->getTerminator() == nullptr) {
+        m_IR_BUILDER->CreateBr(continue_block);
+    }
+
+    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), continue_block);
+    m_IR_BUILDER->SetInsertPoint(continue_block);
+    m_IR_BUILDER->CreateBr(condition_block);
+    m_SSA.seal_block(condition_block);
+
+    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), break_blog);
+    m_IR_BUILDER->SetInsertPoint(break_blog);
+    m_LOOP_STACK.pop_back();
+
+    return m_IR_BUILDER->getInt64(0);
+}
+
+auto MorningLanguageLLVM::generate_for(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process for loop");
+
+    const auto& init = exp.list[1];
+    const auto& condition = exp.list[2];
+    const auto& step = exp.list[3];
+    const auto& body = exp.list[4];
+
+    // `for` scope
+    m_ENV.push_scope();
+
+    // Generate init expression
+    generate_expression(init);
+
+    // Only the init of a loop whose condition never holds is kept
+    const auto ALWAYS = fold_condition(condition);
+    if (ALWAYS == false) {
+        m_ENV.pop_scope();
+        return m_IR_BUILDER->getInt64(0);
+    }
+
+    // Create blocks
+    auto* cond_block = create_basic_block("for.cond", m_ACTIVE_FUNCTION);
+    auto* body_block = create_basic_block("for.body");
+    auto* step_block = create_basic_block("for.step");
+    auto* break_blog = create_basic_block("for.break");
+
+    // Conditions
+    m_IR_BUILDER->CreateBr(cond_block);
+    m_SSA.open_block(cond_block);    // Entered again from the step block
+
+    // Conditions block
+    m_IR_BUILDER->SetInsertPoint(cond_block);
+    if (ALWAYS == true) {
+        m_IR_BUILDER->CreateBr(body_block);
+    } else {
+        auto* cond_value = generate_expression(condition);
+        m_IR_BUILDER->CreateCondBr(cond_value, body_block, break_blog);
+    }
+
+    // Body block
+    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), body_block);
+    m_IR_BUILDER->SetInsertPoint(body_block);
+    m_LOOP_STACK.push_back({break_blog, step_block});
+    generate_expression(body);
+    m_LOOP_STACK.pop_back();
+
+    // Step
+    if (m_IR_BUILDER->GetInsertBlock()->getTerminator() == nullptr) {
+        m_IR_BUILDER->CreateBr(step_block);
+    }
+
+    // Step block
+    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), step_block);
+    m_IR_BUILDER->SetInsertPoint(step_block);
+    generate_expression(step);
+    m_IR_BUILDER->CreateBr(cond_block);
+    m_SSA.seal_block(cond_block);
+
+    // Break blog
+    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), break_blog);
+    m_IR_BUILDER->SetInsertPoint(break_blog);
+    m_ENV.pop_scope();
+
+    return m_IR_BUILDER->getInt64(0);
+}
+
+auto MorningLanguageLLVM::generate_break(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process break");
+
+    if (m_LOOP_STACK.empty()) {
+        LOG_CRITICAL("break outside of loop", exp.string.c_str());
+    }
+
+    auto& loop = m_LOOP_STACK.back();
+    m_IR_BUILDER->CreateBr(loop.break_blog);
+
+    auto* after = create_basic_block("after_break");
+    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), after);
+    m_IR_BUILDER->SetInsertPoint(after);
+
+    return m_IR_BUILDER->getInt64(0);
+}
+
+auto MorningLanguageLLVM::generate_continue(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process continue");
+
+    if (m_LOOP_STACK.empty()) {
+        LOG_CRITICAL("continue outside of loop", exp.string.c_str());
+    }
+    auto& loop = m_LOOP_STACK.back();
+    m_IR_BUILDER->CreateBr(loop.continue_block);
+
+    auto* after = create_basic_block("after_continue");
+    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), after);
+    m_IR_BUILDER->SetInsertPoint(after);
+
+    return m_IR_BUILDER->getInt64(0);
+}
+
+auto MorningLanguageLLVM::generate_scope(const Exp& exp, llvm::Type* context_type, bool unsigned_context)
+    -> llvm::Value* {
+    LOG_DEBUG("Process scope");
+
+    llvm::Value* block_res = nullptr;
+
+    m_ENV.push_scope();
+
+    // Only the last form gives the value of the scope
+    for (auto i = 1; i < exp.list.size(); i++) {
+        const bool IS_LAST = i + 1 == exp.list.size();
+        block_res =
+            generate_expression(exp.list[i], IS_LAST ? context_type : nullptr, IS_LAST && unsigned_context);
+    }
+
+    m_ENV.pop_scope();
+
+    return block_res;
+}
@@ -0,0 +1,61 @@
+#include "../morningllvm.hpp"
+
+#include <optional>
+
+#include <llvm/IR/Constants.h>
+
+auto MorningLanguageLLVM::is_foldable(const Exp& exp) const -> bool {
+    switch (exp.type) {
+        case ExpType::NUMBER:
+        case ExpType::FRACTIONAL:
+            return true;
+        case ExpType::STRING:
+            return false;
+        case ExpType::SYMBOL: {
+            const auto FORM = exp.string.form();
+            return FORM == SpecialForm::TRUE_LITERAL || FORM == SpecialForm::FALSE_LITERAL
+                || m_ENV.lookup_folded(exp.string) != nullptr;
+        }
+        case ExpType::LIST:
+            break;
+    }
+
+    if (exp.list.empty() || exp.list[0].type != ExpType::SYMBOL) {
+        return false;
+    }
+
+    // Malformed forms are left to their generators, which report them
+    switch (exp.list[0].string.form()) {
+        case SpecialForm::BINARY_OP:
+        case SpecialForm::BIT_AND:
+        case SpecialForm::BIT_OR:
+        case SpecialForm::BIT_XOR:
+        case SpecialForm::BIT_SHL:
+        case SpecialForm::BIT_SHR:
+            return exp.list.size() == 3 && is_foldable(exp.list[1]) && is_foldable(exp.list[2]);
+        case SpecialForm::BIT_NOT:
+            return exp.list.size() == 2 && is_foldable(exp.list[1]);
+        case SpecialForm::SIZEOF:
+            return exp.list.size() == 2 && exp.list[1].type == ExpType::SYMBOL;
+        default:
+            return false;
+    }
+}
+
+auto MorningLanguageLLVM::fold_constant(const Exp& exp) -> llvm::Constant* {
+    if (!is_foldable(exp)) {
+        return nullptr;
+    }
+
+    // The builder folds instructions on constants, so the usual generators compute the value
+    return llvm::dyn_cast_or_null<llvm::Constant>(generate_expression(exp));
+}
+
+auto MorningLanguageLLVM::fold_condition(const Exp& exp) -> std::optional<bool> {
+    auto* value = llvm::dyn_cast_or_null<llvm::ConstantInt>(fold_constant(exp));
+    if (value == nullptr) {
+        return std::nullopt;
+    }
+
+    return !value->isZero();
+}
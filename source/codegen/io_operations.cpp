@@ -0,0 +1,143 @@
+#include "../morningllvm.hpp"
+
+#include <string>
+#include <vector>
+
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Instructions.h>
+
+#include "../logger.hpp"
+#include "../utils/cast.hpp"
+
+namespace {
+    /**
+     * @brief Check if a variable holds a pointer (string buffer) rather than a number
+     *
+     * With opaque pointers every variable's storage is a ptr, so the stored
+     * type has to be read from the alloca or global itself.
+     */
+    auto holds_pointer(const llvm::Value* storage) -> bool {
+        if (const auto* alloca = llvm::dyn_cast<llvm::AllocaInst>(storage)) {
+            return alloca->getAllocatedType()->isPointerTy();
+        }
+        if (const auto* global = llvm::dyn_cast<llvm::GlobalVariable>(storage)) {
+            return global->getValueType()->isPointerTy();
+        }
+        return false;
+    }
+}    // namespace
+
+auto MorningLanguageLLVM::generate_fprint(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process fprint");
+    auto* printf_function = m_MODULE->getFunction("printf");
+    std::vector<llvm::Value*> args {};
+
+    // Narrow integers are promoted like C varargs, by their own sign
+    for (auto i = 1; i < exp.list.size(); ++i) {
+        auto* arg = generate_expression(exp.list[i]);
+        if (arg->getType()->isIntegerTy() && arg->getType()->getIntegerBitWidth() < 64) {
+            arg = implicit_cast(
+                arg, m_IR_BUILDER->getInt64Ty(), *m_IR_BUILDER, is_unsigned_expression(exp.list[i]));
+        }
+        args.push_back(arg);
+    }
+
+    return m_IR_BUILDER->CreateCall(printf_function, args);
+}
+
+auto MorningLanguageLLVM::generate_finput(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process finput");
+
+    auto* scanf_fn = m_MODULE->getFunction("scanf");
+    std::vector<llvm::Value*> args;
+
+    // Automatically convert %s to %[^\n] for string inputs
+    const auto& format_exp = exp.list[1];
+    std::string format_str = (format_exp.type == ExpType::STRING) ? format_exp.string.str() : "";
+    bool has_string_input = false;
+
+    // Check for string arguments
+    for (size_t i = 2; i < exp.list.size(); ++i) {
+        std::string var_name = exp.list[i].string;
+        llvm::Value* var_ptr = m_ENV.lookup_by_name(var_name);
+        if (holds_pointer(var_ptr)) {
+            has_string_input = true;
+            break;
+        }
+    }
+
+    if (has_string_input && format_str.find("%s") != std::string::npos) {
+        // Replace all %s with %[^\n] to read full lines
+        size_t pos = 0;
+        while ((pos = format_str.find("%s", pos)) != std::string::npos) {
+            format_str.replace(pos, 2, "%[^\n]");
+            pos += 6; // Move past the replacement
+        }
+    }
+
+    // Create format string constant
+    auto* format_const = get_string_literal(format_str);
+    args.push_back(format_const);
+
+    // Process variables and create buffers
+    for (size_t i = 2; i < exp.list.size(); ++i) {
+        std::string var_name = exp.list[i].string;
+        llvm::Value* var_ptr = m_ENV.lookup_by_name(var_name);
+
+        if (holds_pointer(var_ptr)) {
+            // Allocate 256-byte buffer on stack
+            auto* buffer_type = llvm::ArrayType::get(
+                m_IR_BUILDER->getInt8Ty(), 256);
+            auto* buffer = m_IR_BUILDER->CreateAlloca(
+                buffer_type, nullptr, "input_buffer");
+            auto* buffer_ptr = m_IR_BUILDER->CreateBitCast(
+                buffer, m_IR_BUILDER->getInt8Ty()->getPointerTo());
+
+            // Store buffer pointer in variable
+            m_IR_BUILDER->CreateStore(buffer_ptr, var_ptr);
+            args.push_back(buffer_ptr);
+        } else {
+            args.push_back(var_ptr);
+        }
+    }
+
+    auto* scanf_call = m_IR_BUILDER->CreateCall(scanf_fn, args);
+
+    // Add buffer cleaning after scanf
+    if (has_string_input) {
+        auto* getchar_fn = m_MODULE->getFunction("getchar");
+        if (!getchar_fn) {
+            getchar_fn = llvm::Function::Create(
+                llvm::FunctionType::get(m_IR_BUILDER->getInt64Ty(), false),
+                llvm::Function::ExternalLinkage,
+                "getchar",
+                m_MODULE.get()
+            );
+        }
+
+        // Create blocks for cleaning loop
+        auto* loop_block = create_basic_block("clean_loop", m_ACTIVE_FUNCTION);
+        auto* end_block = create_basic_block("clean_end", m_ACTIVE_FUNCTION);
+
+        m_IR_BUILDER->CreateBr(loop_block);
+        m_SSA.open_block(loop_block);
+        m_IR_BUILDER->SetInsertPoint(loop_block);
+
+        // Read characters until newline or EOF
+        auto* ch = m_IR_BUILDER->CreateCall(getchar_fn, {}, "ch");
+        auto* is_newline = m_IR_BUILDER->CreateICmpEQ(
+            ch, m_IR_BUILDER->getInt64('\n'), "is_newline");
+        auto* is_eof = m_IR_BUILDER->CreateICmpEQ(
+            ch, m_IR_BUILDER->getInt64(-1), "is_eof");
+        auto* should_break = m_IR_BUILDER->CreateOr(
+            is_newline, is_eof, "break_cond");
+
+        m_IR_BUILDER->CreateCondBr(should_break, end_block, loop_block);
+        m_SSA.seal_block(loop_block);
+        m_IR_BUILDER->SetInsertPoint(end_block);
+    }
+
+    return scanf_call;
+}
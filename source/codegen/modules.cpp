@@ -0,0 +1,134 @@
+#include "../morningllvm.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "../logger.hpp"
+
+namespace {
+    /**
+     * @brief Check that exp is [import name]
+     */
+    auto is_import(const Exp& exp) -> bool {
+        return exp.type == ExpType::LIST && exp.list.size() == 2 && exp.list[0].type == ExpType::SYMBOL
+            && exp.list[0].string.form() == SpecialForm::IMPORT && exp.list[1].type == ExpType::SYMBOL;
+    }
+}    // namespace
+
+auto MorningLanguageLLVM::generate_import(const Exp& exp) -> llvm::Value* {
+    if (!is_import(exp)) {
+        LOG_CRITICAL("import requires a module name: [import name]");
+        return m_IR_BUILDER->getInt64(0);
+    }
+
+    const auto& module = exp.list[1].string.str();
+    LOG_DEBUG("Process import: %s", module.c_str());
+
+    auto found = m_MODULE_INTERFACES.find(module);
+    if (found == m_MODULE_INTERFACES.end()) {
+        LOG_CRITICAL("Module \"%s\" is not available, imports are resolved when compiling files", module.c_str());
+        return m_IR_BUILDER->getInt64(0);
+    }
+
+    std::istringstream lines(found->second);
+    std::string line;
+
+    while (std::getline(lines, line)) {
+        if (line.empty() || line[0] == ';') {
+            continue;
+        }
+
+        // <kind> <name> <LLVM type>
+        const auto NAME_START = line.find(' ') + 1;
+        const auto TYPE_START = line.find(' ', NAME_START) + 1;
+        const auto kind = line.substr(0, NAME_START - 1);
+        const auto name = line.substr(NAME_START, TYPE_START - NAME_START - 1);
+
+        llvm::SMDiagnostic diagnostic;
+        auto* type = NAME_START == 0 || TYPE_START == 0
+            ? nullptr
+            : llvm::parseType(line.substr(TYPE_START), diagnostic, *m_MODULE);
+
+        if (type == nullptr) {
+            LOG_CRITICAL("Broken interface of module \"%s\": %s", module.c_str(), line.c_str());
+            return m_IR_BUILDER->getInt64(0);
+        }
+
+        if (kind == "func" && type->isFunctionTy()) {
+            auto* function = m_MODULE->getFunction(name);
+            if (function == nullptr) {
+                function = llvm::Function::Create(llvm::cast<llvm::FunctionType>(type),
+                                                  llvm::Function::ExternalLinkage,
+                                                  name,
+                                                  m_MODULE.get());
+            }
+            m_ENV.define(name, function);
+        } else if (kind == "const") {
+            auto* global = m_MODULE->getNamedGlobal(name);
+            if (global == nullptr) {
+                global = new llvm::GlobalVariable(*m_MODULE,
+                                                  type,
+                                                  /* constant */ false,
+                                                  llvm::GlobalValue::ExternalLinkage,
+                                                  /* initializer */ nullptr,
+                                                  name);
+            }
+            if (auto* array_type = llvm::dyn_cast<llvm::ArrayType>(type)) {
+                m_ARRAY_TYPES[name] = array_type;
+            }
+            m_ENV.define(name, global, /* constant */ true);
+        } else {
+            LOG_CRITICAL("Broken interface of module \"%s\": %s", module.c_str(), line.c_str());
+        }
+    }
+
+    return m_IR_BUILDER->getInt64(0);
+}
+
+auto MorningLanguageLLVM::get_interface() const -> std::string {
+    std::string interface;
+    llvm::raw_string_ostream out(interface);
+
+    // Imported declarations are not re-exported, importers name every module they use
+    for (const auto& function : m_MODULE->functions()) {
+        if (function.isDeclaration() || !function.hasExternalLinkage()) {
+            continue;
+        }
+        out << "func " << function.getName() << " ";
+        function.getFunctionType()->print(out);
+        out << "\n";
+    }
+
+    for (const auto& global : m_MODULE->globals()) {
+        if (global.isDeclaration() || !global.hasExternalLinkage()) {
+            continue;
+        }
+        out << "const " << global.getName() << " ";
+        global.getValueType()->print(out);
+        out << "\n";
+    }
+
+    return out.str();
+}
+
+auto MorningLanguageLLVM::scan_imports(const std::string& program) -> std::vector<std::string> {
+    syntax::MorningLangGrammar parser;
+    auto ast = parser.parse("[scope " + program + "]");
+
+    std::vector<std::string> modules;
+    for (size_t i = 1; i < ast.list.size(); i++) {
+        if (is_import(ast.list[i])) {
+            modules.push_back(ast.list[i].list[1].string.str());
+        }
+    }
+
+    return modules;
+}
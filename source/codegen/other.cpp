@@ -0,0 +1,213 @@
+#include "../morningllvm.hpp"
+
+#include <algorithm>
+
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+
+#include "../logger.hpp"
+#include "../utils/cast.hpp"
+#include "../utils/convert.hpp"
+
+auto MorningLanguageLLVM::generate_sizeof(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process sizeof operator");
+
+    if (exp.list.size() < 2) {
+        LOG_CRITICAL("sizeof requires a type argument");
+    }
+
+    std::string type_str = exp.list[1].string;
+    return m_IR_BUILDER->getInt64(get_type_descriptor(type_str, "sizeof").size);
+}
+
+auto MorningLanguageLLVM::generate_type_alias(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process type alias");
+
+    if (exp.list.size() != 3 || exp.list[1].type != ExpType::SYMBOL || exp.list[2].type != ExpType::SYMBOL) {
+        LOG_CRITICAL("type requires a name and a type: [type name spelling]");
+        return m_IR_BUILDER->getInt64(0);
+    }
+
+    const std::string name = exp.list[1].string;
+    const std::string spelling = exp.list[2].string;
+
+    if (name.empty() || name[0] == '!') {
+        LOG_CRITICAL("Type alias \"%s\" can not start with '!', reserved for built-in types", name.c_str());
+        return m_IR_BUILDER->getInt64(0);
+    }
+
+    auto found = m_TYPE_ALIASES.find(name);
+    if (found != m_TYPE_ALIASES.end() && found->second != spelling) {
+        LOG_CRITICAL("Type alias \"%s\" is already defined as %s", name.c_str(), found->second.c_str());
+        return m_IR_BUILDER->getInt64(0);
+    }
+
+    // Resolve now so a broken spelling is reported where the alias is defined, the alias can not name itself
+    m_ALIASES_IN_RESOLUTION.push_back(name);
+    auto* type = parse_type(spelling, name);
+    m_ALIASES_IN_RESOLUTION.pop_back();
+
+    if (type == nullptr) {
+        LOG_CRITICAL("Type alias \"%s\" names unknown type %s", name.c_str(), spelling.c_str());
+        return m_IR_BUILDER->getInt64(0);
+    }
+
+    m_TYPE_ALIASES[name] = spelling;
+
+    return m_IR_BUILDER->getInt64(0);
+}
+
+auto MorningLanguageLLVM::generate_mem_alloc(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process memory allocation");
+
+    const auto& size_exp = exp.list[1];
+    auto* size_val = generate_expression(size_exp);
+    auto* malloc_fn = m_MODULE->getFunction("malloc");
+
+    if (!malloc_fn) {
+        auto* malloc_type = llvm::FunctionType::get(
+            m_IR_BUILDER->getInt8Ty()->getPointerTo(), {m_IR_BUILDER->getInt64Ty()}, false);
+        malloc_fn = llvm::Function::Create(
+            malloc_type, llvm::Function::ExternalLinkage, "malloc", m_MODULE.get());
+    }
+
+    return m_IR_BUILDER->CreateCall(malloc_fn, {size_val}, "malloc");
+}
+
+auto MorningLanguageLLVM::generate_mem_free(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process memory free");
+
+    const auto& ptr_exp = exp.list[1];
+    auto* ptr_val = generate_expression(ptr_exp);
+    auto* free_fn = m_MODULE->getFunction("free");
+
+    if (!free_fn) {
+        auto* free_type = llvm::FunctionType::get(
+            m_IR_BUILDER->getVoidTy(), {m_IR_BUILDER->getInt8Ty()->getPointerTo()}, false);
+        free_fn = llvm::Function::Create(
+            free_type, llvm::Function::ExternalLinkage, "free", m_MODULE.get());
+    }
+
+    m_IR_BUILDER->CreateCall(free_fn, {ptr_val});
+    return m_IR_BUILDER->getInt64(0);
+}
+
+auto MorningLanguageLLVM::generate_mem_write(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process memory write");
+
+    const auto& ptr_exp = exp.list[1];
+    const auto& value_exp = exp.list[2];
+    auto* ptr_val = generate_expression(ptr_exp);
+    auto* value_val = generate_expression(value_exp);
+
+    auto* casted_ptr = m_IR_BUILDER->CreateBitCast(
+        ptr_val, value_val->getType()->getPointerTo(), "cast_ptr");
+    m_IR_BUILDER->CreateStore(value_val, casted_ptr);
+    return value_val;
+}
+
+auto MorningLanguageLLVM::generate_mem_read(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process memory read");
+
+    const auto& ptr_exp = exp.list[1];
+    const auto& type_exp = exp.list[2];
+    auto* ptr_val = generate_expression(ptr_exp);
+    auto* target_type = get_type(type_exp.string, "mem_read");
+
+    auto* casted_ptr =
+        m_IR_BUILDER->CreateBitCast(ptr_val, target_type->getPointerTo(), "cast_ptr");
+    return m_IR_BUILDER->CreateLoad(target_type, casted_ptr, "load");
+}
+
+auto MorningLanguageLLVM::generate_mem_ptr(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process get pointer");
+
+    auto var_name = exp.list[1].string;
+    auto* var_ptr = m_ENV.lookup_by_name(var_name);
+
+    return m_IR_BUILDER->CreateBitCast(
+        var_ptr, m_IR_BUILDER->getInt8Ty()->getPointerTo(), "to_void_ptr");
+}
+
+auto MorningLanguageLLVM::generate_mem_deref(const Exp& exp) -> llvm::Value* {
+    LOG_DEBUG("Process pointer dereference");
+
+    const auto& ptr_exp = exp.list[1];
+    const auto& type_exp = exp.list[2];
+    auto* ptr_val = generate_expression(ptr_exp);
+    auto* target_type = get_type(type_exp.string, "mem_deref");
+
+    auto* casted_ptr =
+        m_IR_BUILDER->CreateBitCast(ptr_val, target_type->getPointerTo(), "cast_ptr");
+    return m_IR_BUILDER->CreateLoad(target_type, casted_ptr, "deref");
+}
+
+auto MorningLanguageLLVM::generate_bitwise(const Exp& exp, llvm::Type* context_type, bool unsigned_context)
+    -> llvm::Value* {
+    auto form = exp.list[0].string.form();
+
+    if (form == SpecialForm::BIT_NOT) {
+        auto* value = generate_expression(exp.list[1], context_type, unsigned_context);
+
+        if (!value->getType()->isIntegerTy()) {
+            LOG_CRITICAL("Bitwise operation requires integer operand, got %s",
+                        type_to_string(value->getType()).c_str());
+        }
+
+        return m_IR_BUILDER->CreateNot(value, "bit_not");
+    }
+
+    auto [left, right] = generate_operands(exp.list[1], exp.list[2], context_type, unsigned_context);
+
+    if (!left->getType()->isIntegerTy() || !right->getType()->isIntegerTy()) {
+        LOG_CRITICAL("Bitwise operation requires integer operands, got %s and %s",
+                    type_to_string(left->getType()).c_str(),
+                    type_to_string(right->getType()).c_str());
+    }
+
+    // Operands widen by their own sign; a shift takes the sign of the shifted value only
+    const auto [LEFT_UNSIGNED, RIGHT_UNSIGNED] = operand_signs(exp.list[1], exp.list[2], unsigned_context);
+
+    llvm::Type* common_type = nullptr;
+    if (left->getType() != right->getType()) {
+        unsigned left_size = left->getType()->getIntegerBitWidth();
+        unsigned right_size = right->getType()->getIntegerBitWidth();
+        unsigned max_size = std::max(left_size, right_size);
+        common_type = m_IR_BUILDER->getIntNTy(max_size);
+
+        left = implicit_cast(left, common_type, *m_IR_BUILDER, LEFT_UNSIGNED);
+        right = implicit_cast(right, common_type, *m_IR_BUILDER, RIGHT_UNSIGNED);
+    } else {
+        common_type = left->getType();
+    }
+
+    switch (form) {
+        case SpecialForm::BIT_AND:
+            return m_IR_BUILDER->CreateAnd(left, right, "bit_and");
+        case SpecialForm::BIT_OR:
+            return m_IR_BUILDER->CreateOr(left, right, "bit_or");
+        case SpecialForm::BIT_XOR:
+            return m_IR_BUILDER->CreateXor(left, right, "bit_xor");
+        case SpecialForm::BIT_SHL:
+            return m_IR_BUILDER->CreateShl(left, right, "bit_shl");
+        default:
+            return LEFT_UNSIGNED ? m_IR_BUILDER->CreateLShr(left, right, "bit_shr")
+                                 : m_IR_BUILDER->CreateAShr(left, right, "bit_shr");
+    }
+}
+
+auto MorningLanguageLLVM::generate_byte_read(const Exp& exp) -> llvm::Value* {
+    auto* ptr = generate_expression(exp.list[1]);
+    auto* casted_ptr =
+        m_IR_BUILDER->CreateBitCast(ptr, m_IR_BUILDER->getInt8Ty()->getPointerTo());
+    return m_IR_BUILDER->CreateLoad(m_IR_BUILDER->getInt8Ty(), casted_ptr, "byte_read");
+}
+
+auto MorningLanguageLLVM::generate_byte_write(const Exp& exp) -> llvm::Value* {
+    auto* ptr = generate_expression(exp.list[1]);
+    auto* value = generate_expression(exp.list[2], m_IR_BUILDER->getInt8Ty());
+    auto* casted_ptr =
+        m_IR_BUILDER->CreateBitCast(ptr, m_IR_BUILDER->getInt8Ty()->getPointerTo());
+    return m_IR_BUILDER->CreateStore(
+        m_IR_BUILDER->CreateZExtOrTrunc(value, m_IR_BUILDER->getInt8Ty()), casted_ptr);
+}
@@ -0,0 +1,128 @@
+#include "ssa.hpp"
+
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/IRBuilder.h>
+
+auto SsaBuilder::declare(llvm::Type* type, llvm::Function* function, std::string name) -> uint32_t {
+    m_VARIABLES.push_back({type, function, std::move(name)});
+    return static_cast<uint32_t>(m_VARIABLES.size() - 1);
+}
+
+void SsaBuilder::write(uint32_t variable, llvm::BasicBlock* block, llvm::Value* value) {
+    m_DEFINITIONS[{block, variable}] = value;
+}
+
+auto SsaBuilder::read(uint32_t variable, llvm::BasicBlock* block) -> llvm::Value* {
+    auto found = m_DEFINITIONS.find({block, variable});
+    if (found != m_DEFINITIONS.end() && found->second) {
+        return found->second;
+    }
+    return read_recursive(variable, block);
+}
+
+void SsaBuilder::open_block(llvm::BasicBlock* block) {
+    m_OPEN_BLOCKS.insert(block);
+}
+
+void SsaBuilder::seal_block(llvm::BasicBlock* block) {
+    m_OPEN_BLOCKS.erase(block);
+
+    auto found = m_INCOMPLETE_PHIS.find(block);
+    if (found == m_INCOMPLETE_PHIS.end()) {
+        return;
+    }
+
+    const auto PHIS = std::move(found->second);
+    m_INCOMPLETE_PHIS.erase(found);
+
+    for (const auto& [variable, phi] : PHIS) {
+        add_phi_operands(variable, phi);
+    }
+}
+
+void SsaBuilder::clear() {
+    m_VARIABLES.clear();
+    m_DEFINITIONS.clear();
+    m_INCOMPLETE_PHIS.clear();
+    m_OPEN_BLOCKS.clear();
+    m_FILLING_PHIS.clear();
+}
+
+auto SsaBuilder::read_recursive(uint32_t variable, llvm::BasicBlock* block) -> llvm::Value* {
+    llvm::Value* value = nullptr;
+
+    if (m_OPEN_BLOCKS.contains(block)) {
+        // Operands are added once the back edges exist
+        auto* phi = create_phi(variable, block);
+        m_INCOMPLETE_PHIS[block].emplace_back(variable, phi);
+        value = phi;
+    } else if (auto* predecessor = block->getSinglePredecessor()) {
+        value = read(variable, predecessor);
+    } else if (llvm::pred_empty(block)) {
+        // Only unreachable blocks, such as the one after a break, have no predecessors
+        value = llvm::UndefValue::get(type(variable));
+    } else {
+        // Defining the phi first ends cycles through loops
+        auto* phi = create_phi(variable, block);
+        write(variable, block, phi);
+        value = add_phi_operands(variable, phi);
+    }
+
+    write(variable, block, value);
+    return value;
+}
+
+auto SsaBuilder::create_phi(uint32_t variable, llvm::BasicBlock* block) -> llvm::PHINode* {
+    llvm::IRBuilder<> builder(block, block->begin());
+    return builder.CreatePHI(type(variable), 2, m_VARIABLES[variable].name);
+}
+
+auto SsaBuilder::add_phi_operands(uint32_t variable, llvm::PHINode* phi) -> llvm::Value* {
+    m_FILLING_PHIS.insert(phi);
+    for (auto* predecessor : llvm::predecessors(phi->getParent())) {
+        phi->addIncoming(read(variable, predecessor), predecessor);
+    }
+    m_FILLING_PHIS.erase(phi);
+
+    return try_remove_trivial_phi(phi);
+}
+
+auto SsaBuilder::try_remove_trivial_phi(llvm::PHINode* phi) -> llvm::Value* {
+    llvm::Value* same = nullptr;
+    for (llvm::Value* operand : phi->incoming_values()) {
+        // Undef comes from unreachable predecessors and may take any value
+        if (operand == same || operand == phi || llvm::isa<llvm::UndefValue>(operand)) {
+            continue;
+        }
+        if (same != nullptr) {
+            return phi;    // Merges at least two values
+        }
+        same = operand;
+    }
+
+    if (same == nullptr) {
+        same = llvm::UndefValue::get(phi->getType());
+    }
+
+    // Phis using this one may become trivial in turn and be removed with their users
+    std::vector<llvm::WeakVH> users;
+    for (auto* user : phi->users()) {
+        auto* user_phi = llvm::dyn_cast<llvm::PHINode>(user);
+        if (user_phi != nullptr && user_phi != phi && !m_FILLING_PHIS.contains(user_phi)) {
+            users.emplace_back(user_phi);
+        }
+    }
+
+    llvm::WeakTrackingVH result(same);
+    phi->replaceAllUsesWith(same);
+    phi->eraseFromParent();
+
+    for (auto& user : users) {
+        if (user) {
+            try_remove_trivial_phi(llvm::cast<llvm::PHINode>(user));
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/ValueHandle.h>
+
+/**
+ * @brief On-the-fly SSA construction for locals kept in registers
+ *
+ * Implements "Simple and Efficient Construction of Static Single Assignment
+ * Form" (Braun et al., 2013). Every write records the current definition of
+ * a variable in the block it happens in; a read looks the definition up,
+ * walking to predecessors and placing phis where control flow joins.
+ *
+ * A block is sealed once all of its predecessors are known. Blocks are
+ * sealed unless opened with open_block(): the code generator emits every
+ * predecessor of a block before filling it, except for loop headers,
+ * whose back edges come last. Reads in an open block get operandless phis
+ * that are completed by seal_block(). Phis that turn out to merge a single
+ * value are removed right away.
+ */
+class SsaBuilder {
+  public:
+    /**
+     * @brief Declare new variable
+     *
+     * @param type Type of every value of the variable
+     * @param function Function the variable is local to
+     * @param name Name given to phis of the variable
+     * @return uint32_t Variable id
+     */
+    auto declare(llvm::Type* type, llvm::Function* function, std::string name) -> uint32_t;
+
+    /**
+     * @brief Get type of variable
+     */
+    auto type(uint32_t variable) const -> llvm::Type* { return m_VARIABLES[variable].type; }
+
+    /**
+     * @brief Get function the variable is local to
+     */
+    auto function(uint32_t variable) const -> llvm::Function* { return m_VARIABLES[variable].function; }
+
+    /**
+     * @brief Record value as definition of variable at the end of block
+     */
+    void write(uint32_t variable, llvm::BasicBlock* block, llvm::Value* value);
+
+    /**
+     * @brief Get value of variable at the end of block
+     */
+    auto read(uint32_t variable, llvm::BasicBlock* block) -> llvm::Value*;
+
+    /**
+     * @brief Mark block as getting more predecessors later, e.g. a loop header
+     */
+    void open_block(llvm::BasicBlock* block);
+
+    /**
+     * @brief Declare that all predecessors of block exist and complete its phis
+     */
+    void seal_block(llvm::BasicBlock* block);
+
+    /**
+     * @brief Forget all variables and blocks, used when a new module starts
+     */
+    void clear();
+
+  private:
+    struct Variable {
+        llvm::Type* type;
+        llvm::Function* function;
+        std::string name;
+    };
+
+    auto read_recursive(uint32_t variable, llvm::BasicBlock* block) -> llvm::Value*;
+    auto create_phi(uint32_t variable, llvm::BasicBlock* block) -> llvm::PHINode*;
+    auto add_phi_operands(uint32_t variable, llvm::PHINode* phi) -> llvm::Value*;
+    auto try_remove_trivial_phi(llvm::PHINode* phi) -> llvm::Value*;
+
+    std::vector<Variable> m_VARIABLES;
+    llvm::DenseMap<std::pair<llvm::BasicBlock*, uint32_t>, llvm::WeakTrackingVH> m_DEFINITIONS;    ///< Follows phis replaced by their value
+    llvm::DenseMap<llvm::BasicBlock*, std::vector<std::pair<uint32_t, llvm::PHINode*>>> m_INCOMPLETE_PHIS;
+    llvm::SmallPtrSet<llvm::BasicBlock*, 8> m_OPEN_BLOCKS;
+    llvm::SmallPtrSet<llvm::PHINode*, 8> m_FILLING_PHIS;    ///< Phis getting operands, not checked for triviality yet
+};
@@ -0,0 +1,135 @@
+#include "../morningllvm.hpp"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+
+#include "../logger.hpp"
+#include "../utils/cast.hpp"
+#include "../utils/convert.hpp"
+
+auto MorningLanguageLLVM::generate_var(const Exp& exp) -> llvm::Value* {
+    const auto& var_name_declaration = exp.list[1];
+    auto var_name = extract_var_name(var_name_declaration);
+
+    // REPL inputs share one top level, so names from earlier inputs clash too, as do imported names
+    auto redefined = is_top_level() ? m_ENV.lookup_by_name(var_name, false) != nullptr
+                                         : m_ENV.defined_in_scope(var_name);
+
+    if (redefined) {
+        LOG_CRITICAL("Var \"%s\" is already defined", var_name.c_str());
+        return m_IR_BUILDER->getInt64(0);
+    }
+
+    LOG_DEBUG("Process create %s: %s", exp.list[0].string.c_str(), var_name.c_str());
+
+    auto* var_type = extract_var_type(var_name_declaration);
+    const bool IS_UNSIGNED = is_unsigned_declaration(var_name_declaration);
+
+    // Declarations without an initializer start zeroed
+    auto* init = exp.list.size() > 2 ? generate_expression(exp.list[2], var_type, IS_UNSIGNED)
+                                     : llvm::Constant::getNullValue(var_type);
+
+    if (llvm::isa<llvm::ArrayType>(var_type)) {
+        m_ARRAY_TYPES[var_name] = llvm::cast<llvm::ArrayType>(var_type);
+    }
+
+    // Validate type
+    if (init->getType() != var_type) {
+        const bool INIT_UNSIGNED = is_unsigned_expression(exp.list[2], IS_UNSIGNED);
+
+        // Allow implicit conversion of integers to the declared width and to frac, and of pointers
+        const bool CONVERTIBLE =
+            (init->getType()->isIntegerTy() && (var_type->isIntegerTy() || var_type->isDoubleTy()))
+            || (init->getType()->isPointerTy() && var_type->isPointerTy());
+
+        if (CONVERTIBLE) {
+            init = implicit_cast(init, var_type, *m_IR_BUILDER, INIT_UNSIGNED);
+        } else {
+            LOG_CRITICAL("Type mismatch for '%s': declared as %s but initialized with %s",
+                         var_name.c_str(),
+                         type_to_string(var_type, IS_UNSIGNED).c_str(),
+                         type_to_string(init->getType(), INIT_UNSIGNED).c_str());
+        }
+    }
+
+    const bool IS_CONSTANT = exp.list[0].string.form() == SpecialForm::CONST;
+
+    llvm::Value* result = nullptr;
+    if (is_register_candidate(var_name, var_type)) {
+        result = define_register_var(var_name, var_type, init, IS_CONSTANT);
+    } else {
+        result = m_IR_BUILDER->CreateStore(init, alloc_var(var_name, var_type, IS_CONSTANT));
+    }
+
+    if (IS_UNSIGNED) {
+        m_ENV.mark_unsigned(var_name);
+    }
+
+    // Reads of scalar constants become their value; top-level ones may be imported or
+    // read by later REPL inputs, which only see the storage
+    if (IS_CONSTANT && !is_top_level() && init->getType() == var_type
+        && llvm::isa<llvm::ConstantInt, llvm::ConstantFP>(init))
+    {
+        m_ENV.set_folded(var_name, llvm::cast<llvm::Constant>(init));
+    }
+
+    return result;
+}
+
+auto MorningLanguageLLVM::generate_set(const Exp& exp) -> llvm::Value* {
+    if (exp.list[1].type == ExpType::LIST && !exp.list[1].list.empty()
+        && exp.list[1].list[0].string.form() == SpecialForm::INDEX)
+    {
+        return generate_index_store(exp.list[1], exp.list[2]);
+    }
+
+    auto var_name = exp.list[1].string;
+
+    LOG_DEBUG("Process set value to var: %s", var_name.c_str());
+
+    if (m_ENV.is_constant(var_name)) {
+        LOG_CRITICAL("Var name \"%s\" is constant", var_name.c_str());
+        return m_IR_BUILDER->getInt64(0);
+    }
+
+    auto variable = m_ENV.lookup_register(var_name);
+    auto* var_binding = variable ? nullptr : m_ENV.lookup_by_name(var_name);
+
+    // Get actual variable type
+    llvm::Type* var_type = nullptr;
+    if (variable) {
+        var_type = m_SSA.type(*variable);
+    } else if (auto* alloca = llvm::dyn_cast<llvm::AllocaInst>(var_binding)) {
+        var_type = alloca->getAllocatedType();
+    } else if (auto* global = llvm::dyn_cast<llvm::GlobalVariable>(var_binding)) {
+        var_type = global->getValueType();
+    }
+
+    const bool IS_UNSIGNED = m_ENV.is_unsigned(var_name);
+    auto* value = generate_expression(exp.list[2], var_type, IS_UNSIGNED);
+
+    // Validate type
+    if (value->getType() != var_type) {
+        const bool VALUE_UNSIGNED = is_unsigned_expression(exp.list[2], IS_UNSIGNED);
+
+        // Allow implicit conversion of integers to the variable's width and to frac
+        if (value->getType()->isIntegerTy() && var_type != nullptr
+            && (var_type->isIntegerTy() || var_type->isDoubleTy()))
+        {
+            value = implicit_cast(value, var_type, *m_IR_BUILDER, VALUE_UNSIGNED);
+        } else if (type_to_string(value->getType()) != type_to_string(var_type)) {
+            LOG_CRITICAL("Type mismatch for '%s': cannot assign %s to %s",
+                        var_name.c_str(),
+                        type_to_string(value->getType(), VALUE_UNSIGNED).c_str(),
+                        type_to_string(var_type, IS_UNSIGNED).c_str());
+        }
+    }
+
+    if (variable) {
+        return write_register_var(*variable, value, var_name);
+    }
+
+    m_IR_BUILDER->CreateStore(value, var_binding);
+
+    return value;
+}
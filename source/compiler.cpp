@@ -7,16 +7,20 @@
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/Target/TargetOptions.h>
 #include <llvm/Support/CodeGen.h>
-#include <lld/Common/Driver.h>
-#include <lld/Common/LLVM.h>
+
+#include <mutex>
 
 llvm_compiler::llvm_compiler() {
     initialize_target();
 }
 
 auto llvm_compiler::initialize_target() -> bool {
-    llvm::InitializeNativeTarget();
-    llvm::InitializeNativeTargetAsmPrinter();
+    // Backends are created on every worker of a multi-file build, targets are registered once
+    static std::once_flag targets_initialized;
+    std::call_once(targets_initialized, [] {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+    });
 
     std::string error;
     std::string triple = llvm::sys::getDefaultTargetTriple();
@@ -32,7 +36,7 @@ auto llvm_compiler::initialize_target() -> bool {
         llvm::sys::getHostCPUName(),
         "",
         opt,
-        std::nullopt,
+        llvm::Reloc::PIC_,    // Position independent, so system linkers can produce PIE binaries
         std::nullopt,
         llvm::CodeGenOptLevel::Default
     ));
@@ -40,28 +44,61 @@ auto llvm_compiler::initialize_target() -> bool {
     return target_machine != nullptr;
 }
 
-auto llvm_compiler::compile_module_to_object_file(llvm::Module& module, const std::string& output_filename) -> bool {
-    if (target_machine == nullptr) {
-        return false;
+void llvm_compiler::set_opt_level(llvm::CodeGenOptLevel level) {
+    if (target_machine != nullptr) {
+        target_machine->setOptLevel(level);
     }
+}
 
-    module.setDataLayout(target_machine->createDataLayout());
-    module.setTargetTriple(target_machine->getTargetTriple().str());
+auto llvm_compiler::compile_module_to_object_file(llvm::Module& module, const std::string& output_filename) -> bool {
+    return emit_module_to_file(module, output_filename, llvm::CodeGenFileType::ObjectFile);
+}
+
+auto llvm_compiler::compile_module_to_assembly_file(llvm::Module& module, const std::string& output_filename) -> bool {
+    return emit_module_to_file(module, output_filename, llvm::CodeGenFileType::AssemblyFile);
+}
 
+auto llvm_compiler::emit_module_to_file(llvm::Module& module,
+                                        const std::string& output_filename,
+                                        llvm::CodeGenFileType file_type) -> bool {
     std::error_code file_error;
-    llvm::raw_fd_ostream dest(output_filename, file_error, llvm::sys::fs::OF_None);
+    llvm::raw_fd_ostream dest(output_filename,
+                              file_error,
+                              file_type == llvm::CodeGenFileType::AssemblyFile ? llvm::sys::fs::OF_Text
+                                                                               : llvm::sys::fs::OF_None);
     if (file_error) {
         return false;
     }
 
+    if (!emit_module(module, dest, file_type)) {
+        return false;
+    }
+
+    dest.flush();
+    return true;
+}
+
+auto llvm_compiler::compile_module_to_buffer(llvm::Module& module, llvm::SmallVectorImpl<char>& buffer) -> bool {
+    llvm::raw_svector_ostream dest(buffer);
+    return emit_module(module, dest, llvm::CodeGenFileType::ObjectFile);
+}
+
+auto llvm_compiler::emit_module(llvm::Module& module,
+                                llvm::raw_pwrite_stream& dest,
+                                llvm::CodeGenFileType file_type) -> bool {
+    if (target_machine == nullptr) {
+        return false;
+    }
+
+    module.setDataLayout(target_machine->createDataLayout());
+    module.setTargetTriple(target_machine->getTargetTriple().str());
+
     llvm::legacy::PassManager pass;
-    llvm::CodeGenFileType file_type = llvm::CodeGenFileType::ObjectFile;
 
     if (target_machine->addPassesToEmitFile(pass, dest, nullptr, file_type)) {
         return false;
     }
 
     pass.run(module);
-    dest.flush();
     return true;
 }
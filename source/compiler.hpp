@@ -1,6 +1,9 @@
 #pragma once
 
+#include <llvm/ADT/SmallVector.h>
 #include <llvm/IR/Module.h>
+#include <llvm/Support/CodeGen.h>
+#include <llvm/Support/raw_ostream.h>
 #include <llvm/Target/TargetMachine.h>
 #include <string>
 #include <memory>
@@ -10,8 +13,16 @@ class llvm_compiler {
 public:
     llvm_compiler();
     auto compile_module_to_object_file(llvm::Module& module, const std::string& output_filename) -> bool;
+    auto compile_module_to_assembly_file(llvm::Module& module, const std::string& output_filename) -> bool;
+    auto compile_module_to_buffer(llvm::Module& module, llvm::SmallVectorImpl<char>& buffer) -> bool;
+    void set_opt_level(llvm::CodeGenOptLevel level);
+    auto get_target_machine() -> llvm::TargetMachine* { return target_machine.get(); }
 
 private:
     std::unique_ptr<llvm::TargetMachine> target_machine;
     auto initialize_target() -> bool;
+    auto emit_module(llvm::Module& module, llvm::raw_pwrite_stream& dest, llvm::CodeGenFileType file_type) -> bool;
+    auto emit_module_to_file(llvm::Module& module,
+                             const std::string& output_filename,
+                             llvm::CodeGenFileType file_type) -> bool;
 };
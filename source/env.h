@@ -1,55 +1,221 @@
 #pragma once
 
-#include <map>
-#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <string>
-#include <utility>
+#include <vector>
 
+#include "llvm/IR/Constant.h"
 #include "llvm/IR/Value.h"
 #include "logger.hpp"
+#include "parser/MorningLangGrammar.h"
 #include "tracelogger.hpp"
 
-class Environment : public std::enable_shared_from_this<Environment> {
+/**
+ * @brief Lexical scopes of the compiled program as a single stack
+ *
+ * Bindings are pushed onto one flat vector; every scope only remembers where
+ * it started, so entering and leaving a scope never allocates. Symbol ids
+ * handed out by the parser's SymbolTable are dense, which lets the innermost
+ * binding of every name be found by indexing a table with the id instead of
+ * walking the scope chain. Each binding keeps the index of the binding it
+ * shadows, so popping a scope restores outer names in place.
+ *
+ * A binding holds either a value, the storage of a variable or a function,
+ * or the id of a local kept in registers by SsaBuilder. Constants known at
+ * compile time also keep their value, so reads can be folded. LLVM integer
+ * types carry no sign, so bindings of unsigned variables, arrays of unsigned
+ * elements and functions returning unsigned values are marked.
+ */
+class Environment {
   public:
-    Environment(std::map<std::string, llvm::Value*> record, std::shared_ptr<Environment> parent)
-        : m_RECORD(std::move(record))
-        , m_PARENT(std::move(parent)) {
+    explicit Environment(SymbolTable& symbols)
+        : m_SYMBOLS(symbols) {
         LOG_TRACE
     }
 
-    auto define(const std::string& var_name, llvm::Value* value) -> llvm::Value* {
-        LOG_TRACE
+    /**
+     * @brief Opens a nested scope
+     */
+    void push_scope() { m_SCOPES.push_back(m_BINDINGS.size()); }
 
-        m_RECORD[var_name] = value;
+    /**
+     * @brief Closes the innermost scope, dropping everything defined in it
+     */
+    void pop_scope() {
+        const auto start = m_SCOPES.back();
+        m_SCOPES.pop_back();
 
-        return value;
+        while (m_BINDINGS.size() > start) {
+            const auto& binding = m_BINDINGS.back();
+            m_HEADS[binding.symbol] = binding.shadowed;
+            m_BINDINGS.pop_back();
+        }
     }
 
-    auto lookup_by_name(const std::string& var_name, bool raise_error = true) -> llvm::Value* {
+    /**
+     * @brief Number of open scopes
+     */
+    auto depth() const -> size_t { return m_SCOPES.size(); }
+
+    auto define(Symbol name, llvm::Value* value, bool constant = false) -> llvm::Value* {
         LOG_TRACE
 
-        return resolve(var_name, raise_error)->m_RECORD[var_name];
+        bind(name, value, NO_REGISTER, constant);
+        return value;
     }
 
-  private:
-    auto resolve(const std::string& name, bool raise_error) -> std::shared_ptr<Environment> {
+    auto define(const std::string& name, llvm::Value* value, bool constant = false) -> llvm::Value* {
+        return define(m_SYMBOLS.intern(name), value, constant);
+    }
+
+    /**
+     * @brief Binds name to a local that lives in SSA registers instead of memory
+     *
+     * @param variable Variable id from SsaBuilder
+     */
+    void define_register(Symbol name, uint32_t variable, bool constant = false) {
         LOG_TRACE
 
-        if (m_RECORD.find(name) != m_RECORD.end()) {
-            return shared_from_this();
+        bind(name, nullptr, variable, constant);
+    }
+
+    /**
+     * @brief Gets SsaBuilder id of the visible binding, if it is a register local
+     */
+    auto lookup_register(Symbol name) const -> std::optional<uint32_t> {
+        const auto* binding = find(name);
+        if (binding == nullptr || binding->variable == NO_REGISTER) {
+            return std::nullopt;
         }
+        return binding->variable;
+    }
+
+    /**
+     * @brief Records compile-time value of the visible binding, which must be a constant
+     */
+    void set_folded(Symbol name, llvm::Constant* value) {
+        if (const auto* binding = find(name); binding != nullptr && binding->constant) {
+            m_BINDINGS[m_HEADS[name.id()]].folded = value;
+        }
+    }
+
+    /**
+     * @brief Gets compile-time value of the visible binding, null if it has none
+     */
+    auto lookup_folded(Symbol name) const -> llvm::Constant* {
+        const auto* binding = find(name);
+        return binding == nullptr ? nullptr : binding->folded;
+    }
+
+    /**
+     * @brief Marks the visible binding as holding unsigned integers
+     */
+    void mark_unsigned(Symbol name) {
+        if (find(name) != nullptr) {
+            m_BINDINGS[m_HEADS[name.id()]].is_unsigned = true;
+        }
+    }
+
+    void mark_unsigned(const std::string& name) { mark_unsigned(m_SYMBOLS.intern(name)); }
+
+    /**
+     * @brief Checks whether the visible binding holds unsigned integers
+     */
+    auto is_unsigned(Symbol name) const -> bool {
+        const auto* binding = find(name);
+        return binding != nullptr && binding->is_unsigned;
+    }
+
+    auto is_unsigned(const std::string& name) const -> bool { return is_unsigned(m_SYMBOLS.intern(name)); }
 
-        if (raise_error) {
-            if (m_PARENT == nullptr) {
+    /**
+     * @brief Checks whether the name is bound in any open scope
+     */
+    auto is_defined(Symbol name) const -> bool { return find(name) != nullptr; }
+
+    auto lookup_by_name(Symbol name, bool raise_error = true) const -> llvm::Value* {
+        LOG_TRACE
+
+        const auto* binding = find(name);
+        if (binding == nullptr) {
+            if (raise_error) {
                 LOG_CRITICAL("Variable \"%s\" is not defined", name.c_str());
-                return nullptr;    // Never reached but for safety
             }
+            return nullptr;
+        }
+
+        return binding->value;
+    }
+
+    auto lookup_by_name(const std::string& var_name, bool raise_error = true) const -> llvm::Value* {
+        return lookup_by_name(m_SYMBOLS.intern(var_name), raise_error);
+    }
+
+    /**
+     * @brief Checks whether the name is bound in the innermost scope itself
+     */
+    auto defined_in_scope(Symbol name) const -> bool {
+        const auto* binding = find(name);
+        return binding != nullptr && static_cast<size_t>(binding - m_BINDINGS.data()) >= scope_start();
+    }
+
+    /**
+     * @brief Checks whether the visible binding of the name was declared constant
+     */
+    auto is_constant(Symbol name) const -> bool {
+        const auto* binding = find(name);
+        return binding != nullptr && binding->constant;
+    }
+
+    auto is_constant(const std::string& name) const -> bool { return is_constant(m_SYMBOLS.intern(name)); }
+
+  private:
+    static constexpr uint32_t NO_BINDING = UINT32_MAX;
+    static constexpr uint32_t NO_REGISTER = UINT32_MAX;
+
+    struct Binding {
+        uint32_t symbol;
+        uint32_t shadowed;    ///< Binding of the same name in an outer scope
+        llvm::Value* value;    ///< Null for register locals
+        uint32_t variable;    ///< SsaBuilder id of a register local, NO_REGISTER otherwise
+        llvm::Constant* folded;    ///< Value of a constant known at compile time, null otherwise
+        bool constant;
+        bool is_unsigned;    ///< Integers read from the binding are unsigned
+    };
+
+    void bind(Symbol name, llvm::Value* value, uint32_t variable, bool constant) {
+        if (name.id() >= m_HEADS.size()) {
+            m_HEADS.resize(m_SYMBOLS.size(), NO_BINDING);
         }
 
-        return m_PARENT->resolve(name, raise_error);
+        // Redefinition within the same scope replaces the binding
+        const auto head = m_HEADS[name.id()];
+        if (head != NO_BINDING && head >= scope_start()) {
+            m_BINDINGS[head].value = value;
+            m_BINDINGS[head].variable = variable;
+            m_BINDINGS[head].folded = nullptr;
+            m_BINDINGS[head].constant = constant;
+            m_BINDINGS[head].is_unsigned = false;
+            return;
+        }
+
+        m_HEADS[name.id()] = static_cast<uint32_t>(m_BINDINGS.size());
+        m_BINDINGS.push_back({name.id(), head, value, variable, nullptr, constant, false});
+    }
+
+    auto find(Symbol name) const -> const Binding* {
+        if (name.id() >= m_HEADS.size() || m_HEADS[name.id()] == NO_BINDING) {
+            return nullptr;
+        }
+        return &m_BINDINGS[m_HEADS[name.id()]];
     }
 
-    std::map<std::string, llvm::Value*> m_RECORD;
+    auto scope_start() const -> size_t { return m_SCOPES.empty() ? 0 : m_SCOPES.back(); }
 
-    std::shared_ptr<Environment> m_PARENT;
+    SymbolTable& m_SYMBOLS;
+    std::vector<uint32_t> m_HEADS;    ///< Innermost binding for every symbol id
+    std::vector<Binding> m_BINDINGS;
+    std::vector<size_t> m_SCOPES;    ///< Binding count at the start of every open scope
 };
@@ -0,0 +1,97 @@
+#include "fragments.hpp"
+
+#include <cctype>
+
+#include "parser/MorningLangGrammar.h"
+
+namespace {
+    /**
+     * @brief Get position after the comment starting at pos, or pos if there is none
+     */
+    auto skip_comment(const std::string& source, size_t pos) -> size_t {
+        if (source.compare(pos, 2, "//") == 0) {
+            const auto END = source.find('\n', pos);
+            return END == std::string::npos ? source.size() : END;
+        }
+
+        if (source.compare(pos, 2, "/*") == 0) {
+            const auto END = source.find("*/", pos + 2);
+            return END == std::string::npos ? source.size() : END + 2;
+        }
+
+        return pos;
+    }
+
+    /**
+     * @brief Get position after the string literal starting at pos
+     */
+    auto skip_string(const std::string& source, size_t pos) -> size_t {
+        for (size_t i = pos + 1; i < source.size(); ++i) {
+            if (source[i] == '\\') {
+                ++i;
+            } else if (source[i] == '"') {
+                return i + 1;
+            }
+        }
+        return source.size();
+    }
+}    // namespace
+
+auto split_top_level_forms(const std::string& source) -> std::vector<source_form> {
+    std::vector<source_form> forms;
+    size_t depth = 0;
+    size_t start = 0;
+    size_t pos = 0;
+
+    while (pos < source.size()) {
+        const auto AFTER_COMMENT = skip_comment(source, pos);
+        if (AFTER_COMMENT != pos) {
+            pos = AFTER_COMMENT;
+            continue;
+        }
+
+        const char c = source[pos];
+
+        if (depth == 0 && std::isspace(static_cast<unsigned char>(c)) == 0) {
+            forms.emplace_back();
+            start = pos;
+        }
+
+        if (c == '"') {
+            pos = skip_string(source, pos);
+        } else if (c == '[' || c == '(') {
+            ++depth;
+            ++pos;
+        } else if (c == ']' || c == ')') {
+            depth = depth == 0 ? 0 : depth - 1;
+            ++pos;
+        } else if (syntax::lex::isSymbol(c)) {
+            const auto BEGIN = pos;
+            while (pos < source.size() && syntax::lex::isSymbol(source[pos])) {
+                ++pos;
+            }
+            forms.back().symbols.push_back(source.substr(BEGIN, pos - BEGIN));
+        } else {
+            ++pos;
+        }
+
+        if (depth == 0 && !forms.empty() && forms.back().text.empty() && pos > start) {
+            forms.back().text = source.substr(start, pos - start);
+        }
+    }
+
+    if (!forms.empty() && forms.back().text.empty()) {
+        forms.back().text = source.substr(start);
+    }
+
+    for (auto& form : forms) {
+        const char OPEN = form.text[0];
+        if ((OPEN == '[' || OPEN == '(') && form.symbols.size() > 1 && form.symbols[0] == "func"
+            && form.text.compare(1, 4, "func") == 0)
+        {
+            form.function = form.symbols[1];
+        }
+    }
+
+    return forms;
+}
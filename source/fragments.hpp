@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Top-level form of a source file
+ */
+struct source_form {
+    std::string text;    ///< Source text of the form
+    std::string function;    ///< Function name if the form is [func name ...], empty otherwise
+    std::vector<std::string> symbols;    ///< Symbols the form mentions, in source order
+};
+
+/**
+ * @brief Split source into its top-level forms without parsing it
+ *
+ * A bracket scan that skips comments and string literals, fast enough to
+ * run on every build of a large file. Syntax errors are left for the
+ * parser: unbalanced brackets only make the last form run to the end.
+ *
+ * @param source MorningLang source code
+ * @return std::vector<source_form> Forms in source order
+ */
+auto split_top_level_forms(const std::string& source) -> std::vector<source_form>;
@@ -188,8 +188,8 @@ auto InputParser::handle_regular_option(const std::string& token, int& index, in
         if (index + 1 >= argc) {
             m_ERRORS.push_back("Missing argument for: " + token);
         } else {
+            // The caller's increment then moves past the value
             m_PARSED_VALUES[*idx] = argv[++index];
-            advance_index = false; // Already advanced index
         }
     } else {
         m_PARSED_VALUES[*idx] = "";
@@ -0,0 +1,97 @@
+#include "jit.hpp"
+
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/TargetSelect.h>
+
+#include "logger.hpp"
+#include "morningllvm.hpp"
+
+namespace {
+    template <typename Builder>
+    auto create_jit(llvm::orc::JITTargetMachineBuilder target_builder)
+        -> llvm::Expected<std::unique_ptr<llvm::orc::LLJIT>> {
+        return Builder().setJITTargetMachineBuilder(std::move(target_builder)).create();
+    }
+}    // namespace
+
+jit_runner::jit_runner(bool lazy)
+    : m_LAZY(lazy) {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+
+    auto target_builder = llvm::orc::JITTargetMachineBuilder::detectHost();
+    if (!target_builder) {
+        LOG_ERROR("Cannot detect host: %s", llvm::toString(target_builder.takeError()).c_str());
+        return;
+    }
+
+    auto target_machine = target_builder->createTargetMachine();
+    if (!target_machine) {
+        LOG_ERROR("Cannot create target machine: %s", llvm::toString(target_machine.takeError()).c_str());
+        return;
+    }
+    m_TARGET_MACHINE = std::move(*target_machine);
+
+    auto jit = lazy ? create_jit<llvm::orc::LLLazyJITBuilder>(std::move(*target_builder))
+                    : create_jit<llvm::orc::LLJITBuilder>(std::move(*target_builder));
+    if (!jit) {
+        LOG_ERROR("Cannot create JIT: %s", llvm::toString(jit.takeError()).c_str());
+        return;
+    }
+
+    auto process_symbols = llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+        (*jit)->getDataLayout().getGlobalPrefix());
+    if (!process_symbols) {
+        LOG_ERROR("Cannot resolve host symbols: %s", llvm::toString(process_symbols.takeError()).c_str());
+        return;
+    }
+
+    (*jit)->getMainJITDylib().addGenerator(std::move(*process_symbols));
+    m_JIT = std::move(*jit);
+}
+
+void jit_runner::set_optimization_level(llvm::OptimizationLevel level) {
+    if (m_JIT == nullptr) {
+        return;
+    }
+
+    m_JIT->getIRTransformLayer().setTransform(
+        [this, level](llvm::orc::ThreadSafeModule module, const llvm::orc::MaterializationResponsibility&)
+            -> llvm::Expected<llvm::orc::ThreadSafeModule> {
+            module.withModuleDo([&](llvm::Module& unit) {
+                MorningLanguageLLVM::optimize_module(unit, level, m_TARGET_MACHINE.get());
+            });
+            return module;
+        });
+}
+
+auto jit_runner::load(llvm::orc::ThreadSafeModule module) -> bool {
+    if (m_JIT == nullptr) {
+        return false;
+    }
+
+    auto err = m_LAZY ? static_cast<llvm::orc::LLLazyJIT&>(*m_JIT).addLazyIRModule(std::move(module))
+                      : m_JIT->addIRModule(std::move(module));
+    if (err) {
+        LOG_ERROR("Cannot add module to JIT: %s", llvm::toString(std::move(err)).c_str());
+        return false;
+    }
+
+    return true;
+}
+
+auto jit_runner::lookup(const std::string& name) -> entry_point {
+    if (m_JIT == nullptr) {
+        return nullptr;
+    }
+
+    auto symbol = m_JIT->lookup(name);
+    if (!symbol) {
+        LOG_ERROR("Cannot find \"%s\": %s", name.c_str(), llvm::toString(symbol.takeError()).c_str());
+        return nullptr;
+    }
+
+    return symbol->toPtr<entry_point>();
+}
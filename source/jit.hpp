@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Target/TargetMachine.h>
+
+/**
+ * @brief Runs generated modules in-process with ORC LLJIT
+ *
+ * External symbols (printf, scanf, malloc, free, ...) are resolved
+ * from the host process. In lazy mode functions are compiled on their
+ * first call through ORC reexport stubs.
+ */
+class jit_runner {
+public:
+    using entry_point = int64_t (*)();    ///< Signature of generated main
+
+    /**
+     * @brief Create JIT for host target
+     *
+     * @param lazy Compile functions on first call (LLLazyJIT)
+     */
+    explicit jit_runner(bool lazy = false);
+
+    /**
+     * @brief Check if JIT was created
+     */
+    auto is_available() const -> bool { return m_JIT != nullptr; }
+
+    /**
+     * @brief Get target machine matching the JIT (for optimization)
+     */
+    auto get_target_machine() -> llvm::TargetMachine* { return m_TARGET_MACHINE.get(); }
+
+    /**
+     * @brief Optimize modules when they are materialized
+     *
+     * In lazy mode only functions that are actually called get optimized.
+     *
+     * @param level Optimization level
+     */
+    void set_optimization_level(llvm::OptimizationLevel level);
+
+    /**
+     * @brief Add module to JIT
+     *
+     * @param module Module with its context
+     * @return true if module was added
+     */
+    auto load(llvm::orc::ThreadSafeModule module) -> bool;
+
+    /**
+     * @brief Materialize function and get its address
+     *
+     * @param name Function name
+     * @return entry_point Function pointer or nullptr
+     */
+    auto lookup(const std::string& name) -> entry_point;
+
+private:
+    std::unique_ptr<llvm::orc::LLJIT> m_JIT;    ///< LLLazyJIT in lazy mode
+    bool m_LAZY;
+    std::unique_ptr<llvm::TargetMachine> m_TARGET_MACHINE;
+};
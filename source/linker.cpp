@@ -0,0 +1,245 @@
+#include "linker.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#    include <sys/mman.h>
+#    include <unistd.h>
+#endif
+
+#include <lld/Common/Driver.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "logger.hpp"
+
+LLD_HAS_DRIVER(elf)
+
+namespace fs = std::filesystem;
+
+namespace {
+    const std::vector<std::string> CRT_DIRS = {
+        "/usr/lib/x86_64-linux-gnu",
+        "/usr/lib64",
+        "/usr/lib",
+        "/lib/x86_64-linux-gnu",
+        "/lib64",
+    };
+
+    const std::vector<std::string> DYNAMIC_LINKERS = {
+        "/lib64/ld-linux-x86-64.so.2",
+        "/lib/x86_64-linux-gnu/ld-linux-x86-64.so.2",
+        "/lib/ld-linux-x86-64.so.2",
+    };
+
+    const std::vector<std::string> GCC_ROOTS = {
+        "/usr/lib/gcc/x86_64-linux-gnu",
+        "/usr/lib/gcc/x86_64-pc-linux-gnu",
+        "/usr/lib/gcc/x86_64-redhat-linux",
+        "/usr/lib64/gcc/x86_64-suse-linux",
+    };
+
+    /**
+     * @brief Compare dotted version strings numerically ("12" < "12.2.0" < "13")
+     */
+    auto version_less(const std::string& left, const std::string& right) -> bool {
+        auto split = [](const std::string& version) {
+            std::vector<long> parts;
+            size_t pos = 0;
+            while (pos < version.size()) {
+                size_t dot = version.find('.', pos);
+                parts.push_back(std::strtol(version.substr(pos, dot - pos).c_str(), nullptr, 10));
+                if (dot == std::string::npos) {
+                    break;
+                }
+                pos = dot + 1;
+            }
+            return parts;
+        };
+
+        return split(left) < split(right);
+    }
+
+    auto has_files(const std::string& dir, const std::vector<std::string>& files) -> bool {
+        std::error_code err_code;
+        return std::all_of(files.begin(), files.end(), [&](const std::string& file) {
+            return fs::exists(fs::path(dir) / file, err_code);
+        });
+    }
+}    // namespace
+
+lld_linker::lld_linker() {
+    find_runtime();
+}
+
+void lld_linker::find_runtime() {
+    for (const auto& dir : CRT_DIRS) {
+        if (has_files(dir, {"Scrt1.o", "crti.o", "crtn.o"})) {
+            m_CRT_DIR = dir;
+            break;
+        }
+    }
+
+    for (const auto& dir : CRT_DIRS) {
+        if (has_files(dir, {"libc.so"})) {
+            m_LIBC_DIR = dir;
+            break;
+        }
+    }
+
+    for (const auto& path : DYNAMIC_LINKERS) {
+        std::error_code err_code;
+        if (fs::exists(path, err_code)) {
+            m_DYNAMIC_LINKER = path;
+            break;
+        }
+    }
+
+    std::string best_version;
+    for (const auto& root : GCC_ROOTS) {
+        std::error_code err_code;
+        if (!fs::is_directory(root, err_code)) {
+            continue;
+        }
+
+        for (const auto& entry : fs::directory_iterator(root, err_code)) {
+            const std::string VERSION = entry.path().filename().string();
+            if (has_files(entry.path().string(), {"crtbeginS.o", "crtendS.o"})
+                && (best_version.empty() || version_less(best_version, VERSION)))
+            {
+                best_version = VERSION;
+                m_GCC_DIR = entry.path().string();
+            }
+        }
+    }
+
+    if (m_CRT_DIR.empty() || m_DYNAMIC_LINKER.empty()) {
+        LOG_WARN("C runtime not found, native linking is unavailable");
+    } else if (m_GCC_DIR.empty()) {
+        LOG_WARN("crtbeginS.o/crtendS.o not found, linking without them");
+    }
+}
+
+auto lld_linker::link(const std::vector<std::string>& object_files, const std::string& output_filename) -> bool {
+    if (!is_available()) {
+        LOG_ERROR("Cannot link \"%s\": C runtime not found", output_filename.c_str());
+        return false;
+    }
+
+    const fs::path CRT_DIR(m_CRT_DIR);
+    const fs::path GCC_DIR(m_GCC_DIR);
+
+    std::vector<std::string> args = {
+        "ld.lld",
+        "--eh-frame-hdr",
+        "-pie",
+        "-dynamic-linker",
+        m_DYNAMIC_LINKER,
+        "-o",
+        output_filename,
+        (CRT_DIR / "Scrt1.o").string(),
+        (CRT_DIR / "crti.o").string(),
+    };
+
+    if (!m_GCC_DIR.empty()) {
+        args.push_back((GCC_DIR / "crtbeginS.o").string());
+        args.push_back("-L" + m_GCC_DIR);
+    }
+
+    args.push_back("-L" + m_CRT_DIR);
+    if (!m_LIBC_DIR.empty() && m_LIBC_DIR != m_CRT_DIR) {
+        args.push_back("-L" + m_LIBC_DIR);
+    }
+
+    args.insert(args.end(), object_files.begin(), object_files.end());
+    args.push_back("-lc");
+
+    if (!m_GCC_DIR.empty()) {
+        args.push_back("-lgcc");
+        args.push_back((GCC_DIR / "crtendS.o").string());
+    }
+
+    args.push_back((CRT_DIR / "crtn.o").string());
+
+    std::vector<const char*> argv;
+    argv.reserve(args.size());
+    for (const auto& arg : args) {
+        argv.push_back(arg.c_str());
+    }
+
+    lld::Result result = lld::lldMain(argv, llvm::outs(), llvm::errs(), {{lld::Gnu, &lld::elf::link}});
+
+    if (!result.canRunAgain) {
+        LOG_WARN("lld state could not be reset, further links in this process are unsafe");
+    }
+
+    return result.retCode == 0;
+}
+
+auto lld_linker::link_buffer(llvm::ArrayRef<char> object, const std::string& output_filename) -> bool {
+    return link_buffers({object}, output_filename);
+}
+
+auto lld_linker::link_buffers(const std::vector<llvm::ArrayRef<char>>& objects, const std::string& output_filename)
+    -> bool {
+    std::vector<std::string> object_files;
+    std::vector<int> memory_fds;
+    std::vector<std::string> temp_files;
+    bool written = true;
+
+    for (size_t i = 0; i < objects.size() && written; ++i) {
+        const auto& object = objects[i];
+
+#ifdef __linux__
+        int memory_fd = memfd_create("morning-object", MFD_CLOEXEC);
+        if (memory_fd >= 0) {
+            memory_fds.push_back(memory_fd);
+
+            const char* data = object.data();
+            size_t remaining = object.size();
+            while (remaining > 0) {
+                ssize_t count = write(memory_fd, data, remaining);
+                if (count <= 0) {
+                    break;
+                }
+                data += count;
+                remaining -= static_cast<size_t>(count);
+            }
+
+            written = remaining == 0;
+            object_files.push_back("/proc/self/fd/" + std::to_string(memory_fd));
+            continue;
+        }
+#endif
+
+        const std::string OBJECT_FILE =
+            objects.size() == 1 ? output_filename + ".o" : output_filename + "." + std::to_string(i) + ".o";
+        std::ofstream object_file(OBJECT_FILE, std::ios::binary);
+        object_file.write(object.data(), static_cast<std::streamsize>(object.size()));
+        temp_files.push_back(OBJECT_FILE);
+        object_files.push_back(OBJECT_FILE);
+
+        if (!object_file) {
+            LOG_ERROR("Cannot write object file \"%s\"", OBJECT_FILE.c_str());
+            written = false;
+        }
+    }
+
+    bool status = written && link(object_files, output_filename);
+
+#ifdef __linux__
+    for (int memory_fd : memory_fds) {
+        close(memory_fd);
+    }
+#endif
+    for (const auto& temp_file : temp_files) {
+        std::error_code err_code;
+        fs::remove(temp_file, err_code);
+    }
+
+    return status;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/StringRef.h>
+
+/**
+ * @brief In-process ELF linker on top of lld
+ *
+ * Locates the C runtime (crt objects, libc and the dynamic loader) once
+ * on construction and links object files into an executable without
+ * spawning a compiler driver.
+ */
+class lld_linker {
+public:
+    lld_linker();
+
+    /**
+     * @brief Check if C runtime files were found
+     */
+    auto is_available() const -> bool { return !m_CRT_DIR.empty() && !m_DYNAMIC_LINKER.empty(); }
+
+    /**
+     * @brief Link object files from disk into executable
+     *
+     * @param object_files Object files to link
+     * @param output_filename Executable name
+     * @return true if linking succeeded
+     */
+    auto link(const std::vector<std::string>& object_files, const std::string& output_filename) -> bool;
+
+    /**
+     * @brief Link in-memory object into executable
+     *
+     * The object is handed to lld through an anonymous memory file where
+     * the platform supports it, otherwise through a temporary file.
+     *
+     * @param object Object file contents
+     * @param output_filename Executable name
+     * @return true if linking succeeded
+     */
+    auto link_buffer(llvm::ArrayRef<char> object, const std::string& output_filename) -> bool;
+
+    /**
+     * @brief Link several in-memory objects into one executable
+     *
+     * @param objects Contents of every object file, in link order
+     * @param output_filename Executable name
+     * @return true if linking succeeded
+     */
+    auto link_buffers(const std::vector<llvm::ArrayRef<char>>& objects, const std::string& output_filename) -> bool;
+
+private:
+    std::string m_CRT_DIR;    ///< Directory with Scrt1.o, crti.o, crtn.o
+    std::string m_GCC_DIR;    ///< Directory with crtbeginS.o, crtendS.o and libgcc (optional)
+    std::string m_LIBC_DIR;    ///< Directory with libc
+    std::string m_DYNAMIC_LINKER;    ///< Path to the program interpreter
+
+    void find_runtime();
+};
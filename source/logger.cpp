@@ -2,25 +2,33 @@
 #include <sstream>
 #include <iomanip>
 
-thread_local std::vector<std::pair<std::string, std::string>> Logger::expression_stack_;
+thread_local std::array<const Exp*, Logger::TRACEBACK_LIMIT> Logger::expression_ring_ {};
+thread_local size_t Logger::expression_count_ = 0;
+thread_local bool Logger::recoverable_ = false;
+std::atomic<Logger::ExpressionRenderer> Logger::expression_renderer_ {nullptr};
+Logger::Level Logger::min_level_ = Logger::Level::NOTE;
 
-void Logger::push_expression(const std::string& context, const std::string& expr) {
-    expression_stack_.emplace_back(context, expr);
-    if (expression_stack_.size() > MAX_STACK_SIZE) {
-        expression_stack_.erase(expression_stack_.begin());
-    }
+void Logger::clear_expressions() {
+    expression_count_ = 0;
+}
+
+void Logger::set_expression_renderer(ExpressionRenderer renderer) {
+    expression_renderer_ = renderer;
 }
 
 void Logger::print_traceback() {
-    if (expression_stack_.empty()) return;
+    const ExpressionRenderer RENDERER = expression_renderer_.load();
+    if (expression_count_ == 0 || RENDERER == nullptr) return;
 
     std::fprintf(stderr, "%sExpressions traceback:%s\n", BOLD, RESET_STYLE);
 
-    size_t start = expression_stack_.size() > TRACEBACK_LIMIT ?
-        expression_stack_.size() - TRACEBACK_LIMIT : 0;
+    size_t start = expression_count_ > TRACEBACK_LIMIT ?
+        expression_count_ - TRACEBACK_LIMIT : 0;
+
+    for (size_t i = start; i < expression_count_; ++i) {
+        const auto [ctx, expr] = RENDERER(expression_ring_[i % TRACEBACK_LIMIT]);
+        if (expr.empty()) continue;
 
-    for (size_t i = start; i < expression_stack_.size(); ++i) {
-        const auto& [ctx, expr] = expression_stack_[i];
         std::fprintf(stderr, "    %s%-8s%s %s\n",
                      CYAN_COLOR, ctx.c_str(), RESET_STYLE, expr.c_str());
     }
@@ -1,13 +1,28 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdio>
 #include <cstdlib>
+#include <stdexcept>
 #include <string>
-#include <vector>
 #include <utility>
 
 #include "_default.hpp"
 
+// Lowest level compiled in, as an index into Logger::Level; lower levels cost nothing
+#ifndef MORNING_LOG_LEVEL
+#    define MORNING_LOG_LEVEL 0
+#endif
+
+struct Exp;
+
+// Thrown by CRITICAL messages instead of exiting while errors are recoverable
+class compile_error : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
 class Logger {
 public:
     enum class Level {
@@ -19,6 +34,10 @@ public:
         CRITICAL
     };
 
+    // Runtime threshold on top of MORNING_LOG_LEVEL, CRITICAL is always reported
+    static void set_level(Level level) { min_level_ = level; }
+    static auto is_enabled(Level level) -> bool { return level >= min_level_; }
+
     // Шаблонные методы остаются в заголовке
     template <typename... Args>
     static void log(Level level, const char* format, Args... args) {
@@ -27,37 +46,83 @@ public:
 
         if (level == Level::CRITICAL) {
             print_traceback();
+            if (recoverable_) {
+                throw compile_error(formatted);
+            }
             std::exit(EXIT_FAILURE);
         }
     }
 
-    static void push_expression(const std::string& context, const std::string& expr);
+    // While alive, CRITICAL messages on this thread throw compile_error, so the caller can drop the failed input
+    class recoverable_errors {
+    public:
+        recoverable_errors() : previous_(recoverable_) { recoverable_ = true; }
+        ~recoverable_errors() { recoverable_ = previous_; }
+
+        recoverable_errors(const recoverable_errors&) = delete;
+        auto operator=(const recoverable_errors&) -> recoverable_errors& = delete;
+
+    private:
+        bool previous_;
+    };
+
+    // Turns a traceback entry into its (context, text) pair; empty text skips the entry
+    using ExpressionRenderer = std::pair<std::string, std::string> (*)(const Exp* exp);
+
+    // Only the pointer is recorded, text is rendered when a traceback is printed
+    static void push_expression(const Exp* exp) {
+        expression_ring_[expression_count_ % TRACEBACK_LIMIT] = exp;
+        ++expression_count_;
+    }
+
+    // Must be called before the expressions recorded so far are freed
+    static void clear_expressions();
+    static void set_expression_renderer(ExpressionRenderer renderer);
     static void print_traceback();
 
 private:
-    static const constexpr size_t MAX_STACK_SIZE = 100;
     static const constexpr size_t TRACEBACK_LIMIT = 15;
-    static thread_local std::vector<std::pair<std::string, std::string>> expression_stack_;
+    static thread_local std::array<const Exp*, TRACEBACK_LIMIT> expression_ring_;
+    static thread_local size_t expression_count_;
+    static thread_local bool recoverable_;
+    static std::atomic<ExpressionRenderer> expression_renderer_;    ///< Set by every compiler, also from worker threads
+    static Level min_level_;
 
     // Приватный шаблонный метод
     template <typename... Args>
     static auto format_message(const char* format, Args... args) -> std::string {
-        int size = std::snprintf(nullptr, 0, format, args...);
+        // Most messages fit on the stack, so they are formatted only once
+        std::array<char, 256> buf;
+        int size = std::snprintf(buf.data(), buf.size(), format, args...);
         if (size < 0) return "";
 
-        std::vector<char> buf(size + 1);
-        std::snprintf(buf.data(), buf.size(), format, args...);
-        return std::string(buf.data());
+        if (static_cast<size_t>(size) < buf.size()) {
+            return std::string(buf.data(), static_cast<size_t>(size));
+        }
+
+        std::string message(static_cast<size_t>(size), '\0');
+        std::snprintf(message.data(), message.size() + 1, format, args...);
+        return message;
     }
 
     static void print_log(Level level, const std::string& message);
 };
 
-#define LOG_NOTE(...)    Logger::log(Logger::Level::NOTE, __VA_ARGS__)
-#define LOG_DEBUG(...)   Logger::log(Logger::Level::DEBUG, __VA_ARGS__)
-#define LOG_INFO(...)    Logger::log(Logger::Level::INFO, __VA_ARGS__)
-#define LOG_WARN(...)    Logger::log(Logger::Level::WARNING, __VA_ARGS__)
-#define LOG_ERROR(...)   Logger::log(Logger::Level::ERROR, __VA_ARGS__)
+// Filtered levels never evaluate their arguments
+#define LOG_AT_LEVEL(level, ...) \
+    do { \
+        if constexpr (static_cast<int>(level) >= MORNING_LOG_LEVEL) { \
+            if (Logger::is_enabled(level)) { \
+                Logger::log(level, __VA_ARGS__); \
+            } \
+        } \
+    } while (false)
+
+#define LOG_NOTE(...)    LOG_AT_LEVEL(Logger::Level::NOTE, __VA_ARGS__)
+#define LOG_DEBUG(...)   LOG_AT_LEVEL(Logger::Level::DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)    LOG_AT_LEVEL(Logger::Level::INFO, __VA_ARGS__)
+#define LOG_WARN(...)    LOG_AT_LEVEL(Logger::Level::WARNING, __VA_ARGS__)
+#define LOG_ERROR(...)   LOG_AT_LEVEL(Logger::Level::ERROR, __VA_ARGS__)
 #define LOG_CRITICAL(...) Logger::log(Logger::Level::CRITICAL, __VA_ARGS__)
 
-#define PUSH_EXPR_STACK(ctx, expr) Logger::push_expression(ctx, expr)
+#define PUSH_EXPR_STACK(exp) Logger::push_expression(exp)
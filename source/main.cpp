@@ -1,21 +1,57 @@
 #include <algorithm>
+#include <chrono>
 #include <string>
 #include <fstream>
 #include <iostream>
 #include "morningllvm.hpp"
 #include <cstdlib>
+#include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <filesystem>
 #include <vector>
 #include <optional>
 #include <sstream>
+#include <atomic>
+#include <functional>
+#include <thread>
 
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Support/CodeGen.h>
+
+#include "cache.hpp"
+#include "compiler.hpp"
+#include "fragments.hpp"
+#include "jit.hpp"
+#include "linker.hpp"
+#include "repl.hpp"
 #include "logger.hpp"
 #include "input_parser.hpp"
+#include "time_report.hpp"
 
 namespace fs = std::filesystem;
 
 namespace {
+    /**
+     * @brief Linker used to produce executables
+     */
+    enum class LinkerKind {
+        LLD,      ///< In-process lld, object is never written to disk
+        CLANG     ///< External clang++ driver on an object file
+    };
+
+    /**
+     * @brief Artifact a build produces
+     */
+    enum class EmitKind {
+        EXECUTABLE,    ///< Linked binary
+        OBJECT,        ///< Native object file, .o
+        ASSEMBLY,      ///< Native assembly, .s
+        BITCODE,       ///< LLVM bitcode, .bc
+        IR             ///< Textual LLVM IR, .ll
+    };
+
     /**
      * @brief Check if util is available (cross-platform)
      */
@@ -55,53 +91,327 @@ namespace {
     }
 
     /**
-     * @brief Compile generated IR to binary
+     * @brief Parse optimization level name (0, 1, 2, 3, s)
      */
-    auto compile_ir(const std::string& output_base) -> bool {
-        const std::string ll_file = output_base + ".ll";
-        const std::string opt_ll_file = output_base + "-opt.ll";
-        const std::string bin_file = output_base;
+    auto parse_opt_level(const std::string& name) -> std::optional<llvm::OptimizationLevel> {
+        if (name == "0") return llvm::OptimizationLevel::O0;
+        if (name == "1") return llvm::OptimizationLevel::O1;
+        if (name == "2") return llvm::OptimizationLevel::O2;
+        if (name == "3") return llvm::OptimizationLevel::O3;
+        if (name == "s") return llvm::OptimizationLevel::Os;
+        return std::nullopt;
+    }
 
-        if (!fs::exists(ll_file)) {
-            LOG_ERROR("IR code not found");
-            return false;
+    /**
+     * @brief Map optimization level to backend code generation level
+     */
+    auto to_codegen_opt_level(llvm::OptimizationLevel level) -> llvm::CodeGenOptLevel {
+        if (level == llvm::OptimizationLevel::O0) return llvm::CodeGenOptLevel::None;
+        if (level == llvm::OptimizationLevel::O1) return llvm::CodeGenOptLevel::Less;
+        if (level == llvm::OptimizationLevel::O3) return llvm::CodeGenOptLevel::Aggressive;
+        return llvm::CodeGenOptLevel::Default;
+    }
+
+    /**
+     * @brief Parse log level name (note, debug, info, warning, error)
+     */
+    auto parse_log_level(const std::string& name) -> std::optional<Logger::Level> {
+        if (name == "note") return Logger::Level::NOTE;
+        if (name == "debug") return Logger::Level::DEBUG;
+        if (name == "info") return Logger::Level::INFO;
+        if (name == "warning") return Logger::Level::WARNING;
+        if (name == "error") return Logger::Level::ERROR;
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Parse linker name (lld, clang)
+     */
+    auto parse_linker(const std::string& name) -> std::optional<LinkerKind> {
+        if (name == "lld") return LinkerKind::LLD;
+        if (name == "clang") return LinkerKind::CLANG;
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Name of the link phase in --time-report, e.g. "link (lld)"
+     */
+    auto link_phase_name(LinkerKind linker) -> std::string {
+        return linker == LinkerKind::LLD ? "link (lld)" : "link (clang)";
+    }
+
+    /**
+     * @brief Parse output kind name (exe, obj, asm, bc, ll)
+     */
+    auto parse_emit_kind(const std::string& name) -> std::optional<EmitKind> {
+        if (name == "exe") return EmitKind::EXECUTABLE;
+        if (name == "obj") return EmitKind::OBJECT;
+        if (name == "asm") return EmitKind::ASSEMBLY;
+        if (name == "bc") return EmitKind::BITCODE;
+        if (name == "ll") return EmitKind::IR;
+        return std::nullopt;
+    }
+
+    /**
+     * @brief File extension of artifact, empty for executables
+     */
+    auto emit_extension(EmitKind kind) -> std::string {
+        switch (kind) {
+            case EmitKind::OBJECT: return ".o";
+            case EmitKind::ASSEMBLY: return ".s";
+            case EmitKind::BITCODE: return ".bc";
+            case EmitKind::IR: return ".ll";
+            default: return "";
         }
+    }
 
-        std::string opt_cmd = "opt " + safe_path(ll_file) +
-                              " -O3 -S -o " + safe_path(opt_ll_file);
+    /**
+     * @brief Check if artifact is written from the optimized module instead of an object
+     */
+    auto is_module_artifact(EmitKind kind) -> bool {
+        return kind == EmitKind::ASSEMBLY || kind == EmitKind::BITCODE || kind == EmitKind::IR;
+    }
 
-        LOG_INFO("Optimizing code...");
+    /**
+     * @brief Write optimized module as assembly, bitcode or textual IR
+     */
+    auto write_module_artifact(MorningLanguageLLVM& morning_vm,
+                               llvm_compiler& backend,
+                               EmitKind kind,
+                               const std::string& filename) -> bool {
+        bool written = false;
+        switch (kind) {
+            case EmitKind::ASSEMBLY:
+                written = backend.compile_module_to_assembly_file(morning_vm.get_module(), filename);
+                break;
+            case EmitKind::BITCODE:
+                written = morning_vm.save_module_to_bitcode(filename);
+                break;
+            case EmitKind::IR:
+                morning_vm.save_module_to_file(filename);
+                written = fs::exists(filename);
+                break;
+            default:
+                break;
+        }
 
-        if (execute_command(opt_cmd) != 0) {
-            LOG_ERROR("Code optimization failed");
-            std::cout << "Command: " << opt_cmd << "\n";
-            execute_command(opt_cmd, false);
-            return false;
+        if (!written) {
+            LOG_ERROR("Cannot write \"%s\"", filename.c_str());
         }
+        return written;
+    }
+
+    /**
+     * @brief Milliseconds elapsed since start
+     */
+    auto elapsed_ms(std::chrono::steady_clock::time_point start) -> double {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
 
-        if (!fs::exists(opt_ll_file) || fs::file_size(opt_ll_file) == 0) {
-            LOG_ERROR("Optimized IR code not created");
+    /**
+     * @brief Check that binary file was created
+     */
+    auto check_binary(const std::string& bin_file) -> bool {
+        if (!fs::exists(bin_file) || fs::file_size(bin_file) == 0) {
+            LOG_ERROR("Binary file \"%s\" not created", bin_file.c_str());
             return false;
         }
+        return true;
+    }
 
-        std::string clang_cmd = "clang++ -O3 " + safe_path(opt_ll_file) +
-                                " -o " + safe_path(bin_file);
+    /**
+     * @brief Link object files to binary
+     */
+    auto link_object(const std::vector<std::string>& obj_files, const std::string& bin_file) -> bool {
+        std::string clang_cmd = "clang++";
+        for (const auto& obj_file : obj_files) {
+            clang_cmd += " " + safe_path(obj_file);
+        }
+        clang_cmd += " -o " + safe_path(bin_file);
 
-        LOG_INFO("Compiling optimized code...");
+        LOG_INFO("Linking binary...");
 
         if (execute_command(clang_cmd) != 0) {
-            LOG_ERROR("Binary compilation failed");
+            LOG_ERROR("Binary linking failed");
             std::cout << "Command: " << clang_cmd << "\n";
             execute_command(clang_cmd, false);
             return false;
         }
 
-        if (!fs::exists(bin_file) || fs::file_size(bin_file) == 0) {
-            LOG_ERROR("Binary file \"%s\" not created", bin_file.c_str());
+        return check_binary(bin_file);
+    }
+
+    /**
+     * @brief Link in-memory object to binary with lld
+     */
+    auto link_object_buffer(llvm::ArrayRef<char> object, const std::string& bin_file) -> bool {
+        LOG_INFO("Linking binary...");
+
+        lld_linker linker;
+        if (!linker.link_buffer(object, bin_file)) {
+            LOG_ERROR("Binary linking failed");
             return false;
         }
 
-        return true;
+        return check_binary(bin_file);
+    }
+
+    /**
+     * @brief Prints and saves the time report when it goes out of scope
+     */
+    class time_report_output {
+    public:
+        time_report_output(const time_report& report, bool print, std::optional<std::string> json_file)
+            : m_REPORT(report)
+            , m_PRINT(print)
+            , m_JSON_FILE(std::move(json_file)) {}
+
+        ~time_report_output() {
+            if (m_PRINT) {
+                m_REPORT.print(std::cerr);
+            }
+            if (m_JSON_FILE && !m_REPORT.write_json(*m_JSON_FILE)) {
+                LOG_ERROR("Cannot write time report to \"%s\"", m_JSON_FILE->c_str());
+            }
+        }
+
+        time_report_output(const time_report_output&) = delete;
+        auto operator=(const time_report_output&) -> time_report_output& = delete;
+
+    private:
+        const time_report& m_REPORT;
+        bool m_PRINT;
+        std::optional<std::string> m_JSON_FILE;
+    };
+
+    /**
+     * @brief Optimize generated module in-process and compile it to binary
+     */
+    auto compile_ir(MorningLanguageLLVM& morning_vm,
+                    const std::string& output_base,
+                    llvm::OptimizationLevel level,
+                    LinkerKind linker,
+                    bool keep_temps,
+                    EmitKind emit,
+                    time_report* report) -> bool {
+        const std::string obj_file = output_base + ".o";
+        const std::string bin_file = output_base;
+
+        llvm_compiler backend;
+        if (backend.get_target_machine() == nullptr) {
+            LOG_ERROR("Native target is not available");
+            return false;
+        }
+        backend.set_opt_level(to_codegen_opt_level(level));
+
+        LOG_INFO("Optimizing code...");
+        morning_vm.optimize(level, backend.get_target_machine());
+
+        if (keep_temps) {
+            morning_vm.save_module_to_file(output_base + ".ll");
+        }
+
+        // Bitcode, assembly and IR come straight from the optimized module
+        if (is_module_artifact(emit)) {
+            time_report::scoped_phase phase(report, "emit");
+            return write_module_artifact(morning_vm, backend, emit, output_base + emit_extension(emit));
+        }
+
+        LOG_INFO("Compiling optimized code...");
+
+        auto start = std::chrono::steady_clock::now();
+
+        // lld links straight from memory; the object file is only written
+        // when it is requested or the external driver needs it
+        if (linker == LinkerKind::LLD && emit == EmitKind::EXECUTABLE && !keep_temps) {
+            llvm::SmallVector<char, 0> object;
+            {
+                time_report::scoped_phase phase(report, "emit");
+                if (!backend.compile_module_to_buffer(morning_vm.get_module(), object)) {
+                    LOG_ERROR("Object code generation failed");
+                    return false;
+                }
+            }
+            LOG_DEBUG("Code generation: %.2f ms", elapsed_ms(start));
+
+            start = std::chrono::steady_clock::now();
+            time_report::scoped_phase phase(report, link_phase_name(linker));
+            if (!link_object_buffer(object, bin_file)) {
+                return false;
+            }
+            LOG_DEBUG("Linking (lld): %.2f ms", elapsed_ms(start));
+            return true;
+        }
+
+        {
+            time_report::scoped_phase phase(report, "emit");
+            if (!backend.compile_module_to_object_file(morning_vm.get_module(), obj_file)) {
+                LOG_ERROR("Object file compilation failed");
+                return false;
+            }
+        }
+        LOG_DEBUG("Code generation: %.2f ms", elapsed_ms(start));
+
+        if (emit == EmitKind::OBJECT) {
+            return true;
+        }
+
+        start = std::chrono::steady_clock::now();
+        time_report::scoped_phase phase(report, link_phase_name(linker));
+        bool linked = false;
+        if (linker == LinkerKind::LLD) {
+            lld_linker lld;
+            LOG_INFO("Linking binary...");
+            linked = lld.link({obj_file}, bin_file) && check_binary(bin_file);
+            if (!linked) {
+                LOG_ERROR("Binary linking failed");
+            }
+        } else {
+            linked = link_object({obj_file}, bin_file);
+        }
+        LOG_DEBUG("Linking (%s): %.2f ms", linker == LinkerKind::LLD ? "lld" : "clang", elapsed_ms(start));
+
+        return linked;
+    }
+
+    /**
+     * @brief Optimize generated module and run it with the JIT
+     *
+     * @return std::optional<int> Exit code of the program, nullopt on failure
+     */
+    auto run_jit(MorningLanguageLLVM& morning_vm,
+                 jit_runner& jit,
+                 llvm::OptimizationLevel level,
+                 std::chrono::steady_clock::time_point source_start,
+                 time_report* report) -> std::optional<int> {
+        if (!jit.is_available()) {
+            LOG_ERROR("JIT is not available");
+            return std::nullopt;
+        }
+
+        morning_vm.optimize(level, jit.get_target_machine());
+
+        jit_runner::entry_point entry = nullptr;
+        {
+            time_report::scoped_phase phase(report, "jit");
+            if (!jit.load(morning_vm.take_module())) {
+                return std::nullopt;
+            }
+
+            entry = jit.lookup("main");
+            if (entry == nullptr) {
+                return std::nullopt;
+            }
+        }
+
+        LOG_DEBUG("Source to first instruction: %.2f ms", elapsed_ms(source_start));
+        if (report != nullptr) {
+            report->set_counter("source_to_first_instr_us", static_cast<uint64_t>(elapsed_ms(source_start) * 1000));
+        }
+
+        auto exit_code = static_cast<int>(entry());
+        std::fflush(stdout);
+        return exit_code;
     }
 
     /**
@@ -119,15 +429,14 @@ namespace {
             }
         };
 
-        safe_remove(output_base + ".ll");
-        safe_remove(output_base + "-opt.ll");
+        safe_remove(output_base + ".o");
     }
 
     /**
      * @brief Check if all required utils are available
      */
     auto check_utils_available() -> bool {
-        const std::vector<std::string> REQUIRED_PROGS = {"opt", "clang++"};
+        const std::vector<std::string> REQUIRED_PROGS = {"clang++"};
 
         for (const auto& util : REQUIRED_PROGS) {
             if (!is_util_available(util)) {
@@ -138,6 +447,25 @@ namespace {
         return true;
     }
 
+    /**
+     * @brief Print cache usage summary
+     */
+    void print_cache_stats(const compilation_cache& cache) {
+        auto stats = cache.get_stats();
+        const double MEGABYTE = 1024.0 * 1024.0;
+        uint64_t lookups = stats.hits + stats.misses;
+
+        std::cout << "Cache directory: " << cache.get_directory().string() << "\n"
+                  << "Entries:         " << stats.entries << "\n"
+                  << "Size:            " << static_cast<double>(stats.total_size) / MEGABYTE << " MB / "
+                  << static_cast<double>(stats.size_limit) / MEGABYTE << " MB\n"
+                  << "Hits:            " << stats.hits << "\n"
+                  << "Misses:          " << stats.misses << "\n"
+                  << "Hit rate:        "
+                  << (lookups == 0 ? 0.0 : 100.0 * static_cast<double>(stats.hits) / static_cast<double>(lookups))
+                  << "%\n";
+    }
+
     /**
      * @brief Check if output name is valid
      */
@@ -149,6 +477,603 @@ namespace {
             return FORBIDDEN_CHARS.find(c) != std::string::npos;
         });
     }
+
+    /**
+     * @brief Read source file
+     */
+    auto read_source(const std::string& filename) -> std::optional<std::string> {
+        std::ifstream program_file(filename);
+        if (!program_file.is_open()) {
+            LOG_ERROR("Cannot open file \"%s\"", filename.c_str());
+            return std::nullopt;
+        }
+
+        std::stringstream buffer;
+        buffer << program_file.rdbuf();
+
+        if (buffer.str().empty()) {
+            LOG_ERROR("File \"%s\" is empty", filename.c_str());
+            return std::nullopt;
+        }
+        return buffer.str();
+    }
+
+    /**
+     * @brief Expand inputs to source files
+     *
+     * Directories contribute their .morning files, main.morning first and
+     * the rest in name order, so the entry unit of a directory is stable.
+     */
+    auto collect_inputs(const std::vector<std::string>& inputs) -> std::optional<std::vector<std::string>> {
+        std::vector<std::string> files;
+
+        for (const auto& input : inputs) {
+            if (!fs::exists(input)) {
+                LOG_ERROR("File \"%s\" not found", input.c_str());
+                return std::nullopt;
+            }
+
+            if (!fs::is_directory(input)) {
+                files.push_back(input);
+                continue;
+            }
+
+            std::vector<fs::path> sources;
+            for (const auto& entry : fs::directory_iterator(input)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".morning") {
+                    sources.push_back(entry.path());
+                }
+            }
+
+            std::sort(sources.begin(), sources.end(), [](const fs::path& lhs, const fs::path& rhs) {
+                const bool LHS_MAIN = lhs.filename() == "main.morning";
+                const bool RHS_MAIN = rhs.filename() == "main.morning";
+                return LHS_MAIN != RHS_MAIN ? LHS_MAIN : lhs < rhs;
+            });
+
+            if (sources.empty()) {
+                LOG_ERROR("Directory \"%s\" has no .morning files", input.c_str());
+                return std::nullopt;
+            }
+            for (const auto& source : sources) {
+                files.push_back(source.string());
+            }
+        }
+
+        return files;
+    }
+
+    /**
+     * @brief One module of a multi-file build and what its worker produced
+     */
+    struct compile_unit {
+        std::string filename;
+        std::string module;    ///< File stem, the name other units import it by
+        std::string source;
+        std::vector<size_t> imports;    ///< Indices of imported units
+        llvm::SmallVector<char, 0> object;
+        std::string interface;    ///< Exports of a library unit, see MorningLanguageLLVM::get_interface()
+        time_report report;
+        double wall_ms = 0;
+        bool compiled = false;
+        bool reused = false;    ///< Taken unchanged from the build directory
+    };
+
+    /**
+     * @brief Settings shared by all units of a multi-file build
+     */
+    struct build_settings {
+        std::string output_base;
+        llvm::OptimizationLevel level;
+        std::string level_name;
+        bool ssa_locals;    ///< Build scalar locals as SSA registers, --ssa
+        std::string version;
+        LinkerKind linker;
+        bool keep_temps;
+        EmitKind emit;
+        unsigned jobs;
+        fs::path build_dir;    ///< Objects, interfaces and stamps of every unit
+        bool reuse;    ///< Take units whose inputs did not change from the build directory
+    };
+
+    /**
+     * @brief Add units for modules named by [import name] forms
+     *
+     * A module is an input file with that stem, or name.morning in the
+     * directory of the importing file. The entry unit can not be imported.
+     */
+    auto resolve_imports(std::vector<compile_unit>& units) -> bool {
+        for (size_t i = 0; i < units.size(); ++i) {
+            for (const auto& name : MorningLanguageLLVM::scan_imports(units[i].source)) {
+                auto found = std::find_if(units.begin(), units.end(), [&](const compile_unit& unit) {
+                    return unit.module == name;
+                });
+
+                if (found == units.begin()) {
+                    LOG_ERROR("\"%s\" imports the entry file \"%s\"", units[i].filename.c_str(), found->filename.c_str());
+                    return false;
+                }
+
+                if (found == units.end()) {
+                    const auto FILENAME = (fs::path(units[i].filename).parent_path() / (name + ".morning")).string();
+                    if (!fs::exists(FILENAME)) {
+                        LOG_ERROR("Module \"%s\" imported by \"%s\" not found, expected \"%s\"",
+                                  name.c_str(), units[i].filename.c_str(), FILENAME.c_str());
+                        return false;
+                    }
+
+                    auto source = read_source(FILENAME);
+                    if (!source) {
+                        return false;
+                    }
+
+                    auto& unit = units.emplace_back();
+                    unit.filename = FILENAME;
+                    unit.module = name;
+                    unit.source = std::move(*source);
+                    found = units.end() - 1;
+                }
+
+                const auto INDEX = static_cast<size_t>(found - units.begin());
+                if (std::find(units[i].imports.begin(), units[i].imports.end(), INDEX) == units[i].imports.end()) {
+                    units[i].imports.push_back(INDEX);
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Group units into waves, every unit comes after the units it imports
+     *
+     * Units of one wave are independent and compile in parallel.
+     */
+    auto schedule_units(const std::vector<compile_unit>& units) -> std::optional<std::vector<std::vector<size_t>>> {
+        constexpr size_t UNVISITED = SIZE_MAX;
+        constexpr size_t VISITING = SIZE_MAX - 1;
+        std::vector<size_t> wave_of(units.size(), UNVISITED);
+
+        std::function<bool(size_t)> visit = [&](size_t index) {
+            if (wave_of[index] == VISITING) {
+                LOG_ERROR("Import cycle through \"%s\"", units[index].filename.c_str());
+                return false;
+            }
+            if (wave_of[index] != UNVISITED) {
+                return true;
+            }
+
+            wave_of[index] = VISITING;
+            size_t wave = 0;
+            for (size_t imported : units[index].imports) {
+                if (!visit(imported)) {
+                    return false;
+                }
+                wave = std::max(wave, wave_of[imported] + 1);
+            }
+            wave_of[index] = wave;
+            return true;
+        };
+
+        std::vector<std::vector<size_t>> waves;
+        for (size_t i = 0; i < units.size(); ++i) {
+            if (!visit(i)) {
+                return std::nullopt;
+            }
+            if (waves.size() <= wave_of[i]) {
+                waves.resize(wave_of[i] + 1);
+            }
+            waves[wave_of[i]].push_back(i);
+        }
+        return waves;
+    }
+
+    /**
+     * @brief Read whole file, false if it can not be read
+     */
+    auto read_file(const fs::path& path, std::string& contents) -> bool {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return static_cast<bool>(file) || file.eof();
+    }
+
+    /**
+     * @brief Write whole file, false if it can not be written
+     */
+    auto write_file(const fs::path& path, llvm::StringRef contents) -> bool {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        return static_cast<bool>(file);
+    }
+
+    /**
+     * @brief Split the entry unit into a fragment per top-level function and one for the rest
+     *
+     * Functions of the entry file can not use its top-level variables, so
+     * each compiles alone as a library unit named <stem>#<function>, which
+     * imports the modules the file imports and the fragments of earlier
+     * functions it mentions, and sees the file's type aliases. The rest of the file stays the entry unit
+     * and imports every fragment. Files with two functions of one name are
+     * left whole.
+     */
+    void split_entry_unit(std::vector<compile_unit>& units) {
+        const auto FORMS = split_top_level_forms(units.front().source);
+
+        std::vector<std::string> functions;
+        for (const auto& form : FORMS) {
+            if (form.function.empty()) {
+                continue;
+            }
+            if (std::count(functions.begin(), functions.end(), form.function) != 0
+                || form.function.find('/') != std::string::npos)
+            {
+                LOG_DEBUG("Function \"%s\" can not be compiled separately", form.function.c_str());
+                return;
+            }
+            functions.push_back(form.function);
+        }
+
+        if (functions.empty()) {
+            return;
+        }
+
+        const auto FILE_IMPORTS = units.front().imports;
+        std::string preamble;
+        for (size_t imported : FILE_IMPORTS) {
+            preamble += "[import " + units[imported].module + "]\n";
+        }
+
+        // Type aliases generate no code, every fragment gets all of them
+        for (const auto& form : FORMS) {
+            if (form.symbols.size() > 1 && form.symbols[0] == "type" && form.text.compare(1, 4, "type") == 0) {
+                preamble += form.text + "\n";
+            }
+        }
+
+        const size_t FIRST_FRAGMENT = units.size();
+        std::string entry_imports;
+        std::string entry_source;
+
+        for (const auto& form : FORMS) {
+            if (form.function.empty()) {
+                entry_source += form.text + "\n";
+                continue;
+            }
+
+            compile_unit fragment;
+            fragment.filename = units.front().filename + ":" + form.function;
+            fragment.module = units.front().module + "#" + form.function;
+            fragment.imports = FILE_IMPORTS;
+            fragment.source = preamble;
+
+            for (size_t i = FIRST_FRAGMENT; i < units.size(); ++i) {
+                const auto FUNCTION = units[i].module.substr(units.front().module.size() + 1);
+                if (std::find(form.symbols.begin(), form.symbols.end(), FUNCTION) != form.symbols.end()) {
+                    fragment.imports.push_back(i);
+                    fragment.source += "[import " + units[i].module + "]\n";
+                }
+            }
+            fragment.source += form.text + "\n";
+
+            entry_imports += "[import " + fragment.module + "]\n";
+            units.front().imports.push_back(units.size());
+            units.push_back(std::move(fragment));
+        }
+
+        units.front().source = entry_imports + entry_source;
+        LOG_DEBUG("Split \"%s\" into %zu functions", units.front().filename.c_str(), functions.size());
+    }
+
+    /**
+     * @brief Save which fragments the entry file was split into and what they import
+     *
+     * Objects of fragments whose function is gone since the last build are
+     * removed from the build directory.
+     */
+    void save_fragment_graph(const fs::path& build_dir, const std::vector<compile_unit>& units) {
+        const auto& entry = units.front();
+        const auto GRAPH_FILE = build_dir / (entry.module + ".graph");
+
+        std::vector<std::string> fragments;
+        std::string graph;
+        for (size_t index : entry.imports) {
+            const auto& unit = units[index];
+            if (unit.module.rfind(entry.module + "#", 0) != 0) {
+                continue;
+            }
+
+            fragments.push_back(unit.module);
+            graph += unit.module;
+            for (size_t imported : unit.imports) {
+                graph += " " + units[imported].module;
+            }
+            graph += "\n";
+        }
+
+        std::ifstream previous(GRAPH_FILE);
+        std::string line;
+        while (std::getline(previous, line)) {
+            const auto MODULE = line.substr(0, line.find(' '));
+            if (MODULE.empty() || std::count(fragments.begin(), fragments.end(), MODULE) != 0) {
+                continue;
+            }
+
+            std::error_code err_code;
+            for (const char* extension : {".o", ".mi", ".stamp"}) {
+                fs::remove(build_dir / (MODULE + extension), err_code);
+            }
+            LOG_DEBUG("Removed stale fragment %s", MODULE.c_str());
+        }
+        previous.close();
+
+        if (!write_file(GRAPH_FILE, graph)) {
+            LOG_WARN("Cannot write \"%s\"", GRAPH_FILE.c_str());
+        }
+    }
+
+    /**
+     * @brief Run task for every index below count on a pool of worker threads
+     *
+     * Workers take the next index from a shared counter, so a long unit
+     * does not hold up the ones queued behind it.
+     */
+    void parallel_for(size_t count, unsigned jobs, const std::function<void(size_t)>& task) {
+        std::atomic<size_t> next {0};
+        auto worker = [&] {
+            for (size_t index = next++; index < count; index = next++) {
+                task(index);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        const size_t WORKER_COUNT = std::min<size_t>(jobs, count);
+        for (size_t i = 1; i < WORKER_COUNT; ++i) {
+            workers.emplace_back(worker);
+        }
+
+        worker();    // The calling thread works too
+        for (auto& thread : workers) {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief Compile one unit to an in-memory object with its own context and module
+     */
+    void compile_unit_object(compile_unit& unit,
+                             const std::vector<compile_unit>& units,
+                             bool library,
+                             const build_settings& settings,
+                             const std::vector<std::pair<EmitKind, std::string>>& artifacts,
+                             bool collect_report) {
+        const auto START = std::chrono::steady_clock::now();
+        time_report* report = collect_report ? &unit.report : nullptr;
+
+        // Exiting from a worker would tear down globals under the other workers
+        Logger::recoverable_errors recoverable;
+
+        try {
+            MorningLanguageLLVM morning_vm;
+            morning_vm.set_library_unit(library);
+            morning_vm.set_ssa_locals(settings.ssa_locals);
+            morning_vm.set_time_report(report);
+
+            for (size_t imported : unit.imports) {
+                morning_vm.add_module_interface(units[imported].module, units[imported].interface);
+            }
+
+            if (morning_vm.execute(unit.source) != 0) {
+                LOG_ERROR("IR generation failed for \"%s\"", unit.filename.c_str());
+                return;
+            }
+
+            if (library) {
+                unit.interface = morning_vm.get_interface();
+            }
+
+            llvm_compiler backend;
+            if (backend.get_target_machine() == nullptr) {
+                LOG_ERROR("Native target is not available");
+                return;
+            }
+            backend.set_opt_level(to_codegen_opt_level(settings.level));
+
+            morning_vm.optimize(settings.level, backend.get_target_machine());
+
+            for (const auto& artifact : artifacts) {
+                if (!write_module_artifact(morning_vm, backend, artifact.first, artifact.second)) {
+                    return;
+                }
+            }
+
+            time_report::scoped_phase phase(report, "emit");
+            if (!backend.compile_module_to_buffer(morning_vm.get_module(), unit.object)) {
+                LOG_ERROR("Object code generation failed for \"%s\"", unit.filename.c_str());
+                return;
+            }
+        } catch (const compile_error&) {
+            // Already reported, the unit stays failed and the rest of the wave finishes
+            LOG_ERROR("IR generation failed for \"%s\"", unit.filename.c_str());
+            return;
+        } catch (const std::exception& e) {
+            LOG_ERROR("Fatal error in \"%s\": %s", unit.filename.c_str(), e.what());
+            return;
+        }
+
+        unit.wall_ms = elapsed_ms(START);
+        unit.compiled = true;
+    }
+
+    /**
+     * @brief Compile unit unless the build directory has it for the same inputs
+     *
+     * A unit's stamp hashes its source and the interfaces, not the sources,
+     * of the units it imports, so editing a module's function bodies does
+     * not rebuild its importers.
+     */
+    void build_unit(compile_unit& unit,
+                    const std::vector<compile_unit>& units,
+                    bool library,
+                    const build_settings& settings,
+                    bool collect_report) {
+        std::string inputs = unit.source;
+        for (size_t imported : unit.imports) {
+            inputs += '\0' + units[imported].module + '\0' + units[imported].interface;
+        }
+
+        const auto STAMP = compilation_cache::make_key(inputs,
+                                                       settings.version,
+                                                       settings.level_name,
+                                                       compilation_cache::host_target(),
+                                                       library ? "module" : "entry");
+        const auto BASE = settings.build_dir / unit.module;
+        const auto OBJECT_FILE = fs::path(BASE.string() + ".o");
+        const auto INTERFACE_FILE = fs::path(BASE.string() + ".mi");
+        const auto STAMP_FILE = fs::path(BASE.string() + ".stamp");
+
+        std::string stamp;
+        std::string object;
+        // Kept IR and module artifacts need the unit's module, so it is compiled again
+        std::vector<std::pair<EmitKind, std::string>> artifacts;
+        if (settings.keep_temps) {
+            artifacts.emplace_back(EmitKind::IR, settings.output_base + "." + unit.module + ".ll");
+        }
+        if (is_module_artifact(settings.emit)) {
+            artifacts.emplace_back(settings.emit,
+                                   settings.output_base + "." + unit.module + emit_extension(settings.emit));
+        }
+
+        if (settings.reuse && artifacts.empty() && read_file(STAMP_FILE, stamp) && stamp == STAMP
+            && read_file(OBJECT_FILE, object) && (!library || read_file(INTERFACE_FILE, unit.interface)))
+        {
+            unit.object.assign(object.begin(), object.end());
+            unit.compiled = true;
+            unit.reused = true;
+            return;
+        }
+
+        compile_unit_object(unit, units, library, settings, artifacts, collect_report);
+        if (!unit.compiled) {
+            return;
+        }
+
+        // The stamp goes last, so an interrupted build never leaves a valid stamp over stale files
+        const bool SAVED = write_file(OBJECT_FILE, llvm::StringRef(unit.object.data(), unit.object.size()))
+            && (!library || write_file(INTERFACE_FILE, unit.interface)) && write_file(STAMP_FILE, STAMP);
+        if (!SAVED) {
+            LOG_WARN("Cannot save \"%s\" to build directory \"%s\"", unit.filename.c_str(), settings.build_dir.c_str());
+        }
+    }
+
+    /**
+     * @brief Compile modules in dependency order and link them into one binary
+     *
+     * The first unit is the entry: its top-level code becomes main. The
+     * others are library units whose top-level code runs before main.
+     * Units whose imports are built compile in parallel; every unit's
+     * object and interface are kept in the build directory, and units
+     * whose inputs did not change since are taken from there.
+     * Intermediate files are named <output>.<file stem>.ll/.o.
+     */
+    auto compile_units(std::vector<compile_unit>& units, const build_settings& settings, time_report* report) -> bool {
+        for (size_t i = 0; i < units.size(); ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                if (units[i].module == units[j].module) {
+                    LOG_ERROR("Input files must have distinct names, \"%s\" is used twice", units[i].module.c_str());
+                    return false;
+                }
+            }
+        }
+
+        auto waves = schedule_units(units);
+        if (!waves) {
+            return false;
+        }
+
+        std::error_code err_code;
+        fs::create_directories(settings.build_dir, err_code);
+        if (err_code) {
+            LOG_ERROR("Cannot create build directory \"%s\": %s", settings.build_dir.c_str(), err_code.message().c_str());
+            return false;
+        }
+
+        const auto START = std::chrono::steady_clock::now();
+        const size_t WORKER_COUNT = std::min<size_t>(settings.jobs, units.size());
+        LOG_INFO("Building %zu modules with %zu workers...", units.size(), WORKER_COUNT);
+
+        // Link order follows the waves, so constructors of imported units run first
+        std::vector<size_t> order;
+        for (const auto& wave : *waves) {
+            parallel_for(wave.size(), settings.jobs, [&](size_t index) {
+                const size_t UNIT = wave[index];
+                build_unit(units[UNIT], units, /* library */ UNIT != 0, settings, report != nullptr);
+            });
+
+            for (size_t index : wave) {
+                if (!units[index].compiled) {
+                    return false;
+                }
+            }
+            order.insert(order.end(), wave.begin(), wave.end());
+        }
+
+        uint64_t reused = 0;
+        for (size_t index : order) {
+            const auto& unit = units[index];
+            if (unit.reused) {
+                LOG_INFO("%-32s %13s %8zu KB", unit.filename.c_str(), "up to date", unit.object.size() / 1024);
+                reused++;
+            } else {
+                LOG_INFO("%-32s %10.2f ms %8zu KB", unit.filename.c_str(), unit.wall_ms, unit.object.size() / 1024);
+            }
+            if (report != nullptr) {
+                report->merge(unit.report, unit.module + "/");
+            }
+        }
+        LOG_INFO("%zu of %zu modules compiled in %.2f ms", units.size() - reused, units.size(), elapsed_ms(START));
+
+        if (report != nullptr) {
+            report->set_counter("modules_reused", reused);
+        }
+
+        time_report::scoped_phase phase(report, link_phase_name(settings.linker));
+
+        if (settings.emit == EmitKind::OBJECT) {
+            for (const auto& unit : units) {
+                const auto OBJ_FILE = settings.output_base + "." + unit.module + ".o";
+                if (!write_file(OBJ_FILE, llvm::StringRef(unit.object.data(), unit.object.size()))) {
+                    LOG_ERROR("Cannot write object file \"%s\"", OBJ_FILE.c_str());
+                    return false;
+                }
+            }
+        }
+        if (settings.emit != EmitKind::EXECUTABLE) {
+            return true;
+        }
+
+        if (settings.linker == LinkerKind::LLD) {
+            std::vector<llvm::ArrayRef<char>> objects;
+            for (size_t index : order) {
+                objects.emplace_back(units[index].object);
+            }
+
+            LOG_INFO("Linking binary...");
+            lld_linker lld;
+            if (!lld.link_buffers(objects, settings.output_base)) {
+                LOG_ERROR("Binary linking failed");
+                return false;
+            }
+            return check_binary(settings.output_base);
+        }
+
+        std::vector<std::string> obj_files;
+        for (size_t index : order) {
+            obj_files.push_back((settings.build_dir / (units[index].module + ".o")).string());
+        }
+        return link_object(obj_files, settings.output_base);
+    }
 }
 
 /**
@@ -160,7 +1085,11 @@ auto main(int argc, char **argv) -> int {
     MorningLanguageLLVM morning_vm;
     std::string program;
     std::string output_base = "out";
-    bool compile_raw_object_file = false;
+    EmitKind emit = EmitKind::EXECUTABLE;
+    llvm::OptimizationLevel opt_level = llvm::OptimizationLevel::O3;
+    std::string opt_level_name = "3";
+    uint64_t cache_size_limit = compilation_cache::DEFAULT_SIZE_LIMIT;
+    LinkerKind linker = LinkerKind::LLD;
 
     // Initialize parser with program info
     InputParser parser(
@@ -172,10 +1101,25 @@ auto main(int argc, char **argv) -> int {
     parser.add_option({"-v", "--version", "Get version", false, ""});
     parser.add_option({"-h", "--help", "Print this help message", false, ""});
     parser.add_option({"-e", "--expression", "Expression to parse", true, "<expr>"});
-    parser.add_option({"-f", "--file", "File to parse", true, "<file>"});
+    parser.add_option({"-f", "--file", "File or directory to compile, more files may follow as arguments", true, "<file>"});
     parser.add_option({"-o", "--output", "Output binary name", true, "<name>"});
     parser.add_option({"-k", "--keep", "Keep temporary files", false, ""});
-    parser.add_option({"-cof", "--compile-object-file", "Compile raw object file", false, ""});
+    parser.add_option({"-O", "--opt-level", "Optimization level (0, 1, 2, 3, s)", true, "<level>"});
+    parser.add_option({"", "--ssa", "Keep scalar locals in SSA registers instead of stack slots", false, ""});
+    parser.add_option({"-ld", "--linker", "Linker to use (lld, clang)", true, "<linker>"});
+    parser.add_option({"-j", "--jobs", "Files compiled in parallel (default: all cores)", true, "<n>"});
+    parser.add_option({"", "--incremental", "Compile functions of the entry file separately, reusing unchanged ones", false, ""});
+    parser.add_option({"", "--build-dir", "Directory for module objects and interfaces (default: morning-build)", true, "<dir>"});
+    parser.add_option({"-r", "--run", "Run program with JIT instead of compiling", false, ""});
+    parser.add_option({"-i", "--repl", "Start interactive session", false, ""});
+    parser.add_option({"", "--no-cache", "Do not use compilation cache", false, ""});
+    parser.add_option({"", "--cache-size", "Compilation cache size limit in MB", true, "<mb>"});
+    parser.add_option({"", "--cache-stats", "Print compilation cache statistics", false, ""});
+    parser.add_option({"-cof", "--compile-object-file", "Compile raw object file, same as --emit=obj", false, ""});
+    parser.add_option({"", "--emit", "Output kind (exe, obj, asm, bc, ll)", true, "<kind>"});
+    parser.add_option({"", "--log-level", "Lowest log level shown (note, debug, info, warning, error)", true, "<level>"});
+    parser.add_option({"", "--time-report", "Print time and memory used by each compilation phase", false, ""});
+    parser.add_option({"", "--time-report-json", "Write the time report as JSON", true, "<file>"});
 
     // Parse command line
     if (!parser.parse(argc, argv)) {
@@ -186,6 +1130,15 @@ auto main(int argc, char **argv) -> int {
         return 1;
     }
 
+    if (auto name = parser.get_argument("--log-level")) {
+        auto parsed_level = parse_log_level(*name);
+        if (!parsed_level) {
+            LOG_ERROR("Invalid log level: %s", name->c_str());
+            return 1;
+        }
+        Logger::set_level(*parsed_level);
+    }
+
     if (parser.has_option("-v")) {
         LOG_INFO("Version: %s", VERSION.c_str());
         return 0;
@@ -198,7 +1151,16 @@ auto main(int argc, char **argv) -> int {
     }
 
     if (parser.has_option("-cof") || parser.has_option("--compile-object-file")) {
-        compile_raw_object_file = true;
+        emit = EmitKind::OBJECT;
+    }
+
+    if (auto name = parser.get_argument("--emit")) {
+        auto parsed_emit = parse_emit_kind(*name);
+        if (!parsed_emit) {
+            LOG_ERROR("Invalid output kind: %s", name->c_str());
+            return 1;
+        }
+        emit = *parsed_emit;
     }
 
     // Handle output option
@@ -208,32 +1170,98 @@ auto main(int argc, char **argv) -> int {
         output_base = *output;
     }
 
+    if (auto level = parser.get_argument("-O")) {
+        auto parsed_level = parse_opt_level(*level);
+        if (!parsed_level) {
+            LOG_ERROR("Invalid optimization level: %s", level->c_str());
+            return 1;
+        }
+        opt_level = *parsed_level;
+        opt_level_name = *level;
+    }
+
+    // The level name keys cached artifacts, so it also records the frontend mode
+    const bool SSA_LOCALS = parser.has_option("--ssa");
+    if (SSA_LOCALS) {
+        opt_level_name += "+ssa";
+    }
+    morning_vm.set_ssa_locals(SSA_LOCALS);
+
+    if (auto name = parser.get_argument("-ld")) {
+        auto parsed_linker = parse_linker(*name);
+        if (!parsed_linker) {
+            LOG_ERROR("Invalid linker: %s", name->c_str());
+            return 1;
+        }
+        linker = *parsed_linker;
+    }
+
+    if (auto size = parser.get_argument("--cache-size")) {
+        try {
+            cache_size_limit = std::stoull(*size) * 1024 * 1024;
+        } catch (const std::exception&) {
+            LOG_ERROR("Invalid cache size: %s", size->c_str());
+            return 1;
+        }
+    }
+
+    compilation_cache cache(cache_size_limit);
+
+    if (parser.has_option("--cache-stats")) {
+        print_cache_stats(cache);
+        return 0;
+    }
+
     if (!is_valid_output_name(output_base)) {
         LOG_ERROR("Invalid output name: %s", output_base.c_str());
         return 1;
     }
 
-    // Handle input source
+    if (parser.has_option("-i") || parser.has_option("--repl")) {
+        repl_session repl(opt_level, SSA_LOCALS);
+        return repl.run(std::cin, std::cout);
+    }
+
+    // Handle input source: a file or directory from -f, more files as positional arguments
+    std::vector<std::string> inputs;
     if (auto filename = parser.get_argument("-f")) {
-        if (!fs::exists(*filename)) {
-            LOG_ERROR("File \"%s\" not found", filename->c_str());
+        inputs.push_back(*filename);
+    }
+    const auto& extra_inputs = parser.get_positional_args();
+    inputs.insert(inputs.end(), extra_inputs.begin(), extra_inputs.end());
+
+    std::vector<compile_unit> units;
+
+    if (!inputs.empty()) {
+        if (parser.get_argument("-e")) {
+            LOG_ERROR("Expression and input files can not be combined");
             return 1;
         }
 
-        std::ifstream program_file(*filename);
-        if (!program_file.is_open()) {
-            LOG_ERROR("Cannot open file \"%s\"", filename->c_str());
+        auto files = collect_inputs(inputs);
+        if (!files) {
             return 1;
         }
 
-        std::stringstream buffer;
-        buffer << program_file.rdbuf();
-        program = buffer.str();
+        for (const auto& file : *files) {
+            auto source = read_source(file);
+            if (!source) {
+                return 1;
+            }
+            auto& unit = units.emplace_back();
+            unit.filename = file;
+            unit.module = fs::path(file).stem().string();
+            unit.source = std::move(*source);
+        }
 
-        if (program.empty()) {
-            LOG_ERROR("File \"%s\" is empty", filename->c_str());
+        if (!resolve_imports(units)) {
             return 1;
         }
+
+        if (parser.has_option("--incremental") && !parser.has_option("-r") && !parser.has_option("--run")) {
+            split_entry_unit(units);
+        }
+        program = units.front().source;
     } else if (auto expr = parser.get_argument("-e")) {
         program = *expr;
 
@@ -247,33 +1275,159 @@ auto main(int argc, char **argv) -> int {
         return 1;
     }
 
+    const bool MULTI_FILE = units.size() > 1;
+
+    unsigned jobs = std::max(1U, std::thread::hardware_concurrency());
+    if (auto count = parser.get_argument("-j")) {
+        try {
+            jobs = static_cast<unsigned>(std::stoul(*count));
+        } catch (const std::exception&) {
+            jobs = 0;
+        }
+        if (jobs == 0) {
+            LOG_ERROR("Invalid number of jobs: %s", count->c_str());
+            return 1;
+        }
+    }
+
+    const bool RUN_JIT = parser.has_option("-r") || parser.has_option("--run");
+
+    if (RUN_JIT && MULTI_FILE) {
+        LOG_ERROR("JIT runs a single file");
+        return 1;
+    }
+
     // Check required utilities
-    if (!check_utils_available()) {
+    if (!RUN_JIT && emit == EmitKind::EXECUTABLE && linker == LinkerKind::CLANG && !check_utils_available()) {
         return 1;
     }
 
+    const bool KEEP_TEMPS = parser.has_option("-k") || parser.has_option("--keep");
+
+    // Collected for the whole pipeline, printed and saved when main returns
+    time_report report;
+    const auto REPORT_JSON = parser.get_argument("--time-report-json");
+    const bool TIME_REPORT = parser.has_option("--time-report") || REPORT_JSON.has_value();
+    time_report_output report_output(report, parser.has_option("--time-report"), REPORT_JSON);
+    if (TIME_REPORT) {
+        morning_vm.set_time_report(&report);
+    }
+
+    // Intermediate files, JIT runs and time reports can not be served from the cache
+    std::string cache_key;
+    const std::string ARTIFACT = output_base + emit_extension(emit);
+
+    // Objects of a multi-file build are several artifacts, only its binary is cached
+    if (!RUN_JIT && !KEEP_TEMPS && !TIME_REPORT && !(MULTI_FILE && emit != EmitKind::EXECUTABLE)
+        && !parser.has_option("--no-cache") && cache.is_available())
+    {
+        std::string cache_program = program;
+        if (MULTI_FILE) {
+            cache_program.clear();
+            for (const auto& unit : units) {
+                cache_program += unit.module + '\0' + unit.source;
+                cache_program.push_back('\0');
+            }
+        }
+
+        cache_key = compilation_cache::make_key(cache_program,
+                                                VERSION,
+                                                opt_level_name,
+                                                compilation_cache::host_target(),
+                                                emit == EmitKind::EXECUTABLE ? "binary"
+                                                    : emit == EmitKind::OBJECT ? "object"
+                                                                               : "module" + emit_extension(emit));
+
+        if (cache.restore(cache_key, ARTIFACT)) {
+            LOG_INFO("Successfully restored %s from cache", ARTIFACT.c_str());
+            return 0;
+        }
+    }
+
+    if (MULTI_FILE) {
+        build_settings settings {output_base,
+                                 opt_level,
+                                 opt_level_name,
+                                 SSA_LOCALS,
+                                 VERSION,
+                                 linker,
+                                 KEEP_TEMPS,
+                                 emit,
+                                 jobs,
+                                 parser.get_argument("--build-dir").value_or("morning-build"),
+                                 /* reuse */ !KEEP_TEMPS && !parser.has_option("--no-cache")};
+
+        if (!compile_units(units, settings, TIME_REPORT ? &report : nullptr)) {
+            LOG_ERROR("Compilation failed");
+            return 1;
+        }
+
+        if (parser.has_option("--incremental")) {
+            save_fragment_graph(settings.build_dir, units);
+        }
+
+        if (!cache_key.empty()) {
+            cache.store(cache_key, ARTIFACT);
+        }
+
+        if (emit != EmitKind::EXECUTABLE) {
+            LOG_INFO("Successfully compiled %zu files to %s.*%s",
+                     units.size(),
+                     output_base.c_str(),
+                     emit_extension(emit).c_str());
+            return 0;
+        }
+
+        LOG_INFO("Successfully compiled %zu files to %s", units.size(), output_base.c_str());
+        return 0;
+    }
+
     // Execute compilation pipeline
     try {
+        const auto SOURCE_START = std::chrono::steady_clock::now();
+
         LOG_INFO("Executing program...\n");
-        morning_vm.execute(program, output_base);
+        if (morning_vm.execute(program) != 0) {
+            LOG_ERROR("IR generation failed");
+            return 1;
+        }
         std::cout << "\n";
 
-        const std::string LL_FILE = output_base + ".ll";
-        if (!fs::exists(LL_FILE) || fs::file_size(LL_FILE) == 0) {
-            LOG_ERROR("IR generation failed, no output file");
-            return 1;
+        if (RUN_JIT) {
+            jit_runner jit;
+            auto exit_code = run_jit(morning_vm, jit, opt_level, SOURCE_START, TIME_REPORT ? &report : nullptr);
+            if (!exit_code) {
+                LOG_ERROR("JIT execution failed");
+                return 1;
+            }
+            return *exit_code;
         }
 
-        if (!compile_ir(output_base)) {
+        if (!compile_ir(morning_vm,
+                        output_base,
+                        opt_level,
+                        linker,
+                        KEEP_TEMPS,
+                        emit,
+                        TIME_REPORT ? &report : nullptr)) {
             LOG_ERROR("Compilation failed, temporary files retained for debugging");
             return 1;
         }
 
+        if (!cache_key.empty()) {
+            cache.store(cache_key, ARTIFACT);
+        }
+
+        if (emit != EmitKind::EXECUTABLE) {
+            LOG_INFO("Successfully compiled to %s", ARTIFACT.c_str());
+            return 0;
+        }
+
         // Cleanup temporary files
-        if (!parser.has_option("-k") && !parser.has_option("--keep")) {
+        if (!KEEP_TEMPS) {
             cleanup_temp_files(output_base);
         } else {
-            LOG_INFO("Optimized IR code saved: %s", LL_FILE.c_str());
+            LOG_INFO("Optimized IR code saved: %s.ll", output_base.c_str());
         }
 
         LOG_INFO("Successfully compiled to %s", output_base.c_str());
@@ -1,16 +1,18 @@
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
-#include <regex>
 #include <string>
 #include <system_error>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "morningllvm.hpp"
 
 #include <boost/algorithm/string.hpp>
+#include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/IR/BasicBlock.h>
 #include <llvm/IR/Constant.h>
 #include <llvm/IR/Constants.h>
@@ -19,12 +21,19 @@
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/PassInstrumentation.h>
+#include <llvm/IR/PassTimingInfo.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/Passes/PassBuilder.h>
 #include <llvm/Support/Alignment.h>
 #include <llvm/Support/Casting.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MathExtras.h>
+#include <llvm/Support/Timer.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
 
 #include "codegen/arithmetic.hpp"
 #include "env.h"
@@ -36,29 +45,30 @@
 
 namespace {
     /**
-     * @brief Replace regex in string
-     *
-     * @param str string for replacing text in string by regex templates
-     * @return std::string
-     **/
-    auto replace_regex_in_string(const std::string& str) -> std::string {
-        auto regex_newline = std::regex("\\\\n");
-        auto regex_tab = std::regex("\\\\t");
+     * @brief Collect names whose storage is used directly: mem-ptr, finput and index operands
+     */
+    void collect_address_taken(const Exp& exp, std::unordered_set<uint32_t>& names) {
+        if (exp.type != ExpType::LIST || exp.list.empty()) {
+            return;
+        }
 
-        auto newlined = std::regex_replace(str, regex_newline, "\n");
-        auto tabed = std::regex_replace(newlined, regex_tab, "\t");
+        if (exp.list[0].type == ExpType::SYMBOL) {
+            const auto FORM = exp.list[0].string.form();
+            const size_t FIRST = FORM == SpecialForm::FINPUT ? 2 : 1;
+            const size_t LAST = FORM == SpecialForm::FINPUT ? exp.list.size() : 2;
 
-        return tabed;
-    }
+            if (FORM == SpecialForm::MEM_PTR || FORM == SpecialForm::INDEX || FORM == SpecialForm::FINPUT) {
+                for (size_t i = FIRST; i < LAST && i < exp.list.size(); ++i) {
+                    if (exp.list[i].type == ExpType::SYMBOL) {
+                        names.insert(exp.list[i].string.id());
+                    }
+                }
+            }
+        }
 
-    /**
-     * @brief Extract name from variable
-     *
-     * @param exp exp
-     * @return std::string
-     **/
-    auto extract_var_name(const Exp& exp) -> std::string {
-        return exp.type == ExpType::LIST ? exp.list[0].string : exp.string;
+        for (const auto& item : exp.list) {
+            collect_address_taken(item, names);
+        }
     }
 
     /**
@@ -72,6 +82,22 @@ namespace {
         return fn_exp.list[3].type == ExpType::SYMBOL && fn_exp.list[3].string == "->";
     }
 
+    /**
+     * @brief Count AST nodes for --time-report
+     *
+     * @param exp root expression
+     * @return uint64_t number of nodes including the root
+     **/
+    auto count_nodes(const Exp& exp) -> uint64_t {
+        uint64_t count = 1;
+        if (exp.type == ExpType::LIST) {
+            for (const auto& child : exp.list) {
+                count += count_nodes(child);
+            }
+        }
+        return count;
+    }
+
     /**
      * @brief Safe expression converting to string
      *
@@ -88,6 +114,11 @@ namespace {
                 std::string s = "[";
                 for (const auto& e : exp.list) {
                     s += safe_expr_to_string(e) + " ";
+
+                    // No need to render what is trimmed anyway
+                    if (s.length() > 120) {
+                        break;
+                    }
                 }
                 s.pop_back();    // Remove last space
                 s += "]";
@@ -115,16 +146,18 @@ namespace {
     }
 
     /**
-     * @brief Add expression to traceback expressions stack.
+     * @brief Render traceback entry, called only when a traceback is printed.
      *
-     * @param exp expression for adding
+     * @param exp_ptr expression recorded by generate_expression
+     * @return std::pair<std::string, std::string> context and expression text
      **/
-    void add_expression_to_traceback_stack(const Exp& exp) {
+    auto render_traceback_entry(const Exp* exp_ptr) -> std::pair<std::string, std::string> {
+        const auto& exp = *exp_ptr;
         std::string context = "expr";
         std::string const EXPR_STR = safe_expr_to_string(exp);
 
         if (EXPR_STR == "<?>") {
-            return;
+            return {};
         }
 
         if (exp.type == ExpType::LIST || exp.type == ExpType::SYMBOL || exp.type == ExpType::NUMBER
@@ -156,32 +189,265 @@ namespace {
             }
         }
 
-        PUSH_EXPR_STACK(context, EXPR_STR);
+        return {context, EXPR_STR};
     }
 }    // namespace
 
 MorningLanguageLLVM::MorningLanguageLLVM()
-    : m_PARSER(std::make_unique<syntax::MorningLangGrammar>()) {
+    : m_PARSER(std::make_unique<syntax::MorningLangGrammar>())
+    , m_ENV(m_PARSER->symbols) {
     LOG_TRACE
 
+    Logger::set_expression_renderer(render_traceback_entry);
+
     initialize_module();
     setup_triple();
     setup_extern_functions();
     setup_global_environment();
 }
 
-auto MorningLanguageLLVM::execute(const std::string& program, const std::string& output_base) -> int {
+auto MorningLanguageLLVM::execute(const std::string& program) -> int {
     LOG_TRACE
 
-    auto ast = m_PARSER->parse("[scope " + program + "]");
-    generate_ir(ast);
+    Logger::clear_expressions();
+    auto ast = [&] {
+        time_report::scoped_phase phase(m_TIME_REPORT, "parse");
+        return m_PARSER->parse("[scope " + program + "]");
+    }();
+
+    {
+        time_report::scoped_phase phase(m_TIME_REPORT, "codegen");
+        generate_ir(ast);
+    }
+
+    if (m_TIME_REPORT != nullptr) {
+        m_TIME_REPORT->set_counter("ast_nodes", count_nodes(ast));
+        m_TIME_REPORT->set_counter("ast_bytes", m_PARSER->arena.bytesReserved());
+        m_TIME_REPORT->set_counter("ir_instructions", m_MODULE->getInstructionCount());
+    }
 
-    llvm::verifyModule(*m_MODULE, &llvm::errs());
-    save_module_to_file(output_base + ".ll");
+    time_report::scoped_phase phase(m_TIME_REPORT, "verify");
+
+    if (llvm::verifyModule(*m_MODULE, &llvm::errs())) {
+        LOG_ERROR("Generated module is broken");
+        return 1;
+    }
 
     return 0;
 }
 
+void MorningLanguageLLVM::optimize(llvm::OptimizationLevel level, llvm::TargetMachine* target_machine) {
+    LOG_TRACE
+
+    {
+        time_report::scoped_phase phase(m_TIME_REPORT, "optimize");
+        optimize_module(*m_MODULE, level, target_machine, m_TIME_REPORT);
+    }
+
+    if (m_TIME_REPORT != nullptr) {
+        m_TIME_REPORT->set_counter("ir_instructions_optimized", m_MODULE->getInstructionCount());
+    }
+}
+
+void MorningLanguageLLVM::optimize_module(llvm::Module& module,
+                                          llvm::OptimizationLevel level,
+                                          llvm::TargetMachine* target_machine,
+                                          time_report* report) {
+    LOG_TRACE
+
+    if (target_machine != nullptr) {
+        module.setDataLayout(target_machine->createDataLayout());
+        module.setTargetTriple(target_machine->getTargetTriple().str());
+    }
+
+    // Pass timings are only collected for a report, the handler is inert otherwise
+    std::string pass_timings;
+    llvm::raw_string_ostream pass_timings_stream(pass_timings);
+    llvm::PassInstrumentationCallbacks instrumentation;
+    llvm::TimePassesHandler time_passes(report != nullptr);
+    time_passes.setOutStream(pass_timings_stream);
+    time_passes.registerCallbacks(instrumentation);
+
+    // Analysis managers must be declared in this order, so they are destroyed in reverse
+    llvm::LoopAnalysisManager loop_am;
+    llvm::FunctionAnalysisManager function_am;
+    llvm::CGSCCAnalysisManager cgscc_am;
+    llvm::ModuleAnalysisManager module_am;
+
+    llvm::PassBuilder pass_builder(target_machine, llvm::PipelineTuningOptions(), std::nullopt, &instrumentation);
+    pass_builder.registerModuleAnalyses(module_am);
+    pass_builder.registerCGSCCAnalyses(cgscc_am);
+    pass_builder.registerFunctionAnalyses(function_am);
+    pass_builder.registerLoopAnalyses(loop_am);
+    pass_builder.crossRegisterProxies(loop_am, function_am, cgscc_am, module_am);
+
+    llvm::ModulePassManager module_pm = level == llvm::OptimizationLevel::O0
+        ? pass_builder.buildO0DefaultPipeline(level)
+        : pass_builder.buildPerModuleDefaultPipeline(level);
+
+    module_pm.run(module, module_am);
+
+    if (report != nullptr) {
+        // Printing the handler resets its timers, so the JSON values go first
+        std::string pass_json;
+        llvm::raw_string_ostream pass_json_stream(pass_json);
+        llvm::TimerGroup::printAllJSONValues(pass_json_stream, "\n");
+        time_passes.print();
+
+        report->set_pass_timings(pass_timings_stream.str(), pass_json_stream.str());
+    }
+}
+
+auto MorningLanguageLLVM::begin_repl() -> llvm::orc::ThreadSafeModule {
+    LOG_TRACE
+
+    record_repl_symbols();
+
+    return take_module();
+}
+
+auto MorningLanguageLLVM::compile_repl_input(const std::string& input) -> std::optional<ReplUnit> {
+    LOG_TRACE
+
+    const auto SESSION_DEPTH = m_ENV.depth();
+
+    try {
+        return generate_repl_unit(input);
+    } catch (const compile_error&) {
+        // Drop everything the failed input defined, the next one starts from the session state
+        while (m_ENV.depth() > SESSION_DEPTH) {
+            m_ENV.pop_scope();
+        }
+        m_TOP_LEVEL_DEPTH = 0;
+        m_LOOP_STACK.clear();
+        m_ALIASES_IN_RESOLUTION.clear();
+        m_ACTIVE_FUNCTION = nullptr;
+        m_IR_BUILDER->ClearInsertionPoint();
+        m_VARS_BUILDER->ClearInsertionPoint();
+        m_MODULE.reset();
+        throw;
+    }
+}
+
+auto MorningLanguageLLVM::generate_repl_unit(const std::string& input) -> std::optional<ReplUnit> {
+    LOG_TRACE
+
+    start_repl_module();
+
+    Logger::clear_expressions();
+    auto ast = m_PARSER->parse("[scope " + input + "]");
+    start_ssa_locals(ast);
+
+    const std::string ENTRY_NAME = "__repl_" + std::to_string(m_REPL_COUNTER++);
+    auto* entry_type = llvm::FunctionType::get(m_IR_BUILDER->getInt64Ty(), {}, false);
+
+    // Fresh scope per input, so its definitions are dropped if it fails
+    m_ENV.push_scope();
+    m_TOP_LEVEL_DEPTH = m_ENV.depth();
+    m_ACTIVE_FUNCTION = create_function(ENTRY_NAME, entry_type);
+
+    llvm::Value* result = nullptr;
+    for (size_t i = 1; i < ast.list.size(); i++) {
+        result = generate_expression(ast.list[i]);
+    }
+
+    // Keep the scope open until its definitions are recorded
+    auto close_scope = [this] {
+        m_ENV.pop_scope();
+        m_TOP_LEVEL_DEPTH = 0;
+    };
+
+    auto kind = ReplValueKind::NONE;
+    llvm::Value* encoded = m_IR_BUILDER->getInt64(0);
+
+    if (result != nullptr && !llvm::isa<llvm::Function>(result)) {
+        auto* type = result->getType();
+
+        if (type->isIntegerTy(1)) {
+            encoded = m_IR_BUILDER->CreateZExt(result, m_IR_BUILDER->getInt64Ty());
+            kind = ReplValueKind::INTEGER;
+        } else if (type->isIntegerTy()) {
+            encoded = m_IR_BUILDER->CreateSExtOrTrunc(result, m_IR_BUILDER->getInt64Ty());
+            kind = ReplValueKind::INTEGER;
+        } else if (type->isDoubleTy()) {
+            encoded = m_IR_BUILDER->CreateBitCast(result, m_IR_BUILDER->getInt64Ty());
+            kind = ReplValueKind::FRACTIONAL;
+        } else if (type->isPointerTy()) {
+            encoded = m_IR_BUILDER->CreatePtrToInt(result, m_IR_BUILDER->getInt64Ty());
+            kind = ReplValueKind::POINTER;
+        }
+    }
+
+    m_IR_BUILDER->CreateRet(encoded);
+
+    if (llvm::verifyModule(*m_MODULE, &llvm::errs())) {
+        LOG_ERROR("Generated module is broken");
+        close_scope();
+        return std::nullopt;
+    }
+
+    record_repl_symbols();
+    close_scope();
+
+    return ReplUnit {take_module(), ENTRY_NAME, kind};
+}
+
+void MorningLanguageLLVM::start_repl_module() {
+    LOG_TRACE
+
+    m_MODULE = std::make_unique<llvm::Module>("MorningLangReplUnit", *m_CONTEXT);
+    m_STRING_LITERALS.clear();
+    setup_triple();
+    setup_extern_functions();
+
+    for (const auto& [name, symbol] : m_REPL_SYMBOLS) {
+        llvm::Value* declaration = nullptr;
+
+        if (auto* function_type = llvm::dyn_cast<llvm::FunctionType>(symbol.type)) {
+            declaration =
+                llvm::Function::Create(function_type, llvm::Function::ExternalLinkage, name, m_MODULE.get());
+        } else {
+            declaration = new llvm::GlobalVariable(*m_MODULE,
+                                                   symbol.type,
+                                                   /* constant */ false,
+                                                   llvm::GlobalValue::ExternalLinkage,
+                                                   /* initializer */ nullptr,
+                                                   name);
+        }
+
+        m_ENV.define(name, declaration, symbol.constant);
+        if (symbol.is_unsigned) {
+            m_ENV.mark_unsigned(name);
+        }
+    }
+}
+
+void MorningLanguageLLVM::record_repl_symbols() {
+    LOG_TRACE
+
+    for (auto& function : m_MODULE->functions()) {
+        if (function.isDeclaration() || &function == m_ACTIVE_FUNCTION) {
+            continue;
+        }
+
+        auto name = function.getName().str();
+        if (m_ENV.lookup_by_name(name, false) == &function) {
+            m_REPL_SYMBOLS[name] = {function.getFunctionType(), false, m_ENV.is_unsigned(name)};
+        }
+    }
+
+    for (auto& global : m_MODULE->globals()) {
+        if (global.isDeclaration() || global.hasPrivateLinkage()) {
+            continue;
+        }
+
+        auto name = global.getName().str();
+        if (m_ENV.lookup_by_name(name, false) == &global) {
+            m_REPL_SYMBOLS[name] = {global.getValueType(), m_ENV.is_constant(name), m_ENV.is_unsigned(name)};
+        }
+    }
+}
+
 void MorningLanguageLLVM::setup_triple() {
     m_MODULE->setTargetTriple("x86_64-unknown-linux-gnu");
 }
@@ -193,27 +459,57 @@ void MorningLanguageLLVM::setup_global_environment() {
         {"_VERSION", m_IR_BUILDER->getInt64(300)},
     };
 
-    std::map<std::string, llvm::Value*> global_rec {};
+    // The global scope stays open for the lifetime of the compiler
+    m_ENV.push_scope();
 
     for (const auto& entry : GLOBAL_OBJECT) {
-        global_rec[entry.first] = create_global_variable(entry.first, (llvm::Constant*)entry.second);
+        m_ENV.define(entry.first, create_global_variable(entry.first, (llvm::Constant*)entry.second));
     }
-
-    m_GLOBAL_ENV = std::make_shared<Environment>(global_rec, nullptr);
 }
 
 void MorningLanguageLLVM::generate_ir(const Exp& ast) {
     LOG_TRACE
 
+    start_ssa_locals(ast);
+
+    if (m_LIBRARY_UNIT) {
+        // Every unit defines the predefined globals, keep them out of the linker's way
+        for (auto& global : m_MODULE->globals()) {
+            global.setLinkage(llvm::GlobalValue::InternalLinkage);
+        }
+
+        auto* init_type = llvm::FunctionType::get(m_IR_BUILDER->getVoidTy(), /* Parameters */ {}, false);
+        m_ACTIVE_FUNCTION = create_function("__morning_unit_init", init_type);
+        m_ACTIVE_FUNCTION->setLinkage(llvm::GlobalValue::InternalLinkage);
+
+        // Variables of the unit's outermost scope become globals
+        m_TOP_LEVEL_DEPTH = m_ENV.depth() + 1;
+        generate_expression(ast);
+        m_TOP_LEVEL_DEPTH = 0;
+
+        // Units holding only functions need no constructor
+        if (m_IR_BUILDER->GetInsertBlock() == &m_ACTIVE_FUNCTION->getEntryBlock()
+            && m_ACTIVE_FUNCTION->getEntryBlock().empty())
+        {
+            m_ACTIVE_FUNCTION->eraseFromParent();
+            m_ACTIVE_FUNCTION = nullptr;
+            return;
+        }
+
+        m_IR_BUILDER->CreateRetVoid();
+        llvm::appendToGlobalCtors(*m_MODULE, m_ACTIVE_FUNCTION, /* Priority */ 65535);
+        return;
+    }
+
     // Create function type: i32 main()
     auto* main_type = llvm::FunctionType::get(m_IR_BUILDER->getInt64Ty(),    // Return type = 32-bit integer
                                               /* Parameters */ {},    // Empty list = no arguments
                                               /* Varargs */ false    // No "..."
     );
 
-    m_ACTIVE_FUNCTION = create_function("main", main_type, m_GLOBAL_ENV);
+    m_ACTIVE_FUNCTION = create_function("main", main_type);
 
-    generate_expression(ast, m_GLOBAL_ENV);
+    generate_expression(ast);
 
     m_IR_BUILDER->CreateRet(m_IR_BUILDER->getInt64(0));
 }
@@ -234,24 +530,78 @@ auto MorningLanguageLLVM::create_global_variable(const std::string& name,
     return variable;
 }
 
+auto MorningLanguageLLVM::get_string_literal(const std::string& value) -> llvm::Constant* {
+    auto found = m_STRING_LITERALS.find(value);
+    if (found != m_STRING_LITERALS.end()) {
+        return found->second;
+    }
+
+    auto* literal = m_IR_BUILDER->CreateGlobalStringPtr(value, ".str", 0, m_MODULE.get());
+    m_STRING_LITERALS.emplace(value, literal);
+
+    return literal;
+}
+
 auto MorningLanguageLLVM::get_type(const std::string& type_string, const std::string& var_name)
     -> llvm::Type* {
+    return get_type_descriptor(type_string, var_name).type;
+}
+
+auto MorningLanguageLLVM::get_type_descriptor(const std::string& type_string, const std::string& var_name)
+    -> TypeDescriptor {
+    auto found = m_TYPE_TABLE.find(type_string);
+    if (found != m_TYPE_TABLE.end()) {
+        return found->second;
+    }
+
+    auto* type = parse_type(type_string, var_name);
+    if (type == nullptr) {
+        LOG_WARN("Variable \"%s\" does not have typing: set by auto (!int)", var_name.c_str());
+        return {m_IR_BUILDER->getInt64Ty(), get_type_size(m_IR_BUILDER->getInt64Ty())};
+    }
+
+    const TypeDescriptor DESCRIPTOR {
+        type, type->isSized() ? get_type_size(type) : 0, is_unsigned_spelling(type_string)};
+    m_TYPE_TABLE.emplace(type_string, DESCRIPTOR);
+
+    return DESCRIPTOR;
+}
+
+auto MorningLanguageLLVM::parse_type(const std::string& type_string, const std::string& var_name)
+    -> llvm::Type* {
+    if (std::find(m_ALIASES_IN_RESOLUTION.begin(), m_ALIASES_IN_RESOLUTION.end(), type_string)
+        != m_ALIASES_IN_RESOLUTION.end())
+    {
+        LOG_CRITICAL("Type alias \"%s\" refers to itself", type_string.c_str());
+    }
+
+    if (auto alias = m_TYPE_ALIASES.find(type_string); alias != m_TYPE_ALIASES.end()) {
+        m_ALIASES_IN_RESOLUTION.push_back(type_string);
+        auto* type = get_type(alias->second, var_name);
+        m_ALIASES_IN_RESOLUTION.pop_back();
+        return type;
+    }
+
     if (type_string == "!int" || type_string == "!int64") {
         return m_IR_BUILDER->getInt64Ty();
     }
 
-    if (type_string == "!int32") {
-        return m_IR_BUILDER->getInt64Ty();
+    if (type_string == "!int32" || type_string == "!uint32") {
+        return m_IR_BUILDER->getInt32Ty();
     }
 
-    if (type_string == "!int16") {
+    if (type_string == "!int16" || type_string == "!uint16") {
         return m_IR_BUILDER->getInt16Ty();
     }
 
-    if (type_string == "!int8") {
+    if (type_string == "!int8" || type_string == "!uint8") {
         return m_IR_BUILDER->getInt8Ty();
     }
 
+    if (type_string == "!uint" || type_string == "!uint64") {
+        return m_IR_BUILDER->getInt64Ty();
+    }
+
     if (type_string == "!str") {
         return m_IR_BUILDER->getInt8Ty()->getPointerTo();
     }
@@ -363,9 +713,31 @@ auto MorningLanguageLLVM::get_type(const std::string& type_string, const std::st
         return llvm::ArrayType::get(element_type, size);
     }
 
-    LOG_WARN("Variable \"%s\" does not have typing: set by auto (!int)", var_name.c_str());
+    return nullptr;
+}
 
-    return m_IR_BUILDER->getInt64Ty();
+auto MorningLanguageLLVM::is_unsigned_spelling(const std::string& type_string) -> bool {
+    if (auto alias = m_TYPE_ALIASES.find(type_string); alias != m_TYPE_ALIASES.end()) {
+        return get_type_descriptor(alias->second, type_string).is_unsigned;
+    }
+
+    if (type_string.find("!size:") == 0) {
+        return get_type_descriptor(type_string.substr(type_string.rfind(':') + 1), type_string).is_unsigned;
+    }
+
+    // The element spelling ends at the comma before the array size
+    const auto COMMA = type_string.rfind(',');
+    if (type_string.find("!array<") == 0 && COMMA != std::string::npos && COMMA > 7) {
+        const auto ELEMENT = boost::algorithm::trim_copy(type_string.substr(7, COMMA - 7));
+        return get_type_descriptor(ELEMENT, type_string).is_unsigned;
+    }
+
+    return type_string == "!uint" || type_string == "!uint8" || type_string == "!uint16"
+        || type_string == "!uint32" || type_string == "!uint64";
+}
+
+auto MorningLanguageLLVM::extract_var_name(const Exp& exp) -> Symbol {
+    return exp.type == ExpType::LIST ? exp.list[0].string : exp.string;
 }
 
 auto MorningLanguageLLVM::extract_var_type(const Exp& exp) -> llvm::Type* {
@@ -374,7 +746,7 @@ auto MorningLanguageLLVM::extract_var_type(const Exp& exp) -> llvm::Type* {
 }
 
 auto MorningLanguageLLVM::extract_function_type(const Exp& fn_exp) -> llvm::FunctionType* {
-    auto params = fn_exp.list[2];
+    const auto& params = fn_exp.list[2];
 
     auto* return_type = has_return_type(fn_exp) ? get_type(fn_exp.list[4].string, fn_exp.list[0].string)
                                                 : m_IR_BUILDER->getInt64Ty();
@@ -389,7 +761,94 @@ auto MorningLanguageLLVM::extract_function_type(const Exp& fn_exp) -> llvm::Func
     return llvm::FunctionType::get(return_type, param_types, /* varargs */ false);
 }
 
-auto MorningLanguageLLVM::alloc_var(const std::string& name, llvm::Type* var_type, const env& env)
+auto MorningLanguageLLVM::is_unsigned_declaration(const Exp& declaration) -> bool {
+    return declaration.type == ExpType::LIST && declaration.list.size() >= 2
+        && is_unsigned_spelling(declaration.list[1].string);
+}
+
+auto MorningLanguageLLVM::is_unsigned_expression(const Exp& exp, bool unsigned_context) -> bool {
+    if (exp.type == ExpType::NUMBER) {
+        return unsigned_context;
+    }
+
+    if (exp.type == ExpType::SYMBOL) {
+        return m_ENV.is_unsigned(exp.string);
+    }
+
+    if (exp.type != ExpType::LIST || exp.list.empty() || exp.list[0].type != ExpType::SYMBOL) {
+        return false;
+    }
+
+    const auto& tag = exp.list[0];
+    const auto SIZE = exp.list.size();
+
+    switch (tag.string.form()) {
+        case SpecialForm::BINARY_OP: {
+            // Comparisons give booleans
+            const auto OP = ArithmeticCodegen::get_operation(tag.string.str());
+            if ((OP != "+" && OP != "-" && OP != "*" && OP != "/") || SIZE < 3) {
+                return false;
+            }
+            const auto [LEFT, RIGHT] = operand_signs(exp.list[1], exp.list[2], unsigned_context);
+            return LEFT || RIGHT;
+        }
+        case SpecialForm::BIT_AND:
+        case SpecialForm::BIT_OR:
+        case SpecialForm::BIT_XOR: {
+            if (SIZE < 3) {
+                return false;
+            }
+            const auto [LEFT, RIGHT] = operand_signs(exp.list[1], exp.list[2], unsigned_context);
+            return LEFT || RIGHT;
+        }
+        case SpecialForm::BIT_SHL:
+        case SpecialForm::BIT_SHR:
+            return SIZE >= 3 && operand_signs(exp.list[1], exp.list[2], unsigned_context).first;
+        case SpecialForm::BIT_NOT:
+            return SIZE >= 2 && is_unsigned_expression(exp.list[1], unsigned_context);
+        case SpecialForm::INDEX:
+            return SIZE >= 2 && is_unsigned_expression(exp.list[1]);
+        case SpecialForm::MEM_READ:
+        case SpecialForm::MEM_DEREF:
+            return SIZE >= 3 && exp.list[2].type == ExpType::SYMBOL
+                && is_unsigned_spelling(exp.list[2].string);
+        case SpecialForm::BYTE_READ:
+            return true;
+        case SpecialForm::CHECK:
+        case SpecialForm::IF:
+            return SIZE >= 3 && is_unsigned_expression(exp.list[2], unsigned_context);
+        case SpecialForm::SCOPE:
+            return SIZE >= 2 && is_unsigned_expression(exp.list[SIZE - 1], unsigned_context);
+        case SpecialForm::SET:
+            return SIZE >= 2 && is_unsigned_expression(exp.list[SIZE - 1]);
+        case SpecialForm::NONE:
+            return m_ENV.is_unsigned(tag.string);
+        default:
+            return false;
+    }
+}
+
+auto MorningLanguageLLVM::operand_signs(const Exp& left, const Exp& right, bool unsigned_context)
+    -> std::pair<bool, bool> {
+    // A literal operand has the sign of the other operand, whose type it takes
+    if (left.type == ExpType::NUMBER && right.type != ExpType::NUMBER) {
+        const bool RIGHT = is_unsigned_expression(right, unsigned_context);
+        return {RIGHT, RIGHT};
+    }
+
+    const bool LEFT = is_unsigned_expression(left, unsigned_context);
+    return {LEFT, is_unsigned_expression(right, LEFT)};
+}
+
+auto MorningLanguageLLVM::returns_unsigned(const Exp& fn_exp) -> bool {
+    return has_return_type(fn_exp) && is_unsigned_spelling(fn_exp.list[4].string);
+}
+
+auto MorningLanguageLLVM::is_top_level() const -> bool {
+    return m_TOP_LEVEL_DEPTH != 0 && m_ENV.depth() == m_TOP_LEVEL_DEPTH;
+}
+
+auto MorningLanguageLLVM::alloc_var(Symbol name, llvm::Type* var_type, bool is_constant)
     -> llvm::Value* {
     LOG_TRACE
 
@@ -398,35 +857,142 @@ auto MorningLanguageLLVM::alloc_var(const std::string& name, llvm::Type* var_typ
         return nullptr;
     }
 
-    if (env->lookup_by_name(name) != nullptr) {
+    if (m_ENV.is_defined(name)) {
         LOG_WARN("Redeclaration of variable '%s'", name.c_str());
     }
 
-    m_VARS_BUILDER->SetInsertPoint(&m_ACTIVE_FUNCTION->getEntryBlock());
+    // Top-level REPL variables must outlive the input that declared them, and those of a
+    // library unit are shared with its functions; only its consts are exported
+    if (is_top_level()) {
+        auto linkage = m_LIBRARY_UNIT && !is_constant ? llvm::GlobalValue::InternalLinkage
+                                                      : llvm::GlobalValue::ExternalLinkage;
+        auto* global = new llvm::GlobalVariable(*m_MODULE,
+                                                var_type,
+                                                /* constant */ false,
+                                                linkage,
+                                                llvm::Constant::getNullValue(var_type),
+                                                name.str());
+        m_ENV.define(name, global, is_constant);
+        return global;
+    }
 
-    auto* allocated_var = m_VARS_BUILDER->CreateAlloca(var_type, nullptr, name);
+    // Once a loop or branch has terminated the entry block, allocas go before its terminator
+    auto& entry_block = m_ACTIVE_FUNCTION->getEntryBlock();
+    if (auto* terminator = entry_block.getTerminator()) {
+        m_VARS_BUILDER->SetInsertPoint(terminator);
+    } else {
+        m_VARS_BUILDER->SetInsertPoint(&entry_block);
+    }
 
-    env->define(name, allocated_var);
+    auto* allocated_var = m_VARS_BUILDER->CreateAlloca(var_type, nullptr, name.str());
+
+    m_ENV.define(name, allocated_var, is_constant);
 
     return allocated_var;
 }
 
-auto MorningLanguageLLVM::compile_function(const Exp& fn_exp, const std::string& fn_name, const env& env)
+void MorningLanguageLLVM::start_ssa_locals(const Exp& ast) {
+    m_SSA.clear();
+    m_ADDRESS_TAKEN.clear();
+
+    if (m_SSA_LOCALS) {
+        collect_address_taken(ast, m_ADDRESS_TAKEN);
+    }
+}
+
+auto MorningLanguageLLVM::is_register_candidate(Symbol name, llvm::Type* var_type) const -> bool {
+    if (!m_SSA_LOCALS || m_ACTIVE_FUNCTION == nullptr || is_top_level()) {
+        return false;
+    }
+
+    return (var_type->isIntegerTy() || var_type->isFloatingPointTy() || var_type->isPointerTy())
+        && m_ADDRESS_TAKEN.count(name.id()) == 0;
+}
+
+auto MorningLanguageLLVM::define_register_var(Symbol name, llvm::Type* var_type, llvm::Value* value, bool is_constant)
+    -> llvm::Value* {
+    LOG_TRACE
+
+    if (m_ENV.is_defined(name)) {
+        LOG_WARN("Redeclaration of variable '%s'", name.c_str());
+    }
+
+    const auto VARIABLE = m_SSA.declare(var_type, m_ACTIVE_FUNCTION, name.str());
+    m_ENV.define_register(name, VARIABLE, is_constant);
+
+    return write_register_var(VARIABLE, value, name.str());
+}
+
+auto MorningLanguageLLVM::write_register_var(uint32_t variable, llvm::Value* value, const std::string& name)
+    -> llvm::Value* {
+    if (m_SSA.function(variable) != m_ACTIVE_FUNCTION) {
+        LOG_CRITICAL("Variable \"%s\" is local to another function", name.c_str());
+        return value;
+    }
+
+    auto* var_type = m_SSA.type(variable);
+    auto* value_type = value->getType();
+
+    if (value_type != var_type) {
+        if (value_type->isIntegerTy(1) && var_type->isIntegerTy()) {
+            value = m_IR_BUILDER->CreateZExt(value, var_type, name);
+        } else if (value_type->isIntegerTy() && var_type->isIntegerTy()) {
+            value = m_IR_BUILDER->CreateSExtOrTrunc(value, var_type, name);
+        } else if (value_type->isIntegerTy() && var_type->isFloatingPointTy()) {
+            value = m_IR_BUILDER->CreateSIToFP(value, var_type, name);
+        } else if (value_type->isPointerTy() && var_type->isPointerTy()) {
+            value = m_IR_BUILDER->CreatePointerCast(value, var_type, name);
+        } else if (value_type->isPointerTy() && var_type->isIntegerTy()) {
+            value = m_IR_BUILDER->CreatePtrToInt(value, var_type, name);
+        } else if (value_type->isIntegerTy() && var_type->isPointerTy()) {
+            value = m_IR_BUILDER->CreateIntToPtr(value, var_type, name);
+        } else if (value_type->getPrimitiveSizeInBits() == var_type->getPrimitiveSizeInBits()) {
+            value = m_IR_BUILDER->CreateBitCast(value, var_type, name);
+        } else {
+            LOG_CRITICAL("Type mismatch for '%s': cannot assign %s to %s",
+                         name.c_str(),
+                         type_to_string(value_type).c_str(),
+                         type_to_string(var_type).c_str());
+            return value;
+        }
+    }
+
+    m_SSA.write(variable, m_IR_BUILDER->GetInsertBlock(), value);
+    return value;
+}
+
+auto MorningLanguageLLVM::read_register_var(uint32_t variable, const std::string& name) -> llvm::Value* {
+    if (m_SSA.function(variable) != m_ACTIVE_FUNCTION) {
+        LOG_CRITICAL("Variable \"%s\" is local to another function", name.c_str());
+        return llvm::Constant::getNullValue(m_SSA.type(variable));
+    }
+
+    return m_SSA.read(variable, m_IR_BUILDER->GetInsertBlock());
+}
+
+auto MorningLanguageLLVM::compile_function(const Exp& fn_exp, const std::string& fn_name)
     -> llvm::Value* {
-    auto params = fn_exp.list[2];
-    auto body = has_return_type(fn_exp) ? fn_exp.list[5] : fn_exp.list[3];
+    const auto& params = fn_exp.list[2];
+    const auto& body = has_return_type(fn_exp) ? fn_exp.list[5] : fn_exp.list[3];
 
     auto* prev_fn = m_ACTIVE_FUNCTION;
     auto* prev_block = m_IR_BUILDER->GetInsertBlock();
 
-    auto* new_fn = create_function(fn_name, extract_function_type(fn_exp), env);
+    // The JIT already holds functions of earlier REPL inputs and can not replace them
+    if (m_REPL_SYMBOLS.count(fn_name) != 0) {
+        LOG_CRITICAL("Function \"%s\" is already defined by an earlier input", fn_name.c_str());
+    }
+
+    auto* new_fn = create_function(fn_name, extract_function_type(fn_exp));
     m_ACTIVE_FUNCTION = new_fn;
 
     auto idx = 0;
 
-    // auto fn_env = std::make_shared<Environment>(std::map<std::string, llvm::Value*> {}, env);
-    auto fn_env = std::make_shared<Environment>(std::map<std::string, llvm::Value*>(), env);
-    fn_env->define(fn_name, new_fn);
+    m_ENV.push_scope();
+    m_ENV.define(fn_name, new_fn);
+    if (returns_unsigned(fn_exp)) {
+        m_ENV.mark_unsigned(fn_name);
+    }
 
     // Process parameters
     for (auto& arg : m_ACTIVE_FUNCTION->args()) {
@@ -434,9 +1000,9 @@ auto MorningLanguageLLVM::compile_function(const Exp& fn_exp, const std::string&
             LOG_CRITICAL("Too many arguments for function '%s'", fn_name.c_str());
         }
 
-        auto param = params.list[idx];
+        const auto& param = params.list[idx];
         auto arg_name = extract_var_name(param);
-        arg.setName(arg_name);
+        arg.setName(arg_name.str());
 
         // Get parameter type
         llvm::Type* param_type = nullptr;
@@ -447,12 +1013,29 @@ auto MorningLanguageLLVM::compile_function(const Exp& fn_exp, const std::string&
         }
 
         // Allocate and store parameter
-        auto* arg_binding = alloc_var(arg_name, param_type, fn_env);
-        m_IR_BUILDER->CreateStore(&arg, arg_binding);
+        if (is_register_candidate(arg_name, param_type)) {
+            define_register_var(arg_name, param_type, &arg);
+        } else {
+            auto* arg_binding = alloc_var(arg_name, param_type);
+            m_IR_BUILDER->CreateStore(&arg, arg_binding);
+        }
+        if (is_unsigned_declaration(param)) {
+            m_ENV.mark_unsigned(arg_name);
+        }
         idx++;
     }
 
-    m_IR_BUILDER->CreateRet(generate_expression(body, fn_env));
+    // Integer results are converted to the declared return type
+    auto* return_type = new_fn->getReturnType();
+    const bool UNSIGNED_RESULT = returns_unsigned(fn_exp);
+    auto* result = generate_expression(body, return_type, UNSIGNED_RESULT);
+    if (result->getType()->isIntegerTy() && return_type->isIntegerTy()) {
+        result = implicit_cast(
+            result, return_type, *m_IR_BUILDER, is_unsigned_expression(body, UNSIGNED_RESULT));
+    }
+
+    m_IR_BUILDER->CreateRet(result);
+    m_ENV.pop_scope();
 
     m_IR_BUILDER->SetInsertPoint(prev_block);
     m_ACTIVE_FUNCTION = prev_fn;
@@ -460,39 +1043,52 @@ auto MorningLanguageLLVM::compile_function(const Exp& fn_exp, const std::string&
     return new_fn;
 }
 
-auto MorningLanguageLLVM::generate_expression(const Exp& exp, const env& env) -> llvm::Value* {
+auto MorningLanguageLLVM::generate_expression(const Exp& exp, llvm::Type* context_type, bool unsigned_context)
+    -> llvm::Value* {
     LOG_TRACE
 
-    add_expression_to_traceback_stack(exp);
+    PUSH_EXPR_STACK(&exp);
 
     switch (exp.type) {
         case ExpType::NUMBER: {
-            int64_t value = exp.number;
+            const int64_t VALUE = exp.number;
 
-            if (value >= INT8_MIN && value <= INT8_MAX) {
-                return m_IR_BUILDER->getInt8(static_cast<int8_t>(value));
+            if (context_type != nullptr && context_type->isDoubleTy()) {
+                return llvm::ConstantFP::get(context_type, static_cast<double>(VALUE));
             }
-            if (value >= INT16_MIN && value <= INT16_MAX) {
-                return m_IR_BUILDER->getInt16(static_cast<int16_t>(value));
+
+            if (context_type == nullptr || !context_type->isIntegerTy() || context_type->isIntegerTy(1)) {
+                return m_IR_BUILDER->getInt64(static_cast<uint64_t>(VALUE));
             }
-            if (value >= INT32_MIN && value <= INT32_MAX) {
-                return m_IR_BUILDER->getInt32(static_cast<int32_t>(value));
+
+            // Either reading fits: 255 is a valid !int8 bit pattern as well as a valid !uint8
+            const auto BITS = context_type->getIntegerBitWidth();
+            if (!llvm::isIntN(BITS, VALUE) && !llvm::isUIntN(BITS, static_cast<uint64_t>(VALUE))) {
+                LOG_WARN("Literal %lld does not fit %s, truncated",
+                         static_cast<long long>(VALUE),
+                         type_to_string(context_type, unsigned_context).c_str());
             }
-            return m_IR_BUILDER->getInt64(value);
+            return llvm::ConstantInt::get(context_type, static_cast<uint64_t>(VALUE), /* signed */ true);
         }
         case ExpType::FRACTIONAL:
             return llvm::ConstantFP::get(m_IR_BUILDER->getDoubleTy(), exp.fractional);
-        case ExpType::STRING: {
-            auto str = replace_regex_in_string(exp.string);
-
-            return m_IR_BUILDER->CreateGlobalStringPtr(str);
-        }
+        case ExpType::STRING:
+            return get_string_literal(exp.string);
         case ExpType::SYMBOL:
-            if (exp.string == "true" || exp.string == "false") {
-                return m_IR_BUILDER->getInt8(static_cast<uint8_t>(exp.string == "true"));
+            if (auto form = exp.string.form(); form == SpecialForm::TRUE_LITERAL || form == SpecialForm::FALSE_LITERAL) {
+                return m_IR_BUILDER->getInt8(static_cast<uint8_t>(form == SpecialForm::TRUE_LITERAL));
             } else {
                 auto var_name = exp.string;
-                auto* value = env->lookup_by_name(var_name);
+
+                if (auto* folded = m_ENV.lookup_folded(var_name)) {
+                    return folded;
+                }
+
+                if (auto variable = m_ENV.lookup_register(var_name)) {
+                    return read_register_var(*variable, var_name);
+                }
+
+                auto* value = m_ENV.lookup_by_name(var_name);
 
                 // Handle functions separately
                 if (llvm::isa<llvm::Function>(value)) {
@@ -520,856 +1116,117 @@ auto MorningLanguageLLVM::generate_expression(const Exp& exp, const env& env) ->
             }
         case ExpType::LIST:
             if (exp.list.empty()) {
-                LOG_CRITICAL("Empty list expression at line %s", exp.list[1].string.c_str());
+                LOG_CRITICAL("Empty list expression");
             }
 
-            auto oper = exp.list[0].string;
-            if (oper == "+" && exp.list.size() < 3) {
-                LOG_CRITICAL("Operator '+' requires two operands at line %s", exp.list[1].string.c_str());
-            }
-
-            auto tag = exp.list[0];
-
-            if (tag.type == ExpType::SYMBOL) {
-                auto oper = tag.string;
-
-                if (oper == "+" || oper == "-" || oper == "*" || oper == "/" || oper == ">" || oper == "<"
-                    || oper == ">=" || oper == "<=" || oper == "==" || oper == "!="
-                    || oper == "__PLUS_OPERAND__" || oper == "__SUB_OPERAND__" || oper == "__MUL_OPERAND__"
-                    || oper == "__DIV_OPERAND__" || oper == "__CMPG__" || oper == "__CMPL__"
-                    || oper == "__CMPGE__" || oper == "__CMPLE__" || oper == "__CMPEQ__"
-                    || oper == "__CMPNE__")
-                {
-                    auto* left = generate_expression(exp.list[1], env);
-                    auto* right = generate_expression(exp.list[2], env);
-                    return ArithmeticCodegen::generate_binary_op(oper, left, right, *m_IR_BUILDER);
-                }
+            const auto& tag = exp.list[0];
 
-                if (oper == "array") {
-                    LOG_DEBUG("Process array creation");
-
-                    // Handle nested arrays
-                    bool is_nested_array = false;
-                    llvm::Type* element_type = nullptr;
-                    std::vector<llvm::Constant*> elements;
-
-                    for (size_t i = 1; i < exp.list.size(); i++) {
-                        auto* element_val = generate_expression(exp.list[i], env);
-
-                        if (auto* constant = llvm::dyn_cast<llvm::Constant>(element_val)) {
-                            // First element determines type
-                            if (element_type == nullptr) {
-                                element_type = element_val->getType();
-                                is_nested_array = element_type->isArrayTy();
-                            }
-
-                            // Validate type consistency
-                            if (element_val->getType() != element_type) {
-                                LOG_CRITICAL("Array element type mismatch at index %zu", i - 1);
-                            }
-
-                            elements.push_back(constant);
-                        } else {
-                            LOG_CRITICAL("Array element must be constant expression");
-                        }
-                    }
-
-                    if (elements.empty()) {
-                        LOG_CRITICAL("Array cannot be empty");
-                    }
-
-                    // For nested arrays, use the first element's type
-                    if (is_nested_array) {
-                        return llvm::ConstantArray::get(llvm::ArrayType::get(element_type, elements.size()),
-                                                        elements);
-                    }
-
-                    // For simple arrays
-                    return llvm::ConstantArray::get(llvm::ArrayType::get(element_type, elements.size()),
-                                                    elements);
-                }
-
-                if (oper == "sizeof") {
-                    LOG_DEBUG("Process sizeof operator");
-
-                    if (exp.list.size() < 2) {
-                        LOG_CRITICAL("sizeof requires a type argument");
-                    }
-
-                    std::string type_str = exp.list[1].string;
-                    llvm::Type* target_type = get_type(type_str, "sizeof");
-
-                    llvm::DataLayout data_layout(m_MODULE.get());
-                    llvm::TypeSize type_size = data_layout.getTypeAllocSize(target_type);
-                    return m_IR_BUILDER->getInt64(type_size.getFixedValue());
-                }
-
-                if (oper == "mem-alloc") {
-                    LOG_DEBUG("Process memory allocation");
-
-                    auto size_exp = exp.list[1];
-                    auto* size_val = generate_expression(size_exp, env);
-                    auto* malloc_fn = m_MODULE->getFunction("malloc");
-
-                    if (!malloc_fn) {
-                        auto* malloc_type = llvm::FunctionType::get(
-                            m_IR_BUILDER->getInt8Ty()->getPointerTo(), {m_IR_BUILDER->getInt64Ty()}, false);
-                        malloc_fn = llvm::Function::Create(
-                            malloc_type, llvm::Function::ExternalLinkage, "malloc", m_MODULE.get());
-                    }
-
-                    return m_IR_BUILDER->CreateCall(malloc_fn, {size_val}, "malloc");
-                }
-
-                if (oper == "mem-free") {
-                    LOG_DEBUG("Process memory free");
-
-                    auto ptr_exp = exp.list[1];
-                    auto* ptr_val = generate_expression(ptr_exp, env);
-                    auto* free_fn = m_MODULE->getFunction("free");
-
-                    if (!free_fn) {
-                        auto* free_type = llvm::FunctionType::get(
-                            m_IR_BUILDER->getVoidTy(), {m_IR_BUILDER->getInt8Ty()->getPointerTo()}, false);
-                        free_fn = llvm::Function::Create(
-                            free_type, llvm::Function::ExternalLinkage, "free", m_MODULE.get());
-                    }
-
-                    m_IR_BUILDER->CreateCall(free_fn, {ptr_val});
-                    return m_IR_BUILDER->getInt64(0);
-                }
-
-                if (oper == "bit-and" || oper == "bit-or" || oper == "bit-xor" ||
-                    oper == "bit-shl" || oper == "bit-shr" || oper == "bit-not") {
-
-                    if (oper == "bit-not") {
-                        auto* value = generate_expression(exp.list[1], env);
-
-                        if (!value->getType()->isIntegerTy()) {
-                            LOG_CRITICAL("Bitwise operation requires integer operand, got %s",
-                                        type_to_string(value->getType()).c_str());
-                        }
-
-                        return m_IR_BUILDER->CreateNot(value, "bit_not");
-                    }
-
-                    auto* left = generate_expression(exp.list[1], env);
-                    auto* right = generate_expression(exp.list[2], env);
-
-                    if (!left->getType()->isIntegerTy() || !right->getType()->isIntegerTy()) {
-                        LOG_CRITICAL("Bitwise operation requires integer operands, got %s and %s",
-                                    type_to_string(left->getType()).c_str(),
-                                    type_to_string(right->getType()).c_str());
-                    }
-
-                    llvm::Type* common_type = nullptr;
-                    if (left->getType() != right->getType()) {
-                        unsigned left_size = left->getType()->getIntegerBitWidth();
-                        unsigned right_size = right->getType()->getIntegerBitWidth();
-                        unsigned max_size = std::max(left_size, right_size);
-                        common_type = m_IR_BUILDER->getIntNTy(max_size);
-
-                        left = m_IR_BUILDER->CreateZExtOrTrunc(left, common_type);
-                        right = m_IR_BUILDER->CreateZExtOrTrunc(right, common_type);
-                    } else {
-                        common_type = left->getType();
-                    }
-
-                    if (oper == "bit-and") {
-                        return m_IR_BUILDER->CreateAnd(left, right, "bit_and");
-                    }
-                    if (oper == "bit-or") {
-                        return m_IR_BUILDER->CreateOr(left, right, "bit_or");
-                    }
-                    if (oper == "bit-xor") {
-                        return m_IR_BUILDER->CreateXor(left, right, "bit_xor");
-                    }
-                    if (oper == "bit-shl") {
-                        return m_IR_BUILDER->CreateShl(left, right, "bit_shl");
-                    }
-                    if (oper == "bit-shr") {
-                        return m_IR_BUILDER->CreateLShr(left, right, "bit_shr");
-                    }
-                }
-
-                if (oper == "byte-read") {
-                    auto* ptr = generate_expression(exp.list[1], env);
-                    auto* casted_ptr =
-                        m_IR_BUILDER->CreateBitCast(ptr, m_IR_BUILDER->getInt8Ty()->getPointerTo());
-                    return m_IR_BUILDER->CreateLoad(m_IR_BUILDER->getInt8Ty(), casted_ptr, "byte_read");
-                }
-                if (oper == "byte-write") {
-                    auto* ptr = generate_expression(exp.list[1], env);
-                    auto* value = generate_expression(exp.list[2], env);
-                    auto* casted_ptr =
-                        m_IR_BUILDER->CreateBitCast(ptr, m_IR_BUILDER->getInt8Ty()->getPointerTo());
-                    return m_IR_BUILDER->CreateStore(
-                        m_IR_BUILDER->CreateTrunc(value, m_IR_BUILDER->getInt8Ty()), casted_ptr);
-                }
-
-                if (oper == "mem-write") {
-                    LOG_DEBUG("Process memory write");
-
-                    auto ptr_exp = exp.list[1];
-                    auto value_exp = exp.list[2];
-                    auto* ptr_val = generate_expression(ptr_exp, env);
-                    auto* value_val = generate_expression(value_exp, env);
-
-                    auto* casted_ptr = m_IR_BUILDER->CreateBitCast(
-                        ptr_val, value_val->getType()->getPointerTo(), "cast_ptr");
-                    m_IR_BUILDER->CreateStore(value_val, casted_ptr);
-                    return value_val;
-                }
-
-                if (oper == "mem-read") {
-                    LOG_DEBUG("Process memory read");
-
-                    auto ptr_exp = exp.list[1];
-                    auto type_exp = exp.list[2];
-                    auto* ptr_val = generate_expression(ptr_exp, env);
-                    auto* target_type = get_type(type_exp.string, "mem_read");
-
-                    auto* casted_ptr =
-                        m_IR_BUILDER->CreateBitCast(ptr_val, target_type->getPointerTo(), "cast_ptr");
-                    return m_IR_BUILDER->CreateLoad(target_type, casted_ptr, "load");
-                }
-
-                if (oper == "mem-ptr") {
-                    LOG_DEBUG("Process get pointer");
-
-                    auto var_name = exp.list[1].string;
-                    auto* var_ptr = env->lookup_by_name(var_name);
-
-                    return m_IR_BUILDER->CreateBitCast(
-                        var_ptr, m_IR_BUILDER->getInt8Ty()->getPointerTo(), "to_void_ptr");
-                }
-
-                if (oper == "mem-deref") {
-                    LOG_DEBUG("Process pointer dereference");
-
-                    auto ptr_exp = exp.list[1];
-                    auto type_exp = exp.list[2];
-                    auto* ptr_val = generate_expression(ptr_exp, env);
-                    auto* target_type = get_type(type_exp.string, "mem_deref");
-
-                    auto* casted_ptr =
-                        m_IR_BUILDER->CreateBitCast(ptr_val, target_type->getPointerTo(), "cast_ptr");
-                    return m_IR_BUILDER->CreateLoad(target_type, casted_ptr, "deref");
-                }
-
-                if (oper == "index") {
-                    LOG_DEBUG("Process array indexing");
-
-                    if (exp.list.size() != 3) {
-                        LOG_CRITICAL("index operation requires 2 arguments");
-                    }
-
-                    // First argument must be symbol (array name)
-                    if (exp.list[1].type != ExpType::SYMBOL) {
-                        LOG_CRITICAL("index: first argument must be array name");
-                    }
-
-                    const std::string& array_name = exp.list[1].string;
-                    auto array_type_it = m_ARRAY_TYPES.find(array_name);
-                    if (array_type_it == m_ARRAY_TYPES.end()) {
-                        LOG_CRITICAL("Array '%s' not found", array_name.c_str());
-                    }
-
-                    llvm::ArrayType* array_type = array_type_it->second;
-                    llvm::Value* array_ptr = env->lookup_by_name(array_name);
-                    llvm::Value* index_val = generate_expression(exp.list[2], env);
-
-                    // Validate index type
-                    if (!index_val->getType()->isIntegerTy()) {
-                        LOG_CRITICAL("Array index must be integer type");
-                    }
-
-                    // Create GEP (getelementptr) for array element
-                    llvm::Value* zero = m_IR_BUILDER->getInt64(0);
-                    std::vector<llvm::Value*> indices = {zero, index_val};
-                    llvm::Value* element_ptr =
-                        m_IR_BUILDER->CreateInBoundsGEP(array_type, array_ptr, indices, "elementptr");
-
-                    return m_IR_BUILDER->CreateLoad(array_type->getElementType(), element_ptr, "loadarray");
-                }
-
-                if (oper == "if") {
-                    LOG_DEBUG("Process if-elif-else: %s", exp.list[1].string.c_str());
-
-                    if (exp.list.size() < 4) {
-                        LOG_CRITICAL("if requires at least 4 arguments: condition, block, else, else_block",
-                                     exp.string.c_str());
-                    }
-
-                    auto* merge_block = create_basic_block("if.end");
-                    std::vector<llvm::Value*> branch_values;
-                    std::vector<llvm::BasicBlock*> branch_blocks;
-
-                    auto* current_block = m_IR_BUILDER->GetInsertBlock();
-                    m_IR_BUILDER->SetInsertPoint(current_block);
-
-                    size_t i = 1;
-                    llvm::BasicBlock* next_block = nullptr;
-
-                    while (i < exp.list.size()) {
-                        if (exp.list[i].type == ExpType::SYMBOL
-                            && (exp.list[i].string == "else" || exp.list[i].string == "elif"))
-                        {
-                            break;
-                        }
-
-                        if (i + 1 >= exp.list.size()) {
-                            LOG_CRITICAL("if: missing block for condition", exp.string.c_str());
-                        }
-
-                        auto* cond = generate_expression(exp.list[i], env);
-                        auto* then_block = create_basic_block("if.then", m_ACTIVE_FUNCTION);
-                        next_block = create_basic_block("if.next", m_ACTIVE_FUNCTION);
-
-                        m_IR_BUILDER->CreateCondBr(cond, then_block, next_block);
-
-                        m_IR_BUILDER->SetInsertPoint(then_block);
-                        auto* then_val = generate_expression(exp.list[i + 1], env);
-                        branch_values.push_back(then_val);
-                        branch_blocks.push_back(then_block);
-                        m_IR_BUILDER->CreateBr(merge_block);
-
-                        m_IR_BUILDER->SetInsertPoint(next_block);
-                        current_block = next_block;
-                        i += 2;
-                    }
-
-                    while (i < exp.list.size()) {
-                        if (exp.list[i].type == ExpType::SYMBOL && exp.list[i].string == "elif") {
-                            if (i + 2 >= exp.list.size()) {
-                                LOG_CRITICAL("elif requires condition and block", exp.string.c_str());
-                            }
-
-                            auto* cond = generate_expression(exp.list[i + 1], env);
-                            auto* elif_block = create_basic_block("elif.then", m_ACTIVE_FUNCTION);
-                            next_block = create_basic_block("elif.next", m_ACTIVE_FUNCTION);
-
-                            m_IR_BUILDER->CreateCondBr(cond, elif_block, next_block);
-
-                            m_IR_BUILDER->SetInsertPoint(elif_block);
-                            auto* elif_val = generate_expression(exp.list[i + 2], env);
-                            branch_values.push_back(elif_val);
-                            branch_blocks.push_back(elif_block);
-                            m_IR_BUILDER->CreateBr(merge_block);
-
-                            m_IR_BUILDER->SetInsertPoint(next_block);
-                            current_block = next_block;
-                            i += 3;
-                        } else if (exp.list[i].type == ExpType::SYMBOL && exp.list[i].string == "else") {
-                            if (i + 1 >= exp.list.size()) {
-                                LOG_CRITICAL("else requires block", exp.string.c_str());
-                            }
-
-                            auto* else_block = m_IR_BUILDER->GetInsertBlock();
-                            auto* else_val = generate_expression(exp.list[i + 1], env);
-                            branch_values.push_back(else_val);
-                            branch_blocks.push_back(else_block);
-                            m_IR_BUILDER->CreateBr(merge_block);
-                            i += 2;
-                            break;
-                        } else {
-                            LOG_CRITICAL("expected elif or else after if conditions", exp.string.c_str());
-                        }
-                    }
-
-                    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), merge_block);
-                    m_IR_BUILDER->SetInsertPoint(merge_block);
-
-                    if (!branch_values.empty()) {
-                        auto* first_type = branch_values[0]->getType();
-                        for (auto* val : branch_values) {
-                            if (val->getType() != first_type) {
-                                LOG_CRITICAL("if: all branches must return same type", exp.string.c_str());
-                            }
-                        }
-
-                        auto* phi = m_IR_BUILDER->CreatePHI(first_type, branch_values.size(), "if_result");
-                        for (size_t idx = 0; idx < branch_values.size(); idx++) {
-                            phi->addIncoming(branch_values[idx], branch_blocks[idx]);
-                        }
-                        return phi;
-                    }
-
-                    return m_IR_BUILDER->getInt64(0);
-                }
-
-                // Loop
-                if (oper == "loop") {
-                    LOG_DEBUG("Process loop");
-                    auto* loop_body = create_basic_block("loop.body", m_ACTIVE_FUNCTION);
-                    auto* loop_exit = create_basic_block("loop.exit");
-
-                    m_IR_BUILDER->CreateBr(loop_body);
-                    m_IR_BUILDER->SetInsertPoint(loop_body);
-
-                    LoopBlocks const LOOP_BLOCKS = {loop_exit, loop_body};
-                    m_LOOP_STACK.push_back(LOOP_BLOCKS);
-
-                    for (size_t i = 1; i < exp.list.size(); i++) {
-                        generate_expression(exp.list[i], env);
-                    }
-
-                    if (m_IR_BUILDER->GetInsertBlock()->getTerminator() == nullptr) {
-                        m_IR_BUILDER->CreateBr(loop_body);
-                    }
-
-                    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), loop_exit);
-                    m_IR_BUILDER->SetInsertPoint(loop_exit);
-                    m_LOOP_STACK.pop_back();
-
-                    return m_IR_BUILDER->getInt64(0);
-                }
-
-                // Func
-                if (oper == "func") {
-                    LOG_DEBUG("Process function: %s", exp.list[1].string.c_str());
-
-                    if (exp.list.size() < 4) {
-                        LOG_CRITICAL("Function definition requires at least 3 parts (name, params, body)");
-                        return m_IR_BUILDER->getInt64(0);
-                    }
-
-                    auto* fn = compile_function(exp, /* name */ exp.list[1].string, env);
-                    env->define(exp.list[1].string, fn);
-                    return fn;
-                }
-
-                // While
-                if (oper == "while") {
-                    LOG_DEBUG("Process while loop");
-
-                    auto* break_blog = create_basic_block("break");
-                    auto* continue_block = create_basic_block("continue");
-                    m_LOOP_STACK.push_back({break_blog, continue_block});
-
-                    auto* condition_block = create_basic_block("cond", m_ACTIVE_FUNCTION);
-                    m_IR_BUILDER->CreateBr(condition_block);
-
-                    auto* body_block = create_basic_block("body");
-
-                    m_IR_BUILDER->SetInsertPoint(condition_block);
-                    auto* condition = generate_expression(exp.list[1], env);
-                    m_IR_BUILDER->CreateCondBr(condition, body_block, break_blog);
-
-                    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), body_block);
-                    m_IR_BUILDER->SetInsertPoint(body_block);
-                    generate_expression(exp.list[2], env);
-                    if (m_IR_BUILDER->GetInsertBlock()->getTerminator() == nullptr) {
-                        m_IR_BUILDER->CreateBr(continue_block);
-                    }
-
-                    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), continue_block);
-                    m_IR_BUILDER->SetInsertPoint(continue_block);
-                    m_IR_BUILDER->CreateBr(condition_block);
-
-                    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), break_blog);
-                    m_IR_BUILDER->SetInsertPoint(break_blog);
-                    m_LOOP_STACK.pop_back();
-
-                    return m_IR_BUILDER->getInt64(0);
-                }
-
-                if (oper == "for") {
-                    LOG_DEBUG("Process for loop");
-
-                    auto init = exp.list[1];
-                    auto condition = exp.list[2];
-                    auto step = exp.list[3];
-                    auto body = exp.list[4];
-
-                    // `for` environment
-                    auto for_env = std::make_shared<Environment>(std::map<std::string, llvm::Value*>(), env);
-
-                    // Generate init expression
-                    generate_expression(init, for_env);
-
-                    // Create blocks
-                    auto* cond_block = create_basic_block("for.cond", m_ACTIVE_FUNCTION);
-                    auto* body_block = create_basic_block("for.body");
-                    auto* step_block = create_basic_block("for.step");
-                    auto* break_blog = create_basic_block("for.break");
-
-                    // Conditions
-                    m_IR_BUILDER->CreateBr(cond_block);
-
-                    // Conditions block
-                    m_IR_BUILDER->SetInsertPoint(cond_block);
-                    auto* cond_value = generate_expression(condition, for_env);
-                    m_IR_BUILDER->CreateCondBr(cond_value, body_block, break_blog);
-
-                    // Body block
-                    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), body_block);
-                    m_IR_BUILDER->SetInsertPoint(body_block);
-                    m_LOOP_STACK.push_back({break_blog, step_block});
-                    generate_expression(body, for_env);
-                    m_LOOP_STACK.pop_back();
-
-                    // Step
-                    if (m_IR_BUILDER->GetInsertBlock()->getTerminator() == nullptr) {
-                        m_IR_BUILDER->CreateBr(step_block);
-                    }
-
-                    // Step block
-                    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), step_block);
-                    m_IR_BUILDER->SetInsertPoint(step_block);
-                    generate_expression(step, for_env);
-                    m_IR_BUILDER->CreateBr(cond_block);
-
-                    // Break blog
-                    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), break_blog);
-                    m_IR_BUILDER->SetInsertPoint(break_blog);
-
-                    return m_IR_BUILDER->getInt64(0);
-                }
-
-                if (oper == "break") {
-                    LOG_DEBUG("Process break");
-
-                    if (m_LOOP_STACK.empty()) {
-                        LOG_CRITICAL("break outside of loop", exp.string.c_str());
-                    }
-
-                    auto& loop = m_LOOP_STACK.back();
-                    m_IR_BUILDER->CreateBr(loop.break_blog);
-
-                    auto* after = create_basic_block("after_break");
-                    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), after);
-                    m_IR_BUILDER->SetInsertPoint(after);
-
-                    return m_IR_BUILDER->getInt64(0);
-                }
-
-                if (oper == "continue") {
-                    LOG_DEBUG("Process continue");
-
-                    if (m_LOOP_STACK.empty()) {
-                        LOG_CRITICAL("continue outside of loop", exp.string.c_str());
-                    }
-                    auto& loop = m_LOOP_STACK.back();
-                    m_IR_BUILDER->CreateBr(loop.continue_block);
-
-                    auto* after = create_basic_block("after_continue");
-                    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), after);
-                    m_IR_BUILDER->SetInsertPoint(after);
-
-                    return m_IR_BUILDER->getInt64(0);
-                }
-
-                // if-then-else. Short condition without else-if/elif blocks.
-                if (oper == "check") {
-                    LOG_DEBUG("Process check (if-then-else)");
-
-                    auto* condition = generate_expression(exp.list[1], env);
-
-                    auto* then_block = create_basic_block("then", m_ACTIVE_FUNCTION);
-                    auto* else_block = create_basic_block("else");
-                    auto* if_end_block = create_basic_block("ifend");
-
-                    m_IR_BUILDER->CreateCondBr(condition, then_block, else_block);
-
-                    // Then branch
-                    m_IR_BUILDER->SetInsertPoint(then_block);
-                    auto* then_res = generate_expression(exp.list[2], env);
-
-                    if (m_IR_BUILDER->GetInsertBlock()->getTerminator() == nullptr) {
-                        m_IR_BUILDER->CreateBr(if_end_block);
-                    }
-                    then_block = m_IR_BUILDER->GetInsertBlock();
-
-                    // Else branch
-                    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), else_block);
-                    m_IR_BUILDER->SetInsertPoint(else_block);
-                    auto* else_res = generate_expression(exp.list[3], env);
-                    if (m_IR_BUILDER->GetInsertBlock()->getTerminator() == nullptr) {
-                        m_IR_BUILDER->CreateBr(if_end_block);
-                    }
-                    else_block = m_IR_BUILDER->GetInsertBlock();
-
-                    // If-end block
-                    m_ACTIVE_FUNCTION->insert(m_ACTIVE_FUNCTION->end(), if_end_block);
-                    m_IR_BUILDER->SetInsertPoint(if_end_block);
-
-                    auto* phi = m_IR_BUILDER->CreatePHI(then_res->getType(), 2, "__tmpcheck__");
-                    phi->addIncoming(then_res, then_block);
-                    phi->addIncoming(else_res, else_block);
-                    return phi;
-                }
-
-                if (oper == "set") {
-                    if (exp.list[1].type == ExpType::LIST && !exp.list[1].list.empty()
-                        && exp.list[1].list[0].string == "index")
-                    {
-                        const Exp& index_exp = exp.list[1];
-
-                        if (index_exp.list.size() != 3) {
-                            LOG_CRITICAL("index in set requires 2 arguments");
-                        }
-
-                        // First argument must be symbol (array name)
-                        if (index_exp.list[1].type != ExpType::SYMBOL) {
-                            LOG_CRITICAL("index: first argument must be array name");
-                        }
-
-                        const std::string& array_name = index_exp.list[1].string;
-                        auto array_type_it = m_ARRAY_TYPES.find(array_name);
-                        if (array_type_it == m_ARRAY_TYPES.end()) {
-                            LOG_CRITICAL("Array '%s' not found", array_name.c_str());
-                        }
-
-                        llvm::ArrayType* array_type = array_type_it->second;
-                        llvm::Value* array_ptr = env->lookup_by_name(array_name);
-                        llvm::Value* index_val = generate_expression(index_exp.list[2], env);
-                        llvm::Value* value = generate_expression(exp.list[2], env);
-
-                        // Validate index type
-                        if (!index_val->getType()->isIntegerTy()) {
-                            LOG_CRITICAL("Array index must be integer type");
-                        }
-
-                        // Create GEP (getelementptr) for array element
-                        llvm::Value* zero = m_IR_BUILDER->getInt64(0);
-                        std::vector<llvm::Value*> indices = {zero, index_val};
-                        llvm::Value* element_ptr =
-                            m_IR_BUILDER->CreateInBoundsGEP(array_type, array_ptr, indices, "setptr");
-
-                        // Cast value to element type if needed
-                        value = implicit_cast(value, array_type->getElementType(), *m_IR_BUILDER);
-
-                        m_IR_BUILDER->CreateStore(value, element_ptr);
-                        return value;
-                    }
-
-                    auto var_name = exp.list[1].string;
-
-                    LOG_DEBUG("Process set value to var: %s", var_name.c_str());
-
-                    if (m_CONSTANTS.count(var_name) != 0U) {
-                        LOG_CRITICAL("Var name \"%s\" is constant", var_name.c_str());
-                        return m_IR_BUILDER->getInt64(0);
-                    }
-
-                    auto* value = generate_expression(exp.list[2], env);
-                    auto* var_binding = env->lookup_by_name(var_name);
-
-                    // Get actual variable type
-                    llvm::Type* var_type = nullptr;
-                    if (auto* alloca = llvm::dyn_cast<llvm::AllocaInst>(var_binding)) {
-                        var_type = alloca->getAllocatedType();
-                    } else if (auto* global = llvm::dyn_cast<llvm::GlobalVariable>(var_binding)) {
-                        var_type = global->getValueType();
-                    }
-
-                    // Validate type
-                    if (value->getType() != var_type && type_to_string(value->getType()) != type_to_string(var_type)) {
-                        // Allow implicit int->frac conversion
-                        if (value->getType()->isIntegerTy() && var_type->isDoubleTy()) {
-                            value = m_IR_BUILDER->CreateSIToFP(value, var_type, "castset");
-                        } else {
-                            LOG_CRITICAL("Type mismatch for '%s': cannot assign %s to %s",
-                                        var_name.c_str(),
-                                        type_to_string(value->getType()).c_str(),
-                                        type_to_string(var_type).c_str());
-                        }
-                    }
-
-                    m_IR_BUILDER->CreateStore(value, var_binding);
-
-                    return value;
-                }
-
-                if (oper == "var" || oper == "const") {
-                    auto var_name_declaration = exp.list[1];
-                    auto var_name = extract_var_name(var_name_declaration);
-
-                    if (m_CONSTANTS.count(var_name) != 0U || m_VARIABLES.count(var_name) != 0U) {
-                        LOG_CRITICAL("Var \"%s\" is already defined", var_name.c_str());
-                        return m_IR_BUILDER->getInt64(0);
-                    }
-
-                    LOG_DEBUG("Process create %s: %s", oper.c_str(), var_name.c_str());
-
-                    auto* init = generate_expression(exp.list[2], env);
-                    auto* var_type = extract_var_type(var_name_declaration);
-
-                    if (llvm::isa<llvm::ArrayType>(var_type)) {
-                        m_ARRAY_TYPES[var_name] = llvm::cast<llvm::ArrayType>(var_type);
-                    }
-
-                    // Validate type
-                    if (init->getType() != var_type && type_to_string(var_type) == "!int"
-                        || type_to_string(var_type) == "!frac")
-                    {
-                        // Allow implicit int->frac conversion
-                        if (init->getType()->isIntegerTy() && var_type->isDoubleTy()) {
-                            init = m_IR_BUILDER->CreateSIToFP(init, var_type, "castinit");
-                        } else {
-                            LOG_CRITICAL("Type mismatch for '%s': declared as %s but initialized with %s",
-                                         var_name.c_str(),
-                                         type_to_string(var_type).c_str(),
-                                         type_to_string(init->getType()).c_str());
-                        }
-                    }
-
-                    auto* var_binding = alloc_var(var_name, var_type, env);
-
-                    if (oper == "const") {
-                        m_CONSTANTS[var_name] = var_binding;
-                    } else {
-                        m_VARIABLES[var_name] = var_binding;
-                    }
-
-                    return m_IR_BUILDER->CreateStore(init, var_binding);
-                }
-
-                if (oper == "scope") {
-                    LOG_DEBUG("Process scope");
-
-                    llvm::Value* block_res = nullptr;
-
-                    auto block_env =
-                        std::make_shared<Environment>(std::map<std::string, llvm::Value*> {}, env);
-
-                    for (auto i = 1; i < exp.list.size(); i++) {
-                        block_res = generate_expression(exp.list[i], block_env);
-                    }
-
-                    return block_res;
-                }
-
-                if (oper == "fprint") {
-                    LOG_DEBUG("Process fprint");
-                    auto* printf_function = m_MODULE->getFunction("printf");
-                    std::vector<llvm::Value*> args {};
-
-                    for (auto i = 1; i < exp.list.size(); ++i) {
-                        args.push_back(generate_expression(exp.list[i], env));
-                    }
-
-                    return m_IR_BUILDER->CreateCall(printf_function, args);
-                }
-
-                if (oper == "finput") {
-                    LOG_DEBUG("Process finput");
-
-                    auto* scanf_fn = m_MODULE->getFunction("scanf");
-                    std::vector<llvm::Value*> args;
-
-                    // Automatically convert %s to %[^\n] for string inputs
-                    auto format_exp = exp.list[1];
-                    std::string format_str = (format_exp.type == ExpType::STRING) ? format_exp.string : "";
-                    bool has_string_input = false;
-
-                    // Check for string arguments
-                    for (size_t i = 2; i < exp.list.size(); ++i) {
-                        std::string var_name = exp.list[i].string;
-                        llvm::Value* var_ptr = env->lookup_by_name(var_name);
-                        if (var_ptr->getType()->isPointerTy()) {
-                            has_string_input = true;
-                            break;
-                        }
-                    }
-
-                    if (has_string_input && format_str.find("%s") != std::string::npos) {
-                        // Replace all %s with %[^\n] to read full lines
-                        size_t pos = 0;
-                        while ((pos = format_str.find("%s", pos)) != std::string::npos) {
-                            format_str.replace(pos, 2, "%[^\n]");
-                            pos += 6; // Move past the replacement
-                        }
-                    }
-
-                    // Create format string constant
-                    auto* format_const = m_IR_BUILDER->CreateGlobalStringPtr(format_str);
-                    args.push_back(format_const);
-
-                    // Process variables and create buffers
-                    for (size_t i = 2; i < exp.list.size(); ++i) {
-                        std::string var_name = exp.list[i].string;
-                        llvm::Value* var_ptr = env->lookup_by_name(var_name);
-
-                        if (var_ptr->getType()->isPointerTy()) {
-                            // Allocate 256-byte buffer on stack
-                            auto* buffer_type = llvm::ArrayType::get(
-                                m_IR_BUILDER->getInt8Ty(), 256);
-                            auto* buffer = m_IR_BUILDER->CreateAlloca(
-                                buffer_type, nullptr, "input_buffer");
-                            auto* buffer_ptr = m_IR_BUILDER->CreateBitCast(
-                                buffer, m_IR_BUILDER->getInt8Ty()->getPointerTo());
-
-                            // Store buffer pointer in variable
-                            m_IR_BUILDER->CreateStore(buffer_ptr, var_ptr);
-                            args.push_back(buffer_ptr);
-                        } else {
-                            args.push_back(var_ptr);
-                        }
-                    }
+            // Lists headed by anything but a symbol have no meaning yet
+            if (tag.type != ExpType::SYMBOL) {
+                return m_IR_BUILDER->getInt64(0);
+            }
 
-                    auto* scanf_call = m_IR_BUILDER->CreateCall(scanf_fn, args);
-
-                    // Add buffer cleaning after scanf
-                    if (has_string_input) {
-                        auto* getchar_fn = m_MODULE->getFunction("getchar");
-                        if (!getchar_fn) {
-                            getchar_fn = llvm::Function::Create(
-                                llvm::FunctionType::get(m_IR_BUILDER->getInt64Ty(), false),
-                                llvm::Function::ExternalLinkage,
-                                "getchar",
-                                m_MODULE.get()
-                            );
-                        }
-
-                        // Create blocks for cleaning loop
-                        auto* loop_block = create_basic_block("clean_loop", m_ACTIVE_FUNCTION);
-                        auto* end_block = create_basic_block("clean_end", m_ACTIVE_FUNCTION);
-
-                        m_IR_BUILDER->CreateBr(loop_block);
-                        m_IR_BUILDER->SetInsertPoint(loop_block);
-
-                        // Read characters until newline or EOF
-                        auto* ch = m_IR_BUILDER->CreateCall(getchar_fn, {}, "ch");
-                        auto* is_newline = m_IR_BUILDER->CreateICmpEQ(
-                            ch, m_IR_BUILDER->getInt64('\n'), "is_newline");
-                        auto* is_eof = m_IR_BUILDER->CreateICmpEQ(
-                            ch, m_IR_BUILDER->getInt64(-1), "is_eof");
-                        auto* should_break = m_IR_BUILDER->CreateOr(
-                            is_newline, is_eof, "break_cond");
-
-                        m_IR_BUILDER->CreateCondBr(should_break, end_block, loop_block);
-                        m_IR_BUILDER->SetInsertPoint(end_block);
+            switch (tag.string.form()) {
+                case SpecialForm::BINARY_OP: {
+                    if (exp.list.size() < 3) {
+                        LOG_CRITICAL("Operator '%s' requires two operands", tag.string.c_str());
                     }
 
-                    return scanf_call;
-                }
-
-                // Function calls
-
-                LOG_DEBUG("Process function call: %s", exp.list[0].string.c_str());
-
-                auto* callable = generate_expression(exp.list[0], env);
-
-                std::vector<llvm::Value*> args {};
-
-                for (auto i = 1; i < exp.list.size(); i++) {
-                    args.push_back(generate_expression(exp.list[i], env));
+                    // Comparisons give booleans, their operands are only typed by each other
+                    const auto OP = ArithmeticCodegen::get_operation(tag.string.str());
+                    const bool IS_ARITHMETIC = OP == "+" || OP == "-" || OP == "*" || OP == "/";
+
+                    const bool UNSIGNED_OPERANDS = IS_ARITHMETIC && unsigned_context;
+                    auto [left, right] = generate_operands(
+                        exp.list[1], exp.list[2], IS_ARITHMETIC ? context_type : nullptr, UNSIGNED_OPERANDS);
+                    const auto [LEFT_UNSIGNED, RIGHT_UNSIGNED] =
+                        operand_signs(exp.list[1], exp.list[2], UNSIGNED_OPERANDS);
+                    return ArithmeticCodegen::generate_binary_op(
+                        tag.string, left, right, *m_IR_BUILDER, LEFT_UNSIGNED, RIGHT_UNSIGNED);
                 }
-
-                auto* fn = (llvm::Function*)callable;
-
-                return m_IR_BUILDER->CreateCall(fn, args);
+                case SpecialForm::ARRAY:
+                    return generate_array(exp, context_type, unsigned_context);
+                case SpecialForm::INDEX:
+                    return generate_index(exp);
+                case SpecialForm::SIZEOF:
+                    return generate_sizeof(exp);
+                case SpecialForm::MEM_ALLOC:
+                    return generate_mem_alloc(exp);
+                case SpecialForm::MEM_FREE:
+                    return generate_mem_free(exp);
+                case SpecialForm::MEM_WRITE:
+                    return generate_mem_write(exp);
+                case SpecialForm::MEM_READ:
+                    return generate_mem_read(exp);
+                case SpecialForm::MEM_PTR:
+                    return generate_mem_ptr(exp);
+                case SpecialForm::MEM_DEREF:
+                    return generate_mem_deref(exp);
+                case SpecialForm::BIT_AND:
+                case SpecialForm::BIT_OR:
+                case SpecialForm::BIT_XOR:
+                case SpecialForm::BIT_SHL:
+                case SpecialForm::BIT_SHR:
+                case SpecialForm::BIT_NOT:
+                    return generate_bitwise(exp, context_type, unsigned_context);
+                case SpecialForm::BYTE_READ:
+                    return generate_byte_read(exp);
+                case SpecialForm::BYTE_WRITE:
+                    return generate_byte_write(exp);
+                case SpecialForm::IF:
+                    return generate_if(exp, context_type, unsigned_context);
+                case SpecialForm::CHECK:
+                    return generate_check(exp, context_type, unsigned_context);
+                case SpecialForm::LOOP:
+                    return generate_loop(exp);
+                case SpecialForm::WHILE:
+                    return generate_while(exp);
+                case SpecialForm::FOR:
+                    return generate_for(exp);
+                case SpecialForm::BREAK:
+                    return generate_break(exp);
+                case SpecialForm::CONTINUE:
+                    return generate_continue(exp);
+                case SpecialForm::SCOPE:
+                    return generate_scope(exp, context_type, unsigned_context);
+                case SpecialForm::FUNC:
+                    return generate_function(exp);
+                case SpecialForm::SET:
+                    return generate_set(exp);
+                case SpecialForm::VAR:
+                case SpecialForm::CONST:
+                    return generate_var(exp);
+                case SpecialForm::FPRINT:
+                    return generate_fprint(exp);
+                case SpecialForm::FINPUT:
+                    return generate_finput(exp);
+                case SpecialForm::IMPORT:
+                    return generate_import(exp);
+                case SpecialForm::TYPE:
+                    return generate_type_alias(exp);
+                default:
+                    return generate_call(exp);
             }
-
-            return m_IR_BUILDER->getInt64(0);
-            break;
     }
 
     return m_IR_BUILDER->getInt64(0);
 }
 
+auto MorningLanguageLLVM::generate_operands(const Exp& left,
+                                             const Exp& right,
+                                             llvm::Type* context_type,
+                                             bool unsigned_context) -> std::pair<llvm::Value*, llvm::Value*> {
+    // A literal takes the type of the other operand, so [+ x 1] needs no casts
+    if (left.type == ExpType::NUMBER && right.type != ExpType::NUMBER) {
+        auto* right_value = generate_expression(right, context_type, unsigned_context);
+        return {generate_expression(left, right_value->getType()), right_value};
+    }
+
+    auto* left_value = generate_expression(left, context_type, unsigned_context);
+    const bool LEFT_UNSIGNED = is_unsigned_expression(left, unsigned_context);
+    return {left_value, generate_expression(right, left_value->getType(), LEFT_UNSIGNED)};
+}
+
 void MorningLanguageLLVM::setup_extern_functions() {
     LOG_TRACE
 
@@ -1390,7 +1247,7 @@ void MorningLanguageLLVM::setup_extern_functions() {
         llvm::FunctionType::get(m_IR_BUILDER->getInt64Ty(), false));
 }
 
-auto MorningLanguageLLVM::create_function(const std::string& name, llvm::FunctionType* type, const env& env)
+auto MorningLanguageLLVM::create_function(const std::string& name, llvm::FunctionType* type)
     -> llvm::Function* {
     LOG_TRACE
 
@@ -1398,14 +1255,13 @@ auto MorningLanguageLLVM::create_function(const std::string& name, llvm::Functio
         return existing;
     }
 
-    auto* func = create_function_prototype(name, type, env);
+    auto* func = create_function_prototype(name, type);
     setup_function_body(func);
     return func;
 }
 
 auto MorningLanguageLLVM::create_function_prototype(const std::string& name,
-                                                    llvm::FunctionType* type,
-                                                    const env& env) -> llvm::Function* {
+                                                    llvm::FunctionType* type) -> llvm::Function* {
     LOG_TRACE
 
     auto* func = llvm::Function::Create(type,
@@ -1415,7 +1271,7 @@ auto MorningLanguageLLVM::create_function_prototype(const std::string& name,
     );
     verifyFunction(*func);    // Like spell-check for LLVM IR
 
-    env->define(name, func);
+    m_ENV.define(name, func);
 
     return func;
 }
@@ -1442,14 +1298,31 @@ void MorningLanguageLLVM::save_module_to_file(const std::string& filename) {
     m_MODULE->print(out_file, nullptr);    // Write module contents
 }
 
+auto MorningLanguageLLVM::save_module_to_bitcode(const std::string& filename) -> bool {
+    LOG_TRACE
+
+    std::error_code err_code;
+    llvm::raw_fd_ostream out_file(filename, err_code, llvm::sys::fs::OF_None);
+    if (err_code) {
+        return false;
+    }
+
+    llvm::WriteBitcodeToFile(*m_MODULE, out_file);
+    out_file.flush();
+    return !out_file.has_error();
+}
+
 void MorningLanguageLLVM::initialize_module() {
     LOG_TRACE
 
-    m_CONTEXT = std::make_unique<llvm::LLVMContext>();
+    m_THREAD_SAFE_CONTEXT = llvm::orc::ThreadSafeContext(std::make_unique<llvm::LLVMContext>());
+    m_CONTEXT = m_THREAD_SAFE_CONTEXT.getContext();
     m_MODULE = std::make_unique<llvm::Module>("MorningLangCompilationUnit",    // Module name
                                               *m_CONTEXT    // Context reference
     );
     m_IR_BUILDER = std::make_unique<llvm::IRBuilder<>>(*m_CONTEXT);
+    m_STRING_LITERALS.clear();
+    m_TYPE_TABLE.clear();
 
     m_VARS_BUILDER = std::make_unique<llvm::IRBuilder<>>(*m_CONTEXT);
 }
@@ -3,7 +3,11 @@
 // LLVM Core Headers (Essential Components)
 #include <map>    ///< Standard map container
 #include <memory>    ///< Smart pointers
+#include <optional>    ///< Optional results
 #include <string>    ///< String utilities
+#include <unordered_map>    ///< Hash map container
+#include <unordered_set>    ///< Hash set container
+#include <utility>    ///< Pairs of generated operands
 #include <vector>    ///< Vector container
 
 #include <llvm/IR/BasicBlock.h>    ///< Represents basic blocks of code without branches
@@ -15,11 +19,16 @@
 #include <llvm/IR/Verifier.h>    ///< Tools for IR validity checks
 
 #include "codegen/arithmetic.hpp"
+#include "codegen/ssa.hpp"    ///< SSA construction for register locals
 #include "env.h"    ///< Environment header
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"    ///< Module ownership handed to the JIT
 #include "llvm/IR/IRBuilder.h"    ///< IR construction utilities
 #include "llvm/IR/LLVMContext.h"    ///< Context for compilation environment isolation
 #include "llvm/IR/Module.h"    ///< Container for code (similar to source file)
+#include "llvm/Passes/OptimizationLevel.h"    ///< Optimization levels for the pass pipeline
+#include "llvm/Target/TargetMachine.h"    ///< Target description used by the optimizer
 #include "parser/MorningLangGrammar.h"    ///< Grammar parser for MorningLang
+#include "time_report.hpp"    ///< Per-phase statistics for --time-report
 
 /**
  * @def GEN_BINARY_OP(Op, varName)
@@ -35,13 +44,11 @@
  */
 #define GEN_BINARY_OP(Op, varName) \
     do { \
-        auto oper1 = generate_expression(exp.list[1], env); \
-        auto oper2 = generate_expression(exp.list[2], env); \
+        auto oper1 = generate_expression(exp.list[1]); \
+        auto oper2 = generate_expression(exp.list[2]); \
         return m_IR_BUILDER->Op(oper1, oper2, varName); \
     } while (false)
 
-using env = std::shared_ptr<Environment>;    ///< Shared pointer to Environment
-
 /**
  * @struct LoopBlocks
  * @brief Structure to manage loop control flow blocks
@@ -54,6 +61,50 @@ struct LoopBlocks {
     llvm::BasicBlock* continue_block;    ///< Block to jump to when continuing loop
 };
 
+/**
+ * @struct TypeDescriptor
+ * @brief Type spelling resolved by the type table
+ */
+struct TypeDescriptor {
+    llvm::Type* type;    ///< LLVM type of the spelling
+    uint64_t size;    ///< Allocation size in bytes, 0 for unsized types such as !none
+    bool is_unsigned = false;    ///< !uint spellings, and sized or array spellings of them
+};
+
+/**
+ * @enum ReplValueKind
+ * @brief How the result of a REPL input is returned from its entry function
+ */
+enum class ReplValueKind {
+    NONE,    ///< No printable value (declarations, stores)
+    INTEGER,    ///< Integer widened to i64
+    FRACTIONAL,    ///< Double bitcast to i64
+    POINTER    ///< Pointer converted to i64
+};
+
+/**
+ * @struct ReplUnit
+ * @brief Module compiled from one REPL input
+ *
+ * The entry function takes no arguments and returns the value of the
+ * last form as i64, encoded according to kind.
+ */
+struct ReplUnit {
+    llvm::orc::ThreadSafeModule module;    ///< Module with entry function and new definitions
+    std::string entry;    ///< Name of entry function
+    ReplValueKind kind;    ///< Encoding of returned value
+};
+
+/**
+ * @struct ReplSymbol
+ * @brief Function or global defined by an earlier REPL input, declared again in later ones
+ */
+struct ReplSymbol {
+    llvm::Type* type;    ///< Function type, or value type of a global
+    bool constant = false;    ///< Declared with const, so set rejects it
+    bool is_unsigned = false;    ///< Holds or returns unsigned integers
+};
+
 /**
  * @class MorningLanguageLLVM
  * @brief Converts MorningLang source code to LLVM Intermediate Representation (IR)
@@ -81,19 +132,174 @@ class MorningLanguageLLVM {
     MorningLanguageLLVM();
 
     /**
-     * @brief Executes the full compilation pipeline
+     * @brief Executes the frontend compilation pipeline
      *
      * Processes source code through:
      * 1. Parsing to Abstract Syntax Tree (AST)
      * 2. IR generation from AST
      * 3. Module verification
-     * 4. Output to file
+     *
+     * The generated module stays in memory; use optimize() and the backend
+     * to turn it into an object file or binary.
      *
      * @param program MorningLang source code string
-     * @param output_base Base filename for output files (without extension)
      * @return int Status code (0 = success)
      */
-    auto execute(const std::string& program, const std::string& output_base) -> int;
+    auto execute(const std::string& program) -> int;
+
+    /**
+     * @brief Runs the LLVM new pass manager pipeline on the module
+     *
+     * Builds the default per-module pipeline for the given level
+     * (O0 uses the minimal O0 pipeline) and runs it in-process.
+     *
+     * @param level Optimization level (O0, O1, O2, O3, Os)
+     * @param target_machine Target used for data layout and cost model (optional)
+     */
+    void optimize(llvm::OptimizationLevel level, llvm::TargetMachine* target_machine = nullptr);
+
+    /**
+     * @brief Runs the LLVM new pass manager pipeline on any module
+     *
+     * Shared by optimize() and the JIT, which optimizes modules when
+     * they are materialized.
+     *
+     * @param module Module to optimize
+     * @param level Optimization level (O0, O1, O2, O3, Os)
+     * @param target_machine Target used for data layout and cost model (optional)
+     * @param report Receives LLVM pass timings when set (optional)
+     */
+    static void optimize_module(llvm::Module& module,
+                                llvm::OptimizationLevel level,
+                                llvm::TargetMachine* target_machine = nullptr,
+                                time_report* report = nullptr);
+
+    /**
+     * @brief Takes module with global definitions for a REPL session
+     *
+     * Must be loaded into the JIT before any unit from compile_repl_input().
+     *
+     * @return llvm::orc::ThreadSafeModule Module with predefined globals
+     */
+    auto begin_repl() -> llvm::orc::ThreadSafeModule;
+
+    /**
+     * @brief Compiles one REPL input into its own module
+     *
+     * Top-level forms are generated into a fresh module sharing the
+     * compiler's context. Top-level variables become globals, and
+     * functions and globals from earlier inputs are redeclared, so they
+     * stay usable without being recompiled.
+     *
+     * Under Logger::recoverable_errors a failed input throws compile_error
+     * after its scope and half-built module are dropped, so the session
+     * can go on.
+     *
+     * @param input Source code of one or more top-level forms
+     * @return std::optional<ReplUnit> Compiled unit, nullopt if the module does not verify
+     */
+    auto compile_repl_input(const std::string& input) -> std::optional<ReplUnit>;
+
+    /**
+     * @brief Saves generated module to file
+     *
+     * Outputs human-readable LLVM IR to specified file
+     *
+     * @param filename Output filename (.ll extension recommended)
+     */
+    void save_module_to_file(const std::string& filename);
+
+    /**
+     * @brief Saves generated module as LLVM bitcode
+     *
+     * Bitcode is written straight from the in-memory module and read back
+     * by LLVM tools without the text parser.
+     *
+     * @param filename Output filename (.bc extension recommended)
+     * @return true if the file was written
+     */
+    auto save_module_to_bitcode(const std::string& filename) -> bool;
+
+    /**
+     * @brief Collect phase timings and sizes of execute() and optimize() into report
+     *
+     * @param report Report to fill, nullptr disables collection
+     */
+    void set_time_report(time_report* report) { m_TIME_REPORT = report; }
+
+    /**
+     * @brief Compile the program as a library unit of a multi-file build
+     *
+     * Top-level forms of a library unit go into an internal function that
+     * runs from llvm.global_ctors before main, instead of into main itself,
+     * and predefined globals become internal, so the objects of several
+     * units link into one executable.
+     *
+     * @param library true for every input but the entry file
+     */
+    void set_library_unit(bool library) { m_LIBRARY_UNIT = library; }
+
+    /**
+     * @brief Keep scalar locals in SSA registers instead of stack slots
+     *
+     * Locals of integer, fractional and pointer type whose address is never
+     * taken by mem-ptr, finput or index are built into SSA form while the
+     * IR is generated, so unoptimized code and the JIT do not go through
+     * memory for them. Top-level variables of REPL inputs and library
+     * units stay globals.
+     *
+     * @param enabled true to build register locals
+     */
+    void set_ssa_locals(bool enabled) { m_SSA_LOCALS = enabled; }
+
+    /**
+     * @brief Make interface of a compiled module available to [import name]
+     *
+     * @param module Module name, the stem of its source file
+     * @param interface Interface text from get_interface() of that module
+     */
+    void add_module_interface(const std::string& module, std::string interface) {
+        m_MODULE_INTERFACES[module] = std::move(interface);
+    }
+
+    /**
+     * @brief Get interface of the compiled library unit
+     *
+     * Lists the signature of every function the unit defines and the type
+     * of every top-level const, one per line in LLVM type syntax, e.g.
+     * "func add i64 (i64, i64)" and "const SCALE i64". Importers only read
+     * this text, so it is all a dependent's compilation depends on.
+     *
+     * @return std::string Interface text, valid after execute()
+     */
+    auto get_interface() const -> std::string;
+
+    /**
+     * @brief Find modules named by top-level [import name] forms
+     *
+     * @param program MorningLang source code string
+     * @return std::vector<std::string> Imported module names in source order
+     */
+    static auto scan_imports(const std::string& program) -> std::vector<std::string>;
+
+    /**
+     * @brief Get generated module
+     *
+     * @return llvm::Module& Module owned by this compiler instance
+     */
+    auto get_module() -> llvm::Module& { return *m_MODULE; }
+
+    /**
+     * @brief Take ownership of generated module and its context
+     *
+     * Used to hand the module to the JIT. The compiler instance can not
+     * generate code afterwards.
+     *
+     * @return llvm::orc::ThreadSafeModule Module bundled with its context
+     */
+    auto take_module() -> llvm::orc::ThreadSafeModule {
+        return {std::move(m_MODULE), m_THREAD_SAFE_CONTEXT};
+    }
 
     /**
      * @brief Generates IR for any expression type
@@ -106,24 +312,56 @@ class MorningLanguageLLVM {
      * - Function calls
      * - Variable declarations
      *
+     * Lists are dispatched with a switch on the special form the parser
+     * interned for their head symbol; anything else is a function call.
+     *
+     * Integer literals take the type their context expects: the declared
+     * type of the variable, parameter or array element they initialize, or
+     * the type of the other operand. Without context they are !int64. They
+     * are unsigned if that type is, see is_unsigned_expression().
+     *
      * @param exp Expression to compile
-     * @param env Current environment
+     * @param context_type Type the value is expected to have, nullptr if unknown
+     * @param unsigned_context Whether context_type is an unsigned integer type
      * @return llvm::Value* Resulting LLVM value
      */
-    auto generate_expression(const Exp& exp, const env& env) -> llvm::Value*;
+    auto generate_expression(const Exp& exp,
+                             llvm::Type* context_type = nullptr,
+                             bool unsigned_context = false) -> llvm::Value*;
+
+    /**
+     * @brief Generates both operands of a binary form, typing a literal operand by the other one
+     *
+     * @param context_type Type expected for both operands, nullptr if unknown
+     * @param unsigned_context Whether context_type is an unsigned integer type
+     */
+    auto generate_operands(const Exp& left, const Exp& right, llvm::Type* context_type, bool unsigned_context)
+        -> std::pair<llvm::Value*, llvm::Value*>;
 
   private:
     llvm::Function* m_ACTIVE_FUNCTION {};    ///< Current function being generated
     std::vector<LoopBlocks> m_LOOP_STACK;    ///< Stack for nested loop management
-    std::unique_ptr<llvm::LLVMContext> m_CONTEXT;    ///< LLVM context for isolation
+    llvm::orc::ThreadSafeContext m_THREAD_SAFE_CONTEXT;    ///< Context shared with JIT-ed modules
+    llvm::LLVMContext* m_CONTEXT {};    ///< LLVM context for isolation
     std::unique_ptr<llvm::Module> m_MODULE;    ///< Container for generated IR
     std::unique_ptr<llvm::IRBuilder<>> m_IR_BUILDER;    ///< Builder for IR instructions
     std::unique_ptr<syntax::MorningLangGrammar> m_PARSER;    ///< Source code parser
-    std::shared_ptr<Environment> m_GLOBAL_ENV;    ///< Global symbol environment
+    Environment m_ENV;    ///< Scope stack keyed by the parser's symbol ids
     std::unique_ptr<llvm::IRBuilder<>> m_VARS_BUILDER;    ///< Builder for variable allocation
-    std::map<std::string, llvm::Value*> m_CONSTANTS;    ///< Map of constant variables
-    std::map<std::string, llvm::Value*> m_VARIABLES;    ///< Map of variables
     std::map<std::string, llvm::ArrayType*> m_ARRAY_TYPES;    ///< Map of array types
+    size_t m_TOP_LEVEL_DEPTH {};    ///< Scope depth of the REPL input or library unit, its variables become globals
+    std::map<std::string, ReplSymbol> m_REPL_SYMBOLS;    ///< Functions and globals defined by earlier REPL inputs
+    size_t m_REPL_COUNTER {};    ///< Number of compiled REPL inputs
+    time_report* m_TIME_REPORT {};    ///< Statistics sink for --time-report, usually null
+    bool m_LIBRARY_UNIT {};    ///< Top-level code goes into a module constructor instead of main
+    std::map<std::string, std::string> m_MODULE_INTERFACES;    ///< Interfaces of modules this unit may import
+    std::map<std::string, llvm::Constant*> m_STRING_LITERALS;    ///< Pooled string constants of the current module
+    std::unordered_map<std::string, TypeDescriptor> m_TYPE_TABLE;    ///< Resolved type spellings, parsed once each
+    std::map<std::string, std::string> m_TYPE_ALIASES;    ///< Names defined by [type name spelling]
+    std::vector<std::string> m_ALIASES_IN_RESOLUTION;    ///< Aliases whose spelling is being resolved, to catch cycles
+    bool m_SSA_LOCALS {};    ///< Build scalar locals as SSA values, see set_ssa_locals()
+    SsaBuilder m_SSA;    ///< Definitions of register locals per block
+    std::unordered_set<uint32_t> m_ADDRESS_TAKEN;    ///< Symbol ids of names whose storage is used directly
 
     /**
      * @brief Get size of type in bytes
@@ -132,8 +370,7 @@ class MorningLanguageLLVM {
      * @return uint64_t Size in bytes
      */
     auto get_type_size(llvm::Type* type) -> uint64_t {
-        llvm::DataLayout data_layout(m_MODULE.get());
-        return data_layout.getTypeAllocSize(type).getFixedValue();
+        return m_MODULE->getDataLayout().getTypeAllocSize(type).getFixedValue();
     }
 
     /**
@@ -174,6 +411,18 @@ class MorningLanguageLLVM {
     auto create_global_variable(const std::string& name, llvm::Constant* init_value, bool is_mutable = false)
         -> llvm::GlobalVariable*;
 
+    /**
+     * @brief Get pointer to string constant, shared by every equal literal of the module
+     *
+     * The first use creates a private unnamed_addr global, later ones
+     * reuse it, so a format string repeated in many fprint calls is
+     * emitted once.
+     *
+     * @param value String contents, escapes already processed by the lexer
+     * @return llvm::Constant* Pointer to the first character
+     */
+    auto get_string_literal(const std::string& value) -> llvm::Constant*;
+
     /**
      * @brief Maps type strings to LLVM types
      *
@@ -182,6 +431,67 @@ class MorningLanguageLLVM {
      */
     auto get_type(const std::string& type_string, const std::string& var_name) -> llvm::Type*;
 
+    /**
+     * @brief Resolves type spelling through the type table
+     *
+     * Each distinct spelling is parsed once; later declarations, parameters
+     * and sizeof of the same spelling are a table lookup. Unknown spellings
+     * fall back to !int with a warning and are not stored.
+     *
+     * @param type_string MorningLang type specifier or alias name
+     * @param var_name Name used in diagnostics
+     * @return TypeDescriptor Type, its allocation size and signedness
+     */
+    auto get_type_descriptor(const std::string& type_string, const std::string& var_name) -> TypeDescriptor;
+
+    /**
+     * @brief Parses type spelling, nested spellings are resolved through get_type
+     *
+     * An alias met again while its own spelling is resolved is reported.
+     *
+     * @return llvm::Type* Parsed type or nullptr for an unknown spelling
+     */
+    auto parse_type(const std::string& type_string, const std::string& var_name) -> llvm::Type*;
+
+    /**
+     * @brief Checks whether type spelling names unsigned integers, or a sized or array form of them
+     */
+    auto is_unsigned_spelling(const std::string& type_string) -> bool;
+
+    /**
+     * @brief Checks whether the integer exp evaluates to is unsigned
+     *
+     * Unsigned values come from !uint variables, parameters, array
+     * elements, function results and memory reads, and from byte-read.
+     * Arithmetic and bitwise operations are unsigned if either operand is.
+     * Literals are unsigned if the type they take is, i.e. an unsigned
+     * context or other operand.
+     *
+     * @param unsigned_context Whether the type exp is generated for is an unsigned integer type
+     */
+    auto is_unsigned_expression(const Exp& exp, bool unsigned_context = false) -> bool;
+
+    /**
+     * @brief Gets signedness of both operands of a binary form, as generate_operands() types them
+     *
+     * @param unsigned_context Whether the type expected for both operands is an unsigned integer type
+     * @return std::pair<bool, bool> Whether left and right operands are unsigned
+     */
+    auto operand_signs(const Exp& left, const Exp& right, bool unsigned_context) -> std::pair<bool, bool>;
+
+    /**
+     * @brief Checks whether declaration (name type) has an unsigned type
+     */
+    auto is_unsigned_declaration(const Exp& declaration) -> bool;
+
+    /**
+     * @brief Extracts variable name from declaration expression
+     *
+     * @param exp Name symbol or (name type) list
+     * @return Symbol Variable name
+     */
+    auto extract_var_name(const Exp& exp) -> Symbol;
+
     /**
      * @brief Extracts variable type from declaration expression
      *
@@ -198,25 +508,318 @@ class MorningLanguageLLVM {
      */
     auto extract_function_type(const Exp& fn_exp) -> llvm::FunctionType*;
 
+    /**
+     * @brief Checks whether function expression declares an unsigned return type
+     */
+    auto returns_unsigned(const Exp& fn_exp) -> bool;
+
     /**
      * @brief Allocates stack space for a variable
      *
      * @param name Variable name
      * @param var_type LLVM type of variable
-     * @param env Current environment
+     * @param is_constant Whether later `set` forms must reject the variable
      * @return llvm::Value* Pointer to allocated stack slot
      */
-    auto alloc_var(const std::string& name, llvm::Type* var_type, const env& env) -> llvm::Value*;
+    auto alloc_var(Symbol name, llvm::Type* var_type, bool is_constant = false) -> llvm::Value*;
+
+    /**
+     * @brief Prepare SSA construction for a new module and find names that need storage
+     *
+     * @param ast Program or REPL input about to be generated
+     */
+    void start_ssa_locals(const Exp& ast);
+
+    /**
+     * @brief Check if a local of this name and type can live in registers
+     */
+    auto is_register_candidate(Symbol name, llvm::Type* var_type) const -> bool;
+
+    /**
+     * @brief Defines a register local with its first value
+     *
+     * @param name Variable name
+     * @param var_type LLVM type of variable
+     * @param value Initial value, converted to var_type
+     * @param is_constant Whether later `set` forms must reject the variable
+     * @return llvm::Value* Stored value
+     */
+    auto define_register_var(Symbol name, llvm::Type* var_type, llvm::Value* value, bool is_constant = false)
+        -> llvm::Value*;
+
+    /**
+     * @brief Records new value of a register local in the current block
+     *
+     * Values are converted to the variable's type: integers are
+     * sign-extended or truncated, booleans zero-extended, integers
+     * assigned to fractions converted and other values of the same size
+     * reinterpreted.
+     *
+     * @return llvm::Value* Stored value
+     */
+    auto write_register_var(uint32_t variable, llvm::Value* value, const std::string& name) -> llvm::Value*;
+
+    /**
+     * @brief Reads current value of a register local
+     */
+    auto read_register_var(uint32_t variable, const std::string& name) -> llvm::Value*;
+
+    /**
+     * @brief Checks whether code is generated directly in a REPL input's or library unit's top scope
+     */
+    auto is_top_level() const -> bool;
 
     /**
      * @brief Compiles function definition to LLVM function
      *
      * @param fn_exp Function expression from AST
      * @param fn_name Name of function
-     * @param env Parent environment
      * @return llvm::Value* Pointer to generated function
      */
-    auto compile_function(const Exp& fn_exp, const std::string& fn_name, const env& env) -> llvm::Value*;
+    auto compile_function(const Exp& fn_exp, const std::string& fn_name) -> llvm::Value*;
+
+    /**
+     * @brief Checks whether exp can be evaluated at compile time
+     *
+     * Literals, constants with a known value, sizeof and arithmetic,
+     * comparison and bitwise operators over them qualify.
+     *
+     * Defined in codegen/folding.cpp.
+     */
+    auto is_foldable(const Exp& exp) const -> bool;
+
+    /**
+     * @brief Evaluates exp at compile time
+     *
+     * Uses the same generators as code generation, so folded values follow
+     * the language's typing and conversion rules exactly; no instructions
+     * are emitted for foldable expressions.
+     *
+     * Defined in codegen/folding.cpp.
+     *
+     * @return llvm::Constant* Value of exp, nullptr if it is not foldable
+     */
+    auto fold_constant(const Exp& exp) -> llvm::Constant*;
+
+    /**
+     * @brief Evaluates condition at compile time, used to drop dead branches and loops
+     *
+     * Defined in codegen/folding.cpp.
+     *
+     * @return std::optional<bool> Whether the condition holds, nullopt if it is only known at run time
+     */
+    auto fold_condition(const Exp& exp) -> std::optional<bool>;
+
+    /**
+     * @brief Generates [if cond block (elif cond block)* (else block)?]
+     *
+     * Defined in codegen/control_flow.cpp.
+     */
+    auto generate_if(const Exp& exp, llvm::Type* context_type = nullptr, bool unsigned_context = false)
+        -> llvm::Value*;
+
+    /**
+     * @brief Generates [check cond then else?]
+     *
+     * Defined in codegen/control_flow.cpp.
+     */
+    auto generate_check(const Exp& exp, llvm::Type* context_type = nullptr, bool unsigned_context = false)
+        -> llvm::Value*;
+
+    /**
+     * @brief Generates [loop body...] (exits by break)
+     *
+     * Defined in codegen/control_flow.cpp.
+     */
+    auto generate_loop(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [while cond body]
+     *
+     * Defined in codegen/control_flow.cpp.
+     */
+    auto generate_while(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [for init cond step body]
+     *
+     * Defined in codegen/control_flow.cpp.
+     */
+    auto generate_for(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [break]
+     *
+     * Defined in codegen/control_flow.cpp.
+     */
+    auto generate_break(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [continue]
+     *
+     * Defined in codegen/control_flow.cpp.
+     */
+    auto generate_continue(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [scope forms...] in a nested environment
+     *
+     * Defined in codegen/control_flow.cpp.
+     */
+    auto generate_scope(const Exp& exp, llvm::Type* context_type = nullptr, bool unsigned_context = false)
+        -> llvm::Value*;
+
+    /**
+     * @brief Generates [var decl init?] and [const decl init?]
+     *
+     * Defined in codegen/variables.cpp.
+     */
+    auto generate_var(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [set name value] and [set [index array i] value]
+     *
+     * Defined in codegen/variables.cpp.
+     */
+    auto generate_set(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates constant [array elements...]
+     *
+     * Defined in codegen/arrays.cpp.
+     */
+    auto generate_array(const Exp& exp, llvm::Type* context_type = nullptr, bool unsigned_context = false)
+        -> llvm::Value*;
+
+    /**
+     * @brief Generates [index array i] load
+     *
+     * Defined in codegen/arrays.cpp.
+     */
+    auto generate_index(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates store into array element
+     *
+     * Defined in codegen/arrays.cpp.
+     *
+     * @param index_exp [index array i] target
+     * @param value_exp Stored value
+     */
+    auto generate_index_store(const Exp& index_exp, const Exp& value_exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [func name params (-> type)? body]
+     *
+     * Defined in codegen/call.cpp.
+     */
+    auto generate_function(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates call of a user function
+     *
+     * Defined in codegen/call.cpp.
+     */
+    auto generate_call(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [fprint format args...]
+     *
+     * Defined in codegen/io_operations.cpp.
+     */
+    auto generate_fprint(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [finput format vars...]
+     *
+     * Defined in codegen/io_operations.cpp.
+     */
+    auto generate_finput(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [import name], declaring what the module's interface exports
+     *
+     * Defined in codegen/modules.cpp.
+     */
+    auto generate_import(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [type name spelling], an alias usable wherever a type is expected
+     *
+     * Defined in codegen/other.cpp.
+     */
+    auto generate_type_alias(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [sizeof type]
+     *
+     * Defined in codegen/other.cpp.
+     */
+    auto generate_sizeof(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [mem-alloc size]
+     *
+     * Defined in codegen/other.cpp.
+     */
+    auto generate_mem_alloc(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [mem-free ptr]
+     *
+     * Defined in codegen/other.cpp.
+     */
+    auto generate_mem_free(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [mem-write ptr value]
+     *
+     * Defined in codegen/other.cpp.
+     */
+    auto generate_mem_write(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [mem-read ptr type]
+     *
+     * Defined in codegen/other.cpp.
+     */
+    auto generate_mem_read(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [mem-ptr name]
+     *
+     * Defined in codegen/other.cpp.
+     */
+    auto generate_mem_ptr(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [mem-deref ptr type]
+     *
+     * Defined in codegen/other.cpp.
+     */
+    auto generate_mem_deref(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates bit-and, bit-or, bit-xor, bit-shl, bit-shr and bit-not
+     *
+     * Defined in codegen/other.cpp.
+     */
+    auto generate_bitwise(const Exp& exp, llvm::Type* context_type = nullptr, bool unsigned_context = false)
+        -> llvm::Value*;
+
+    /**
+     * @brief Generates [byte-read ptr]
+     *
+     * Defined in codegen/other.cpp.
+     */
+    auto generate_byte_read(const Exp& exp) -> llvm::Value*;
+
+    /**
+     * @brief Generates [byte-write ptr value]
+     *
+     * Defined in codegen/other.cpp.
+     */
+    auto generate_byte_write(const Exp& exp) -> llvm::Value*;
 
     /**
      * @brief Registers external function prototypes
@@ -232,21 +835,18 @@ class MorningLanguageLLVM {
      *
      * @param name Function name
      * @param type Function signature type
-     * @param env Environment for symbol registration
      * @return llvm::Function* Created function
      */
-    auto create_function(const std::string& name, llvm::FunctionType* type, const env& env)
-        -> llvm::Function*;
+    auto create_function(const std::string& name, llvm::FunctionType* type) -> llvm::Function*;
 
     /**
      * @brief Creates function prototype (declaration only)
      *
      * @param name Function name
      * @param type Function signature type
-     * @param env Environment for symbol registration
      * @return llvm::Function* Created function prototype
      */
-    auto create_function_prototype(const std::string& name, llvm::FunctionType* type, const env& env)
+    auto create_function_prototype(const std::string& name, llvm::FunctionType* type)
         -> llvm::Function*;
 
     /**
@@ -268,13 +868,22 @@ class MorningLanguageLLVM {
     auto create_basic_block(const std::string& label, llvm::Function* parent = nullptr) -> llvm::BasicBlock*;
 
     /**
-     * @brief Saves generated module to file
+     * @brief Starts new module for REPL input
      *
-     * Outputs human-readable LLVM IR to specified file
-     *
-     * @param filename Output filename (.ll extension recommended)
+     * Declares external functions and everything recorded in
+     * m_REPL_SYMBOLS, binding the declarations in the global environment.
      */
-    void save_module_to_file(const std::string& filename);
+    void start_repl_module();
+
+    /**
+     * @brief Generates module for one REPL input, see compile_repl_input()
+     */
+    auto generate_repl_unit(const std::string& input) -> std::optional<ReplUnit>;
+
+    /**
+     * @brief Records functions and globals of the current module visible at the REPL top level
+     */
+    void record_repl_symbols();
 
     /**
      * @brief Initializes core LLVM components
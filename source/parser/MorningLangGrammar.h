@@ -24,9 +24,9 @@
 #include <iostream>
 #include <map>
 #include <memory>
-#include <regex>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -54,13 +54,19 @@
 //   }
 //
 
+#include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <deque>
+#include <iterator>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
-enum class ExpType
+enum class ExpType : uint8_t
 {
     NUMBER,
     FRACTIONAL,
@@ -71,18 +77,244 @@ enum class ExpType
 
 static inline std::string __EOF("$");
 
+/**
+ * Special forms and reserved symbols, resolved once per distinct symbol
+ * when it is interned. NONE means an ordinary name.
+ */
+enum class SpecialForm : uint8_t
+{
+    NONE,
+    BINARY_OP,
+    ARRAY,
+    SIZEOF,
+    MEM_ALLOC,
+    MEM_FREE,
+    MEM_WRITE,
+    MEM_READ,
+    MEM_PTR,
+    MEM_DEREF,
+    BIT_AND,
+    BIT_OR,
+    BIT_XOR,
+    BIT_SHL,
+    BIT_SHR,
+    BIT_NOT,
+    BYTE_READ,
+    BYTE_WRITE,
+    INDEX,
+    IF,
+    ELIF,
+    ELSE,
+    CHECK,
+    LOOP,
+    WHILE,
+    FOR,
+    BREAK,
+    CONTINUE,
+    FUNC,
+    SET,
+    VAR,
+    CONST,
+    SCOPE,
+    FPRINT,
+    FINPUT,
+    IMPORT,
+    TYPE,
+    TRUE_LITERAL,
+    FALSE_LITERAL
+};
+
+inline constexpr std::pair<std::string_view, SpecialForm> SPECIAL_FORMS[] = {
+    {"+", SpecialForm::BINARY_OP},
+    {"-", SpecialForm::BINARY_OP},
+    {"*", SpecialForm::BINARY_OP},
+    {"/", SpecialForm::BINARY_OP},
+    {">", SpecialForm::BINARY_OP},
+    {"<", SpecialForm::BINARY_OP},
+    {">=", SpecialForm::BINARY_OP},
+    {"<=", SpecialForm::BINARY_OP},
+    {"==", SpecialForm::BINARY_OP},
+    {"!=", SpecialForm::BINARY_OP},
+    {"__PLUS_OPERAND__", SpecialForm::BINARY_OP},
+    {"__SUB_OPERAND__", SpecialForm::BINARY_OP},
+    {"__MUL_OPERAND__", SpecialForm::BINARY_OP},
+    {"__DIV_OPERAND__", SpecialForm::BINARY_OP},
+    {"__CMPG__", SpecialForm::BINARY_OP},
+    {"__CMPL__", SpecialForm::BINARY_OP},
+    {"__CMPGE__", SpecialForm::BINARY_OP},
+    {"__CMPLE__", SpecialForm::BINARY_OP},
+    {"__CMPEQ__", SpecialForm::BINARY_OP},
+    {"__CMPNE__", SpecialForm::BINARY_OP},
+    {"array", SpecialForm::ARRAY},
+    {"sizeof", SpecialForm::SIZEOF},
+    {"mem-alloc", SpecialForm::MEM_ALLOC},
+    {"mem-free", SpecialForm::MEM_FREE},
+    {"mem-write", SpecialForm::MEM_WRITE},
+    {"mem-read", SpecialForm::MEM_READ},
+    {"mem-ptr", SpecialForm::MEM_PTR},
+    {"mem-deref", SpecialForm::MEM_DEREF},
+    {"bit-and", SpecialForm::BIT_AND},
+    {"bit-or", SpecialForm::BIT_OR},
+    {"bit-xor", SpecialForm::BIT_XOR},
+    {"bit-shl", SpecialForm::BIT_SHL},
+    {"bit-shr", SpecialForm::BIT_SHR},
+    {"bit-not", SpecialForm::BIT_NOT},
+    {"byte-read", SpecialForm::BYTE_READ},
+    {"byte-write", SpecialForm::BYTE_WRITE},
+    {"index", SpecialForm::INDEX},
+    {"if", SpecialForm::IF},
+    {"elif", SpecialForm::ELIF},
+    {"else", SpecialForm::ELSE},
+    {"check", SpecialForm::CHECK},
+    {"loop", SpecialForm::LOOP},
+    {"while", SpecialForm::WHILE},
+    {"for", SpecialForm::FOR},
+    {"break", SpecialForm::BREAK},
+    {"continue", SpecialForm::CONTINUE},
+    {"func", SpecialForm::FUNC},
+    {"set", SpecialForm::SET},
+    {"var", SpecialForm::VAR},
+    {"const", SpecialForm::CONST},
+    {"scope", SpecialForm::SCOPE},
+    {"fprint", SpecialForm::FPRINT},
+    {"finput", SpecialForm::FINPUT},
+    {"import", SpecialForm::IMPORT},
+    {"type", SpecialForm::TYPE},
+    {"true", SpecialForm::TRUE_LITERAL},
+    {"false", SpecialForm::FALSE_LITERAL},
+};
+
+inline auto lookupSpecialForm(std::string_view text) -> SpecialForm {
+    for (const auto& [name, form] : SPECIAL_FORMS) {
+        if (name == text) {
+            return form;
+        }
+    }
+    return SpecialForm::NONE;
+}
+
+/**
+ * Interned string. Symbols are owned by a SymbolTable, so equal symbols
+ * share one entry and compare by pointer.
+ */
+class Symbol {
+  public:
+    struct Entry {
+        std::string text;
+        uint32_t id;    ///< Dense index in the owning table, 0 is the empty string
+        SpecialForm form;
+    };
+
+    Symbol()
+        : entry_(&emptyEntry()) {}
+
+    explicit Symbol(const Entry* entry)
+        : entry_(entry) {}
+
+    auto str() const -> const std::string& { return entry_->text; }
+    auto c_str() const -> const char* { return entry_->text.c_str(); }
+    auto size() const -> size_t { return entry_->text.size(); }
+    auto empty() const -> bool { return entry_->text.empty(); }
+    auto id() const -> uint32_t { return entry_->id; }
+    auto form() const -> SpecialForm { return entry_->form; }
+
+    auto operator[](size_t index) const -> char { return entry_->text[index]; }
+
+    operator const std::string&() const { return entry_->text; }
+
+    friend auto operator==(const Symbol& lhs, const Symbol& rhs) -> bool { return lhs.entry_ == rhs.entry_; }
+    friend auto operator!=(const Symbol& lhs, const Symbol& rhs) -> bool { return lhs.entry_ != rhs.entry_; }
+
+    friend auto operator==(const Symbol& lhs, std::string_view rhs) -> bool { return std::string_view(lhs.str()) == rhs; }
+    friend auto operator!=(const Symbol& lhs, std::string_view rhs) -> bool { return !(lhs == rhs); }
+    friend auto operator==(std::string_view lhs, const Symbol& rhs) -> bool { return rhs == lhs; }
+    friend auto operator!=(std::string_view lhs, const Symbol& rhs) -> bool { return !(rhs == lhs); }
+
+    friend auto operator+(const std::string& lhs, const Symbol& rhs) -> std::string { return lhs + rhs.str(); }
+    friend auto operator+(const Symbol& lhs, const std::string& rhs) -> std::string { return lhs.str() + rhs; }
+
+    static auto emptyEntry() -> const Entry& {
+        static const Entry EMPTY {"", 0, SpecialForm::NONE};
+        return EMPTY;
+    }
+
+  private:
+    const Entry* entry_;
+};
+
+/**
+ * Owns interned strings. Entries are never moved or freed while the
+ * table lives, so symbols stay valid across parses (the REPL relies on it).
+ */
+class SymbolTable {
+  public:
+    auto intern(std::string_view text) -> Symbol {
+        if (text.empty()) {
+            return Symbol {};
+        }
+
+        auto found = index_.find(text);
+        if (found != index_.end()) {
+            return Symbol(found->second);
+        }
+
+        auto& entry = entries_.emplace_back(Symbol::Entry {
+            std::string(text), static_cast<uint32_t>(entries_.size() + 1), lookupSpecialForm(text)});
+        index_.emplace(std::string_view(entry.text), &entry);
+        return Symbol(&entry);
+    }
+
+    /**
+     * Number of ids handed out, including the empty symbol.
+     */
+    auto size() const -> size_t { return entries_.size() + 1; }
+
+  private:
+    std::deque<Symbol::Entry> entries_;
+    std::unordered_map<std::string_view, const Symbol::Entry*> index_;
+};
+
+struct Exp;
+
+/**
+ * Non-owning view of a list's children stored contiguously in an ExpArena.
+ */
+class ExpList {
+  public:
+    ExpList() = default;
+
+    ExpList(const Exp* data, size_t size)
+        : data_(data)
+        , size_(static_cast<uint32_t>(size)) {}
+
+    auto begin() const -> const Exp* { return data_; }
+    auto end() const -> const Exp*;
+    auto size() const -> size_t { return size_; }
+    auto empty() const -> bool { return size_ == 0; }
+
+    auto operator[](size_t index) const -> const Exp&;
+
+  private:
+    const Exp* data_ = nullptr;
+    uint32_t size_ = 0;
+};
+
+/**
+ * AST node. Nodes are move-only: children live in the parser's arena and
+ * are meant to be walked by const reference, never copied out.
+ */
 struct Exp {
     ExpType type;
 
-    int line;
-    int column;
+    union {
+        int64_t number;    ///< Literals above INT64_MAX keep their bit pattern
+        double fractional;
+    };
 
-    int number;
-    double fractional;
-    std::string string;
-    std::vector<Exp> list;
+    Symbol string;
+    ExpList list;
 
-    Exp(int number)
+    Exp(int64_t number)
         : type(ExpType::NUMBER)
         , number(number) {}
 
@@ -90,19 +322,30 @@ struct Exp {
         : type(ExpType::FRACTIONAL)
         , fractional(fractional) {}
 
-    Exp(std::string& str_value) {
-        if (str_value[0] == '"') {
-            type = ExpType::STRING;
-            string = unescape(str_value.substr(1, str_value.size() - 2));
-        } else {
-            type = ExpType::SYMBOL;
-            string = str_value;
-        }
-    }
+    Exp(ExpType type, Symbol string)
+        : type(type)
+        , number(0)
+        , string(string) {}
 
-    Exp(std::vector<Exp> list)
+    Exp(ExpList list)
         : type(ExpType::LIST)
-        , list(std::move(list)) {}
+        , number(0)
+        , list(list) {}
+
+    Exp(Exp&&) = default;
+    auto operator=(Exp&&) -> Exp& = default;
+    Exp(const Exp&) = delete;
+    auto operator=(const Exp&) -> Exp& = delete;
+
+    /**
+     * Builds a STRING or SYMBOL node from its token text.
+     */
+    static auto atom(std::string_view token, SymbolTable& symbols) -> Exp {
+        if (token[0] == '"') {
+            return {ExpType::STRING, symbols.intern(unescape(std::string(token.substr(1, token.size() - 2))))};
+        }
+        return {ExpType::SYMBOL, symbols.intern(token)};
+    }
 
     auto to_string() const -> std::string {
         switch (type) {
@@ -151,7 +394,9 @@ struct Exp {
                         result += '\\';
                         break;
                     default:
-                        result += '\\' + s[i];
+                        // Unknown escapes are kept as written
+                        result += '\\';
+                        result += s[i];
                 }
             } else {
                 result += s[i];
@@ -161,16 +406,86 @@ struct Exp {
     }
 };
 
+inline auto ExpList::end() const -> const Exp* {
+    return data_ + size_;
+}
+
+inline auto ExpList::operator[](size_t index) const -> const Exp& {
+    assert(index < size_);
+    return data_[index];
+}
+
+/**
+ * Bump allocator for list children. Chunks are kept on reset, so
+ * reparsing reuses the memory of the previous AST.
+ */
+class ExpArena {
+  public:
+    /**
+     * Moves `count` nodes into the arena and returns a view over them.
+     */
+    auto store(Exp* items, size_t count) -> ExpList {
+        if (count == 0) {
+            return {};
+        }
+
+        while (current_ < chunks_.size() && chunks_[current_].capacity() - chunks_[current_].size() < count) {
+            ++current_;
+        }
+
+        if (current_ == chunks_.size()) {
+            chunks_.emplace_back().reserve(std::max(CHUNK_SIZE, count));
+        }
+
+        auto& chunk = chunks_[current_];
+        auto offset = chunk.size();
+        chunk.insert(chunk.end(), std::make_move_iterator(items), std::make_move_iterator(items + count));
+
+        return {chunk.data() + offset, count};
+    }
+
+    /**
+     * Drops all nodes; views handed out before are invalidated.
+     */
+    void reset() {
+        for (auto& chunk : chunks_) {
+            chunk.clear();
+        }
+        current_ = 0;
+    }
+
+    /**
+     * Bytes held by the arena, whether in use or kept for reuse.
+     */
+    auto bytesReserved() const -> size_t {
+        size_t total = 0;
+        for (const auto& chunk : chunks_) {
+            total += chunk.capacity() * sizeof(Exp);
+        }
+        return total;
+    }
+
+  private:
+    static constexpr size_t CHUNK_SIZE = 4096;
+
+    std::vector<std::vector<Exp>> chunks_;
+    size_t current_ = 0;
+};
+
 using Value = Exp;
 
-inline auto parseInteger(const std::string& str) -> int {
+/**
+ * Parse an integer literal in any base. Literals up to UINT64_MAX are accepted,
+ * so that !uint64 can hold every value; above INT64_MAX they wrap around.
+ */
+inline auto parseInteger(std::string_view str) -> int64_t {
     if (str.empty()) {
         return 0;
     }
 
     size_t pos = 0;
     int base = 10;
-    std::string s = str;
+    std::string s(str);
 
     bool negative = false;
     if (s[0] == '-') {
@@ -195,8 +510,13 @@ inline auto parseInteger(const std::string& str) -> int {
         }
     }
 
-    int value = std::stoi(s, &pos, base);
-    return negative ? -value : value;
+    uint64_t magnitude = 0;
+    try {
+        magnitude = std::stoull(s, &pos, base);
+    } catch (const std::out_of_range&) {
+        LOG_CRITICAL("Integer literal %s does not fit 64 bits", std::string(str).c_str());
+    }
+    return static_cast<int64_t>(negative ? 0 - magnitude : magnitude);
 }
 
 namespace syntax {
@@ -244,7 +564,7 @@ namespace syntax {
 
     struct Token {
         TokenType type;
-        std::string value;
+        std::string_view value;    ///< Points into the tokenized string
 
         int startOffset;
         int endOffset;
@@ -254,15 +574,19 @@ namespace syntax {
         int endColumn;
     };
 
-    using SharedToken = std::shared_ptr<Token>;
-
     using LexRuleHandler = TokenType (*)(const Tokenizer&, const std::string&);
 
+    /**
+     * Returns length of the rule's match at the start of the input,
+     * 0 if it does not match.
+     */
+    using LexRuleMatcher = size_t (*)(std::string_view);
+
     // ------------------------------------------------------------------
-    // Lex rule: [regex, handler]
+    // Lex rule: [matcher, handler]
 
     struct LexRule {
-        std::regex regex;
+        LexRuleMatcher match;
         LexRuleHandler handler;
     };
 
@@ -333,50 +657,57 @@ namespace syntax {
 
         /**
          * Returns next token.
+         *
+         * Rules are tried in order and the first one that matches wins,
+         * each matcher only looks at the characters of its own token.
          */
-        auto getNextToken() -> SharedToken {
-            if (!hasMoreTokens()) {
-                yytext = __EOF;
-                return toToken(TokenType::__EOF);
-            }
+        auto getNextToken() -> Token {
+            const auto& lexRulesForState = lexRulesByStartConditions_.at(getCurrentState());
 
-            auto strSlice = str_.substr(cursor_);
+            for (;;) {
+                if (!hasMoreTokens()) {
+                    yytext = __EOF;
+                    return toToken(TokenType::__EOF, __EOF);
+                }
+
+                auto strSlice = std::string_view(str_).substr(cursor_);
+                auto tokenType = TokenType::__EOF;
+                size_t length = 0;
 
-            auto lexRulesForState = lexRulesByStartConditions_.at(getCurrentState());
+                for (const auto& ruleIndex : lexRulesForState) {
+                    const auto& rule = lexRules_[ruleIndex];
+                    length = rule.match(strSlice);
 
-            for (const auto& ruleIndex : lexRulesForState) {
-                auto rule = lexRules_[ruleIndex];
-                std::smatch sm;
+                    if (length == 0) {
+                        continue;
+                    }
 
-                if (std::regex_search(strSlice, sm, rule.regex)) {
-                    yytext = sm[0];
+                    yytext.assign(strSlice.data(), length);
 
                     captureLocations_(yytext);
-                    cursor_ += yytext.length();
+                    cursor_ += static_cast<int>(length);
+
+                    tokenType = rule.handler(*this, yytext);
+                    break;
+                }
 
-                    // Manual handling of EOF token (the end of string). Return it
-                    // as `EOF` symbol.
-                    if (yytext.length() == 0) {
+                if (length == 0) {
+                    if (isEOF()) {
                         cursor_++;
+                        yytext = __EOF;
+                        return toToken(TokenType::__EOF, __EOF);
                     }
 
-                    auto tokenType = rule.handler(*this, yytext);
-
-                    if (tokenType == TokenType::__EMPTY) {
-                        return getNextToken();
-                    }
+                    throwUnexpectedToken(std::string(1, strSlice[0]), currentLine_, currentColumn_);
+                }
 
-                    return toToken(tokenType);
+                // Whitespace and comments
+                if (tokenType == TokenType::__EMPTY) {
+                    continue;
                 }
-            }
 
-            if (isEOF()) {
-                cursor_++;
-                yytext = __EOF;
-                return toToken(TokenType::__EOF);
+                return toToken(tokenType, strSlice.substr(0, length));
             }
-
-            throwUnexpectedToken(std::string(1, strSlice[0]), currentLine_, currentColumn_);
         }
 
         /**
@@ -384,17 +715,17 @@ namespace syntax {
          */
         auto isEOF() -> bool { return cursor_ == str_.length(); }
 
-        auto toToken(TokenType tokenType) -> SharedToken {
-            return std::make_shared<Token>(Token {
+        auto toToken(TokenType tokenType, std::string_view value) -> Token {
+            return Token {
                 .type = tokenType,
-                .value = yytext,
+                .value = value,
                 .startOffset = tokenStartOffset_,
                 .endOffset = tokenEndOffset_,
                 .startLine = tokenStartLine_,
                 .endLine = tokenEndLine_,
                 .startColumn = tokenStartColumn_,
                 .endColumn = tokenEndColumn_,
-            });
+            };
         }
 
         /**
@@ -445,16 +776,14 @@ namespace syntax {
             tokenStartColumn_ = tokenStartOffset_ - currentLineBeginOffset_;
 
             // Extract `\n` in the matched token.
-            std::stringstream ss {matched};
-            std::string lineStr;
-            std::getline(ss, lineStr, '\n');
-            while (ss.tellg() > 0 && ss.tellg() <= len) {
-                currentLine_++;
-                currentLineBeginOffset_ = tokenStartOffset_ + ss.tellg();
-                std::getline(ss, lineStr, '\n');
+            for (size_t i = 0; i < len; ++i) {
+                if (matched[i] == '\n') {
+                    currentLine_++;
+                    currentLineBeginOffset_ = tokenStartOffset_ + static_cast<int>(i) + 1;
+                }
             }
 
-            tokenEndOffset_ = cursor_ + len;
+            tokenEndOffset_ = cursor_ + static_cast<int>(len);
 
             // Line-based locations, end.
             tokenEndLine_ = currentLine_;
@@ -585,42 +914,220 @@ namespace syntax {
         return TokenType::SYMBOL;
     }
 
+    // ------------------------------------------------------------------
+    // Lexical rule matchers, hand-written equivalents of:
+    //
+    //   \[  \]  \(  \)  \{  \}
+    //   \/\/.*                               line comment
+    //   \/\*[\s\S]*?\*\/                     block comment
+    //   [-+]?0x[0-9a-fA-F]+                  hex
+    //   [-+]?0b[01]+                         binary
+    //   [-+]?0[0-7]+                         octal
+    //   [-+]?\d+\.\d*([eE][-+]?\d+)?         fractional
+    //   [-+]?\.\d+([eE][-+]?\d+)?            fractional
+    //   [-+]?\d+[eE][-+]?\d+                 fractional
+    //   [-+]?\d+                             decimal
+    //   \s+                                  whitespace
+    //   "(\\.|[^"\\])*"                      string
+    //   [\w\-+*=!<>/,:;#]+                   symbol
+
+    namespace lex {
+        inline auto isDigit(char c) -> bool { return c >= '0' && c <= '9'; }
+
+        inline auto isHexDigit(char c) -> bool {
+            return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+        }
+
+        inline auto isBinaryDigit(char c) -> bool { return c == '0' || c == '1'; }
+
+        inline auto isOctalDigit(char c) -> bool { return c >= '0' && c <= '7'; }
+
+        inline auto isSpace(char c) -> bool {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+        }
+
+        inline auto isLineTerminator(char c) -> bool { return c == '\n' || c == '\r'; }
+
+        inline auto isSymbol(char c) -> bool {
+            return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == '-'
+                || c == '+' || c == '*' || c == '=' || c == '!' || c == '<' || c == '>' || c == '/' || c == ','
+                || c == ':' || c == ';' || c == '#';
+        }
+
+        /**
+         * Advances pos over characters matching pred.
+         */
+        template<typename Pred>
+        inline auto skip(std::string_view str, size_t pos, Pred pred) -> size_t {
+            while (pos < str.size() && pred(str[pos])) {
+                ++pos;
+            }
+            return pos;
+        }
+
+        inline auto sign(std::string_view str) -> size_t {
+            return !str.empty() && (str[0] == '-' || str[0] == '+') ? 1 : 0;
+        }
+
+        /**
+         * Optional [eE][-+]?\d+ at pos, returns position after it.
+         */
+        inline auto exponent(std::string_view str, size_t pos) -> size_t {
+            if (pos >= str.size() || (str[pos] != 'e' && str[pos] != 'E')) {
+                return pos;
+            }
+
+            size_t digits = pos + 1;
+            if (digits < str.size() && (str[digits] == '-' || str[digits] == '+')) {
+                ++digits;
+            }
+
+            size_t end = skip(str, digits, isDigit);
+            return end > digits ? end : pos;
+        }
+
+        template<char C>
+        inline auto single(std::string_view str) -> size_t {
+            return !str.empty() && str[0] == C ? 1 : 0;
+        }
+
+        inline auto lineComment(std::string_view str) -> size_t {
+            if (str.size() < 2 || str[0] != '/' || str[1] != '/') {
+                return 0;
+            }
+            size_t pos = 2;
+            while (pos < str.size() && !isLineTerminator(str[pos])) {
+                ++pos;
+            }
+            return pos;
+        }
+
+        inline auto blockComment(std::string_view str) -> size_t {
+            if (str.size() < 2 || str[0] != '/' || str[1] != '*') {
+                return 0;
+            }
+            size_t end = str.find("*/", 2);
+            return end == std::string_view::npos ? 0 : end + 2;
+        }
+
+        template<char Prefix, bool (*IsDigit)(char)>
+        inline auto prefixed(std::string_view str) -> size_t {
+            size_t pos = sign(str);
+            if (pos + 1 >= str.size() || str[pos] != '0' || str[pos + 1] != Prefix) {
+                return 0;
+            }
+            size_t end = skip(str, pos + 2, IsDigit);
+            return end > pos + 2 ? end : 0;
+        }
+
+        inline auto octal(std::string_view str) -> size_t {
+            size_t pos = sign(str);
+            if (pos >= str.size() || str[pos] != '0') {
+                return 0;
+            }
+            size_t end = skip(str, pos + 1, isOctalDigit);
+            return end > pos + 1 ? end : 0;
+        }
+
+        inline auto fractional(std::string_view str) -> size_t {
+            size_t pos = sign(str);
+            size_t end = skip(str, pos, isDigit);
+            if (end == pos || end >= str.size() || str[end] != '.') {
+                return 0;
+            }
+            return exponent(str, skip(str, end + 1, isDigit));
+        }
+
+        inline auto fractionalLeadingDot(std::string_view str) -> size_t {
+            size_t pos = sign(str);
+            if (pos >= str.size() || str[pos] != '.') {
+                return 0;
+            }
+            size_t end = skip(str, pos + 1, isDigit);
+            return end > pos + 1 ? exponent(str, end) : 0;
+        }
+
+        inline auto fractionalExponent(std::string_view str) -> size_t {
+            size_t pos = sign(str);
+            size_t end = skip(str, pos, isDigit);
+            if (end == pos) {
+                return 0;
+            }
+            size_t after = exponent(str, end);
+            return after > end ? after : 0;
+        }
+
+        inline auto decimal(std::string_view str) -> size_t {
+            size_t pos = sign(str);
+            size_t end = skip(str, pos, isDigit);
+            return end > pos ? end : 0;
+        }
+
+        inline auto whitespace(std::string_view str) -> size_t { return skip(str, 0, isSpace); }
+
+        inline auto string(std::string_view str) -> size_t {
+            if (str.empty() || str[0] != '"') {
+                return 0;
+            }
+
+            size_t pos = 1;
+            while (pos < str.size()) {
+                if (str[pos] == '"') {
+                    return pos + 1;
+                }
+                if (str[pos] == '\\') {
+                    // `\\.` does not match a line terminator
+                    if (pos + 1 >= str.size() || isLineTerminator(str[pos + 1])) {
+                        return 0;
+                    }
+                    pos += 2;
+                    continue;
+                }
+                ++pos;
+            }
+
+            return 0;
+        }
+
+        inline auto symbol(std::string_view str) -> size_t { return skip(str, 0, isSymbol); }
+    }    // namespace lex
+
     // ------------------------------------------------------------------
     // Lexical rules.
 
     inline std::array<LexRule, Tokenizer::LEX_RULES_COUNT> Tokenizer::lexRules_ = {
-        {{std::regex(R"(^\[)"), &_lexRule1},
-         {std::regex(R"(^\])"), &_lexRule2},
-         {std::regex(R"(^\()"), &_lexRule3},
-         {std::regex(R"(^\))"), &_lexRule4},
-         {std::regex(R"(^\{)"), &_lexRule5},
-         {std::regex(R"(^\})"), &_lexRule6},
-         {std::regex(R"(^\/\/.*)"), &_lexRule7},
-         {std::regex(R"(^\/\*[\s\S]*?\*\/)"), &_lexRule8},
-         {std::regex(R"(^[-+]?0x[0-9a-fA-F]+)"), &_lexRule9},
-         {std::regex(R"(^[-+]?0b[01]+)"), &_lexRule10},
-         {std::regex(R"(^[-+]?0[0-7]+)"), &_lexRule11},
-         {std::regex(R"(^[-+]?\d+\.\d*([eE][-+]?\d+)?)"), &_lexRule12},
-         {std::regex(R"(^[-+]?\.\d+([eE][-+]?\d+)?)"), &_lexRule13},
-         {std::regex(R"(^[-+]?\d+[eE][-+]?\d+)"), &_lexRule14},
-         {std::regex(R"(^[-+]?\d+)"), &_lexRule15},
-         {std::regex(R"(^\s+)"), &_lexRule16},
-         {std::regex(R"(^"(\\.|[^"\\])*")"), &_lexRule17},
-         {std::regex(R"(^[\w\-+*=!<>/,:;#]+)"), &_lexRule18}}};
+        {{&lex::single<'['>, &_lexRule1},
+         {&lex::single<']'>, &_lexRule2},
+         {&lex::single<'('>, &_lexRule3},
+         {&lex::single<')'>, &_lexRule4},
+         {&lex::single<'{'>, &_lexRule5},
+         {&lex::single<'}'>, &_lexRule6},
+         {&lex::lineComment, &_lexRule7},
+         {&lex::blockComment, &_lexRule8},
+         {&lex::prefixed<'x', lex::isHexDigit>, &_lexRule9},
+         {&lex::prefixed<'b', lex::isBinaryDigit>, &_lexRule10},
+         {&lex::octal, &_lexRule11},
+         {&lex::fractional, &_lexRule12},
+         {&lex::fractionalLeadingDot, &_lexRule13},
+         {&lex::fractionalExponent, &_lexRule14},
+         {&lex::decimal, &_lexRule15},
+         {&lex::whitespace, &_lexRule16},
+         {&lex::string, &_lexRule17},
+         {&lex::symbol, &_lexRule18}}};
     inline std::map<TokenizerState, std::vector<size_t>> Tokenizer::lexRulesByStartConditions_ = {
         {TokenizerState::INITIAL, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17}}};
 
 #endif
 
 #define POP_V() \
-    parser.valuesStack.back(); \
+    std::move(parser.valuesStack.back()); \
     parser.valuesStack.pop_back()
 
 #define POP_T() \
     parser.tokensStack.back(); \
     parser.tokensStack.pop_back()
 
-#define PUSH_VR() parser.valuesStack.push_back(__)
+#define PUSH_VR() parser.valuesStack.push_back(std::move(__))
 #define PUSH_TR() parser.tokensStack.push_back(__)
 
     /**
@@ -628,6 +1135,7 @@ namespace syntax {
      */
     enum class TE
     {
+        Error,
         Accept,
         Shift,
         Reduce,
@@ -639,7 +1147,7 @@ namespace syntax {
      */
     struct TableEntry {
         TE type;
-        int value;
+        size_t value;    ///< State or production number
     };
 
     class MorningLangGrammar;
@@ -656,13 +1164,54 @@ namespace syntax {
      */
     struct Production {
         int opcode;
-        int rhsLength;
+        size_t rhsLength;
         ProductionHandler handler;
     };
 
-    // Key: Encoded symbol (terminal or non-terminal) index
-    // Value: TableEntry
-    using Row = std::map<int, TableEntry>;
+    // ------------------------------------------------------------------
+    // Parsing table.
+
+    namespace table {
+        constexpr size_t ROWS_COUNT = 21;
+
+        // Encoded symbols: 0-3 non-terminals, 4-17 terminals (TokenType)
+        constexpr size_t SYMBOLS_COUNT = 18;
+
+        using Row = std::array<TableEntry, SYMBOLS_COUNT>;
+
+        constexpr auto s(size_t state) -> TableEntry { return {TE::Shift, state}; }
+        constexpr auto r(size_t production) -> TableEntry { return {TE::Reduce, production}; }
+        constexpr auto t(size_t state) -> TableEntry { return {TE::Transit, state}; }
+        constexpr auto acc() -> TableEntry { return {TE::Accept, 0}; }
+        constexpr TableEntry err {TE::Error, 0};
+
+        /**
+         * Dense action/goto table: state x encoded symbol.
+         */
+        inline constexpr std::array<Row, ROWS_COUNT> entries = {{
+            {{ t(1),  t(2),  t(3),    err,  s(4),  s(5),  s(6),  s(7),  s(8),  s(9), s(10), s(11),    err, s(12),    err, s(13),    err,    err}},    // 0
+            {{   err,    err,    err,    err,    err,    err,    err,    err,    err,    err,    err,    err,    err,    err,    err,    err,    err, acc()}},    // 1
+            {{   err,    err,    err,    err,  r(1),  r(1),  r(1),  r(1),  r(1),  r(1),  r(1),  r(1),  r(1),  r(1),  r(1),  r(1),  r(1),  r(1)}},    // 2
+            {{   err,    err,    err,    err,  r(2),  r(2),  r(2),  r(2),  r(2),  r(2),  r(2),  r(2),  r(2),  r(2),  r(2),  r(2),  r(2),  r(2)}},    // 3
+            {{   err,    err,    err,    err,  r(3),  r(3),  r(3),  r(3),  r(3),  r(3),  r(3),  r(3),  r(3),  r(3),  r(3),  r(3),  r(3),  r(3)}},    // 4
+            {{   err,    err,    err,    err,  r(4),  r(4),  r(4),  r(4),  r(4),  r(4),  r(4),  r(4),  r(4),  r(4),  r(4),  r(4),  r(4),  r(4)}},    // 5
+            {{   err,    err,    err,    err,  r(5),  r(5),  r(5),  r(5),  r(5),  r(5),  r(5),  r(5),  r(5),  r(5),  r(5),  r(5),  r(5),  r(5)}},    // 6
+            {{   err,    err,    err,    err,  r(6),  r(6),  r(6),  r(6),  r(6),  r(6),  r(6),  r(6),  r(6),  r(6),  r(6),  r(6),  r(6),  r(6)}},    // 7
+            {{   err,    err,    err,    err,  r(7),  r(7),  r(7),  r(7),  r(7),  r(7),  r(7),  r(7),  r(7),  r(7),  r(7),  r(7),  r(7),  r(7)}},    // 8
+            {{   err,    err,    err,    err,  r(8),  r(8),  r(8),  r(8),  r(8),  r(8),  r(8),  r(8),  r(8),  r(8),  r(8),  r(8),  r(8),  r(8)}},    // 9
+            {{   err,    err,    err,    err,  r(9),  r(9),  r(9),  r(9),  r(9),  r(9),  r(9),  r(9),  r(9),  r(9),  r(9),  r(9),  r(9),  r(9)}},    // 10
+            {{   err,    err,    err, t(14), r(13), r(13), r(13), r(13), r(13), r(13), r(13), r(13), r(13), r(13),    err, r(13),    err,    err}},    // 11
+            {{   err,    err,    err, t(17), r(13), r(13), r(13), r(13), r(13), r(13), r(13), r(13),    err, r(13), r(13), r(13),    err,    err}},    // 12
+            {{   err,    err,    err, t(19), r(13), r(13), r(13), r(13), r(13), r(13), r(13), r(13),    err, r(13),    err, r(13), r(13),    err}},    // 13
+            {{t(16),  t(2),  t(3),    err,  s(4),  s(5),  s(6),  s(7),  s(8),  s(9), s(10), s(11), s(15), s(12),    err, s(13),    err,    err}},    // 14
+            {{   err,    err,    err,    err, r(10), r(10), r(10), r(10), r(10), r(10), r(10), r(10), r(10), r(10), r(10), r(10), r(10), r(10)}},    // 15
+            {{   err,    err,    err,    err, r(14), r(14), r(14), r(14), r(14), r(14), r(14), r(14), r(14), r(14), r(14), r(14), r(14),    err}},    // 16
+            {{t(16),  t(2),  t(3),    err,  s(4),  s(5),  s(6),  s(7),  s(8),  s(9), s(10), s(11),    err, s(12), s(18), s(13),    err,    err}},    // 17
+            {{   err,    err,    err,    err, r(11), r(11), r(11), r(11), r(11), r(11), r(11), r(11), r(11), r(11), r(11), r(11), r(11), r(11)}},    // 18
+            {{t(16),  t(2),  t(3),    err,  s(4),  s(5),  s(6),  s(7),  s(8),  s(9), s(10), s(11),    err, s(12),    err, s(13), s(20),    err}},    // 19
+            {{   err,    err,    err,    err, r(12), r(12), r(12), r(12), r(12), r(12), r(12), r(12), r(12), r(12), r(12), r(12), r(12), r(12)}},    // 20
+        }};
+    }    // namespace table
 
     /**
      * Parser class.
@@ -676,14 +1225,14 @@ namespace syntax {
         std::vector<Value> valuesStack;
 
         /**
-         * Token values stack.
+         * Token values stack (views into the parsed string).
          */
-        std::vector<std::string> tokensStack;
+        std::vector<std::string_view> tokensStack;
 
         /**
          * Parsing states stack.
          */
-        std::vector<int> statesStack;
+        std::vector<size_t> statesStack;
 
         /**
          * Tokenizer.
@@ -696,7 +1245,41 @@ namespace syntax {
         int previousState;
 
         /**
-         * Parses a string.
+         * Interned symbols and string literals; outlives single parses.
+         */
+        SymbolTable symbols;
+
+        /**
+         * Storage for list children of the last parsed AST.
+         */
+        ExpArena arena;
+
+        /**
+         * Children of the lists being parsed, innermost list on top.
+         */
+        std::vector<Exp> listItems;
+
+        /**
+         * Offsets into `listItems` where each open list starts.
+         */
+        std::vector<size_t> listStarts;
+
+        /**
+         * Moves the children of the innermost open list into the arena.
+         */
+        auto closeList() -> Exp {
+            auto start = listStarts.back();
+            listStarts.pop_back();
+
+            auto list = arena.store(listItems.data() + start, listItems.size() - start);
+            listItems.erase(listItems.begin() + static_cast<std::ptrdiff_t>(start), listItems.end());
+
+            return Exp(list);
+        }
+
+        /**
+         * Parses a string. The returned tree points into the parser's
+         * arena and stays valid until the next call.
          */
         Value parse(const std::string& str) {
             // Initialize the tokenizer and the string.
@@ -706,57 +1289,53 @@ namespace syntax {
             valuesStack.clear();
             tokensStack.clear();
             statesStack.clear();
+            listItems.clear();
+            listStarts.clear();
+            arena.reset();
 
             // Initial 0 state.
             statesStack.push_back(0);
 
             auto token = tokenizer.getNextToken();
-            auto shiftedToken = token;
 
             // Main parsing loop.
             for (;;) {
                 auto state = statesStack.back();
-                auto column = (int)token->type;
+                auto column = static_cast<size_t>(token.type);
+
+                const auto& entry = table::entries[state][column];
 
-                if (table_[state].count(column) == 0) {
+                if (entry.type == TE::Error) {
                     throwUnexpectedToken(token);
                 }
 
-                auto entry = table_[state].at(column);
-
                 // Shift a token, go to state.
                 if (entry.type == TE::Shift) {
                     // Push token.
-                    tokensStack.push_back(token->value);
+                    tokensStack.push_back(token.value);
 
                     // Push next state number: "s5" -> 5
                     statesStack.push_back(entry.value);
 
-                    shiftedToken = token;
                     token = tokenizer.getNextToken();
                 }
 
                 // Reduce by production.
                 else if (entry.type == TE::Reduce)
                 {
-                    auto productionNumber = entry.value;
-                    auto production = Productions[productionNumber];
+                    const auto& production = Productions[entry.value];
 
-                    tokenizer.yytext = shiftedToken->value;
-
-                    auto rhsLength = production.rhsLength;
-                    while (rhsLength > 0) {
-                        statesStack.pop_back();
-                        rhsLength--;
-                    }
+                    statesStack.resize(statesStack.size() - production.rhsLength);
 
                     // Call the handler.
                     production.handler(*this);
 
                     auto previousState = statesStack.back();
 
-                    auto symbolToReduceWith = production.opcode;
-                    auto nextStateEntry = table_[previousState].at(symbolToReduceWith);
+                    // Only the augmented start production has no opcode, and it is accepted, never reduced
+                    assert(production.opcode >= 0);
+                    const auto& nextStateEntry =
+                        table::entries[previousState][static_cast<size_t>(production.opcode)];
                     assert(nextStateEntry.type == TE::Transit);
 
                     statesStack.push_back(nextStateEntry.value);
@@ -770,7 +1349,7 @@ namespace syntax {
 
                     // Pop the parsed value.
 
-                    auto result = valuesStack.back();
+                    auto result = std::move(valuesStack.back());
                     valuesStack.pop_back();
 
                     if (statesStack.size() != 1 || statesStack.back() != 0 || tokenizer.hasMoreTokens()) {
@@ -788,20 +1367,17 @@ namespace syntax {
         /**
          * Throws parser error on unexpected token.
          */
-        [[noreturn]] void throwUnexpectedToken(SharedToken token) {
-            if (token->type == TokenType::__EOF && !tokenizer.hasMoreTokens()) {
+        [[noreturn]] void throwUnexpectedToken(const Token& token) {
+            if (token.type == TokenType::__EOF && !tokenizer.hasMoreTokens()) {
                 std::string errMsg = "Unexpected end of input.\n";
                 std::cerr << errMsg;
                 throw std::runtime_error(errMsg.c_str());
             }
-            tokenizer.throwUnexpectedToken(token->value, token->startLine, token->startColumn);
+            tokenizer.throwUnexpectedToken(std::string(token.value), token.startLine, token.startColumn);
         }
 
         static constexpr size_t PRODUCTIONS_COUNT = 15;
         static std::array<Production, PRODUCTIONS_COUNT> Productions;
-
-        static constexpr size_t ROWS_COUNT = 21;
-        static std::array<Row, ROWS_COUNT> table_;
     };
 
     // ------------------------------------------------------------------
@@ -811,7 +1387,7 @@ namespace syntax {
         // Semantic action prologue.
         auto _1 = POP_V();
 
-        auto __ = _1;
+        auto __ = std::move(_1);
 
         // Semantic action epilogue.
         PUSH_VR();
@@ -821,7 +1397,7 @@ namespace syntax {
         // Semantic action prologue.
         auto _1 = POP_V();
 
-        auto __ = _1;
+        auto __ = std::move(_1);
 
         // Semantic action epilogue.
         PUSH_VR();
@@ -831,7 +1407,7 @@ namespace syntax {
         // Semantic action prologue.
         auto _1 = POP_V();
 
-        auto __ = _1;
+        auto __ = std::move(_1);
 
         // Semantic action epilogue.
         PUSH_VR();
@@ -881,7 +1457,7 @@ namespace syntax {
         // Semantic action prologue.
         auto _1 = POP_T();
 
-        auto __ = Exp(std::stod(_1));
+        auto __ = Exp(std::stod(std::string(_1)));
 
         // Semantic action epilogue.
         PUSH_VR();
@@ -891,7 +1467,7 @@ namespace syntax {
         // Semantic action prologue.
         auto _1 = POP_T();
 
-        auto __ = Exp(_1);
+        auto __ = Exp::atom(_1, parser.symbols);
 
         // Semantic action epilogue.
         PUSH_VR();
@@ -901,7 +1477,7 @@ namespace syntax {
         // Semantic action prologue.
         auto _1 = POP_T();
 
-        auto __ = Exp(_1);
+        auto __ = Exp::atom(_1, parser.symbols);
 
         // Semantic action epilogue.
         PUSH_VR();
@@ -910,10 +1486,10 @@ namespace syntax {
     inline void _handler11(yyparse& parser) {
         // Semantic action prologue.
         parser.tokensStack.pop_back();
-        auto _2 = POP_V();
+        parser.valuesStack.pop_back();
         parser.tokensStack.pop_back();
 
-        auto __ = _2;
+        auto __ = parser.closeList();
 
         // Semantic action epilogue.
         PUSH_VR();
@@ -922,10 +1498,10 @@ namespace syntax {
     inline void _handler12(yyparse& parser) {
         // Semantic action prologue.
         parser.tokensStack.pop_back();
-        auto _2 = POP_V();
+        parser.valuesStack.pop_back();
         parser.tokensStack.pop_back();
 
-        auto __ = _2;
+        auto __ = parser.closeList();
 
         // Semantic action epilogue.
         PUSH_VR();
@@ -934,10 +1510,10 @@ namespace syntax {
     inline void _handler13(yyparse& parser) {
         // Semantic action prologue.
         parser.tokensStack.pop_back();
-        auto _2 = POP_V();
+        parser.valuesStack.pop_back();
         parser.tokensStack.pop_back();
 
-        auto __ = _2;
+        auto __ = parser.closeList();
 
         // Semantic action epilogue.
         PUSH_VR();
@@ -946,7 +1522,8 @@ namespace syntax {
     inline void _handler14(yyparse& parser) {
         // Semantic action prologue.
 
-        auto __ = Exp(std::vector<Exp> {});
+        parser.listStarts.push_back(parser.listItems.size());
+        auto __ = Exp(ExpList {});
 
         // Semantic action epilogue.
         PUSH_VR();
@@ -957,8 +1534,8 @@ namespace syntax {
         auto _2 = POP_V();
         auto _1 = POP_V();
 
-        _1.list.push_back(_2);
-        auto __ = _1;
+        parser.listItems.push_back(std::move(_2));
+        auto __ = std::move(_1);
 
         // Semantic action epilogue.
         PUSH_VR();
@@ -980,283 +1557,6 @@ namespace syntax {
                                                                                        {3, 0, &_handler14},
                                                                                        {3, 2, &_handler15}}};
 
-    // ------------------------------------------------------------------
-    // Parsing table.
-
-    inline std::array<Row, yyparse::ROWS_COUNT> yyparse::table_ = {Row {{0, {TE::Transit, 1}},
-                                                                        {1, {TE::Transit, 2}},
-                                                                        {2, {TE::Transit, 3}},
-                                                                        {4, {TE::Shift, 4}},
-                                                                        {5, {TE::Shift, 5}},
-                                                                        {6, {TE::Shift, 6}},
-                                                                        {7, {TE::Shift, 7}},
-                                                                        {8, {TE::Shift, 8}},
-                                                                        {9, {TE::Shift, 9}},
-                                                                        {10, {TE::Shift, 10}},
-                                                                        {11, {TE::Shift, 11}},
-                                                                        {13, {TE::Shift, 12}},
-                                                                        {15, {TE::Shift, 13}}},
-                                                                   Row {{17, {TE::Accept, 0}}},
-                                                                   Row {{4, {TE::Reduce, 1}},
-                                                                        {5, {TE::Reduce, 1}},
-                                                                        {6, {TE::Reduce, 1}},
-                                                                        {7, {TE::Reduce, 1}},
-                                                                        {8, {TE::Reduce, 1}},
-                                                                        {9, {TE::Reduce, 1}},
-                                                                        {10, {TE::Reduce, 1}},
-                                                                        {11, {TE::Reduce, 1}},
-                                                                        {12, {TE::Reduce, 1}},
-                                                                        {13, {TE::Reduce, 1}},
-                                                                        {14, {TE::Reduce, 1}},
-                                                                        {15, {TE::Reduce, 1}},
-                                                                        {16, {TE::Reduce, 1}},
-                                                                        {17, {TE::Reduce, 1}}},
-                                                                   Row {{4, {TE::Reduce, 2}},
-                                                                        {5, {TE::Reduce, 2}},
-                                                                        {6, {TE::Reduce, 2}},
-                                                                        {7, {TE::Reduce, 2}},
-                                                                        {8, {TE::Reduce, 2}},
-                                                                        {9, {TE::Reduce, 2}},
-                                                                        {10, {TE::Reduce, 2}},
-                                                                        {11, {TE::Reduce, 2}},
-                                                                        {12, {TE::Reduce, 2}},
-                                                                        {13, {TE::Reduce, 2}},
-                                                                        {14, {TE::Reduce, 2}},
-                                                                        {15, {TE::Reduce, 2}},
-                                                                        {16, {TE::Reduce, 2}},
-                                                                        {17, {TE::Reduce, 2}}},
-                                                                   Row {{4, {TE::Reduce, 3}},
-                                                                        {5, {TE::Reduce, 3}},
-                                                                        {6, {TE::Reduce, 3}},
-                                                                        {7, {TE::Reduce, 3}},
-                                                                        {8, {TE::Reduce, 3}},
-                                                                        {9, {TE::Reduce, 3}},
-                                                                        {10, {TE::Reduce, 3}},
-                                                                        {11, {TE::Reduce, 3}},
-                                                                        {12, {TE::Reduce, 3}},
-                                                                        {13, {TE::Reduce, 3}},
-                                                                        {14, {TE::Reduce, 3}},
-                                                                        {15, {TE::Reduce, 3}},
-                                                                        {16, {TE::Reduce, 3}},
-                                                                        {17, {TE::Reduce, 3}}},
-                                                                   Row {{4, {TE::Reduce, 4}},
-                                                                        {5, {TE::Reduce, 4}},
-                                                                        {6, {TE::Reduce, 4}},
-                                                                        {7, {TE::Reduce, 4}},
-                                                                        {8, {TE::Reduce, 4}},
-                                                                        {9, {TE::Reduce, 4}},
-                                                                        {10, {TE::Reduce, 4}},
-                                                                        {11, {TE::Reduce, 4}},
-                                                                        {12, {TE::Reduce, 4}},
-                                                                        {13, {TE::Reduce, 4}},
-                                                                        {14, {TE::Reduce, 4}},
-                                                                        {15, {TE::Reduce, 4}},
-                                                                        {16, {TE::Reduce, 4}},
-                                                                        {17, {TE::Reduce, 4}}},
-                                                                   Row {{4, {TE::Reduce, 5}},
-                                                                        {5, {TE::Reduce, 5}},
-                                                                        {6, {TE::Reduce, 5}},
-                                                                        {7, {TE::Reduce, 5}},
-                                                                        {8, {TE::Reduce, 5}},
-                                                                        {9, {TE::Reduce, 5}},
-                                                                        {10, {TE::Reduce, 5}},
-                                                                        {11, {TE::Reduce, 5}},
-                                                                        {12, {TE::Reduce, 5}},
-                                                                        {13, {TE::Reduce, 5}},
-                                                                        {14, {TE::Reduce, 5}},
-                                                                        {15, {TE::Reduce, 5}},
-                                                                        {16, {TE::Reduce, 5}},
-                                                                        {17, {TE::Reduce, 5}}},
-                                                                   Row {{4, {TE::Reduce, 6}},
-                                                                        {5, {TE::Reduce, 6}},
-                                                                        {6, {TE::Reduce, 6}},
-                                                                        {7, {TE::Reduce, 6}},
-                                                                        {8, {TE::Reduce, 6}},
-                                                                        {9, {TE::Reduce, 6}},
-                                                                        {10, {TE::Reduce, 6}},
-                                                                        {11, {TE::Reduce, 6}},
-                                                                        {12, {TE::Reduce, 6}},
-                                                                        {13, {TE::Reduce, 6}},
-                                                                        {14, {TE::Reduce, 6}},
-                                                                        {15, {TE::Reduce, 6}},
-                                                                        {16, {TE::Reduce, 6}},
-                                                                        {17, {TE::Reduce, 6}}},
-                                                                   Row {{4, {TE::Reduce, 7}},
-                                                                        {5, {TE::Reduce, 7}},
-                                                                        {6, {TE::Reduce, 7}},
-                                                                        {7, {TE::Reduce, 7}},
-                                                                        {8, {TE::Reduce, 7}},
-                                                                        {9, {TE::Reduce, 7}},
-                                                                        {10, {TE::Reduce, 7}},
-                                                                        {11, {TE::Reduce, 7}},
-                                                                        {12, {TE::Reduce, 7}},
-                                                                        {13, {TE::Reduce, 7}},
-                                                                        {14, {TE::Reduce, 7}},
-                                                                        {15, {TE::Reduce, 7}},
-                                                                        {16, {TE::Reduce, 7}},
-                                                                        {17, {TE::Reduce, 7}}},
-                                                                   Row {{4, {TE::Reduce, 8}},
-                                                                        {5, {TE::Reduce, 8}},
-                                                                        {6, {TE::Reduce, 8}},
-                                                                        {7, {TE::Reduce, 8}},
-                                                                        {8, {TE::Reduce, 8}},
-                                                                        {9, {TE::Reduce, 8}},
-                                                                        {10, {TE::Reduce, 8}},
-                                                                        {11, {TE::Reduce, 8}},
-                                                                        {12, {TE::Reduce, 8}},
-                                                                        {13, {TE::Reduce, 8}},
-                                                                        {14, {TE::Reduce, 8}},
-                                                                        {15, {TE::Reduce, 8}},
-                                                                        {16, {TE::Reduce, 8}},
-                                                                        {17, {TE::Reduce, 8}}},
-                                                                   Row {{4, {TE::Reduce, 9}},
-                                                                        {5, {TE::Reduce, 9}},
-                                                                        {6, {TE::Reduce, 9}},
-                                                                        {7, {TE::Reduce, 9}},
-                                                                        {8, {TE::Reduce, 9}},
-                                                                        {9, {TE::Reduce, 9}},
-                                                                        {10, {TE::Reduce, 9}},
-                                                                        {11, {TE::Reduce, 9}},
-                                                                        {12, {TE::Reduce, 9}},
-                                                                        {13, {TE::Reduce, 9}},
-                                                                        {14, {TE::Reduce, 9}},
-                                                                        {15, {TE::Reduce, 9}},
-                                                                        {16, {TE::Reduce, 9}},
-                                                                        {17, {TE::Reduce, 9}}},
-                                                                   Row {{3, {TE::Transit, 14}},
-                                                                        {4, {TE::Reduce, 13}},
-                                                                        {5, {TE::Reduce, 13}},
-                                                                        {6, {TE::Reduce, 13}},
-                                                                        {7, {TE::Reduce, 13}},
-                                                                        {8, {TE::Reduce, 13}},
-                                                                        {9, {TE::Reduce, 13}},
-                                                                        {10, {TE::Reduce, 13}},
-                                                                        {11, {TE::Reduce, 13}},
-                                                                        {12, {TE::Reduce, 13}},
-                                                                        {13, {TE::Reduce, 13}},
-                                                                        {15, {TE::Reduce, 13}}},
-                                                                   Row {{3, {TE::Transit, 17}},
-                                                                        {4, {TE::Reduce, 13}},
-                                                                        {5, {TE::Reduce, 13}},
-                                                                        {6, {TE::Reduce, 13}},
-                                                                        {7, {TE::Reduce, 13}},
-                                                                        {8, {TE::Reduce, 13}},
-                                                                        {9, {TE::Reduce, 13}},
-                                                                        {10, {TE::Reduce, 13}},
-                                                                        {11, {TE::Reduce, 13}},
-                                                                        {13, {TE::Reduce, 13}},
-                                                                        {14, {TE::Reduce, 13}},
-                                                                        {15, {TE::Reduce, 13}}},
-                                                                   Row {{3, {TE::Transit, 19}},
-                                                                        {4, {TE::Reduce, 13}},
-                                                                        {5, {TE::Reduce, 13}},
-                                                                        {6, {TE::Reduce, 13}},
-                                                                        {7, {TE::Reduce, 13}},
-                                                                        {8, {TE::Reduce, 13}},
-                                                                        {9, {TE::Reduce, 13}},
-                                                                        {10, {TE::Reduce, 13}},
-                                                                        {11, {TE::Reduce, 13}},
-                                                                        {13, {TE::Reduce, 13}},
-                                                                        {15, {TE::Reduce, 13}},
-                                                                        {16, {TE::Reduce, 13}}},
-                                                                   Row {{0, {TE::Transit, 16}},
-                                                                        {1, {TE::Transit, 2}},
-                                                                        {2, {TE::Transit, 3}},
-                                                                        {4, {TE::Shift, 4}},
-                                                                        {5, {TE::Shift, 5}},
-                                                                        {6, {TE::Shift, 6}},
-                                                                        {7, {TE::Shift, 7}},
-                                                                        {8, {TE::Shift, 8}},
-                                                                        {9, {TE::Shift, 9}},
-                                                                        {10, {TE::Shift, 10}},
-                                                                        {11, {TE::Shift, 11}},
-                                                                        {12, {TE::Shift, 15}},
-                                                                        {13, {TE::Shift, 12}},
-                                                                        {15, {TE::Shift, 13}}},
-                                                                   Row {{4, {TE::Reduce, 10}},
-                                                                        {5, {TE::Reduce, 10}},
-                                                                        {6, {TE::Reduce, 10}},
-                                                                        {7, {TE::Reduce, 10}},
-                                                                        {8, {TE::Reduce, 10}},
-                                                                        {9, {TE::Reduce, 10}},
-                                                                        {10, {TE::Reduce, 10}},
-                                                                        {11, {TE::Reduce, 10}},
-                                                                        {12, {TE::Reduce, 10}},
-                                                                        {13, {TE::Reduce, 10}},
-                                                                        {14, {TE::Reduce, 10}},
-                                                                        {15, {TE::Reduce, 10}},
-                                                                        {16, {TE::Reduce, 10}},
-                                                                        {17, {TE::Reduce, 10}}},
-                                                                   Row {{4, {TE::Reduce, 14}},
-                                                                        {5, {TE::Reduce, 14}},
-                                                                        {6, {TE::Reduce, 14}},
-                                                                        {7, {TE::Reduce, 14}},
-                                                                        {8, {TE::Reduce, 14}},
-                                                                        {9, {TE::Reduce, 14}},
-                                                                        {10, {TE::Reduce, 14}},
-                                                                        {11, {TE::Reduce, 14}},
-                                                                        {12, {TE::Reduce, 14}},
-                                                                        {13, {TE::Reduce, 14}},
-                                                                        {14, {TE::Reduce, 14}},
-                                                                        {15, {TE::Reduce, 14}},
-                                                                        {16, {TE::Reduce, 14}}},
-                                                                   Row {{0, {TE::Transit, 16}},
-                                                                        {1, {TE::Transit, 2}},
-                                                                        {2, {TE::Transit, 3}},
-                                                                        {4, {TE::Shift, 4}},
-                                                                        {5, {TE::Shift, 5}},
-                                                                        {6, {TE::Shift, 6}},
-                                                                        {7, {TE::Shift, 7}},
-                                                                        {8, {TE::Shift, 8}},
-                                                                        {9, {TE::Shift, 9}},
-                                                                        {10, {TE::Shift, 10}},
-                                                                        {11, {TE::Shift, 11}},
-                                                                        {13, {TE::Shift, 12}},
-                                                                        {14, {TE::Shift, 18}},
-                                                                        {15, {TE::Shift, 13}}},
-                                                                   Row {{4, {TE::Reduce, 11}},
-                                                                        {5, {TE::Reduce, 11}},
-                                                                        {6, {TE::Reduce, 11}},
-                                                                        {7, {TE::Reduce, 11}},
-                                                                        {8, {TE::Reduce, 11}},
-                                                                        {9, {TE::Reduce, 11}},
-                                                                        {10, {TE::Reduce, 11}},
-                                                                        {11, {TE::Reduce, 11}},
-                                                                        {12, {TE::Reduce, 11}},
-                                                                        {13, {TE::Reduce, 11}},
-                                                                        {14, {TE::Reduce, 11}},
-                                                                        {15, {TE::Reduce, 11}},
-                                                                        {16, {TE::Reduce, 11}},
-                                                                        {17, {TE::Reduce, 11}}},
-                                                                   Row {{0, {TE::Transit, 16}},
-                                                                        {1, {TE::Transit, 2}},
-                                                                        {2, {TE::Transit, 3}},
-                                                                        {4, {TE::Shift, 4}},
-                                                                        {5, {TE::Shift, 5}},
-                                                                        {6, {TE::Shift, 6}},
-                                                                        {7, {TE::Shift, 7}},
-                                                                        {8, {TE::Shift, 8}},
-                                                                        {9, {TE::Shift, 9}},
-                                                                        {10, {TE::Shift, 10}},
-                                                                        {11, {TE::Shift, 11}},
-                                                                        {13, {TE::Shift, 12}},
-                                                                        {15, {TE::Shift, 13}},
-                                                                        {16, {TE::Shift, 20}}},
-                                                                   Row {{4, {TE::Reduce, 12}},
-                                                                        {5, {TE::Reduce, 12}},
-                                                                        {6, {TE::Reduce, 12}},
-                                                                        {7, {TE::Reduce, 12}},
-                                                                        {8, {TE::Reduce, 12}},
-                                                                        {9, {TE::Reduce, 12}},
-                                                                        {10, {TE::Reduce, 12}},
-                                                                        {11, {TE::Reduce, 12}},
-                                                                        {12, {TE::Reduce, 12}},
-                                                                        {13, {TE::Reduce, 12}},
-                                                                        {14, {TE::Reduce, 12}},
-                                                                        {15, {TE::Reduce, 12}},
-                                                                        {16, {TE::Reduce, 12}},
-                                                                        {17, {TE::Reduce, 12}}}};
-
 }    // namespace syntax
 
 #endif
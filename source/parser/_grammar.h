@@ -147,7 +147,9 @@ struct Exp {
                         result += '\\';
                         break;
                     default:
-                        result += '\\' + s[i];
+                        // Unknown escapes are kept as written
+                        result += '\\';
+                        result += s[i];
                 }
             } else {
                 result += s[i];
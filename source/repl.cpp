@@ -0,0 +1,153 @@
+#include "repl.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "logger.hpp"
+
+namespace {
+    /**
+     * @brief Bracket depth of source, ignoring strings and comments
+     */
+    auto bracket_depth(const std::string& source) -> int {
+        int depth = 0;
+        bool in_string = false;
+
+        for (size_t i = 0; i < source.size(); ++i) {
+            char chr = source[i];
+
+            if (in_string) {
+                if (chr == '\\') {
+                    ++i;
+                } else if (chr == '"') {
+                    in_string = false;
+                }
+                continue;
+            }
+
+            if (chr == '"') {
+                in_string = true;
+            } else if (chr == '/' && i + 1 < source.size() && source[i + 1] == '/') {
+                i = source.find('\n', i);
+                if (i == std::string::npos) {
+                    break;
+                }
+            } else if (chr == '[' || chr == '(' || chr == '{') {
+                ++depth;
+            } else if (chr == ']' || chr == ')' || chr == '}') {
+                --depth;
+            }
+        }
+
+        return depth;
+    }
+
+    /**
+     * @brief Check if source has nothing but whitespace
+     */
+    auto is_blank(const std::string& source) -> bool {
+        return source.find_first_not_of(" \t\r\n") == std::string::npos;
+    }
+}    // namespace
+
+repl_session::repl_session(llvm::OptimizationLevel level, bool ssa_locals)
+    : m_JIT(/* lazy */ true) {
+    m_COMPILER.set_ssa_locals(ssa_locals);
+    m_JIT.set_optimization_level(level);
+    m_JIT.load(m_COMPILER.begin_repl());
+}
+
+auto repl_session::run(std::istream& input, std::ostream& output) -> int {
+    if (!m_JIT.is_available()) {
+        LOG_ERROR("JIT is not available");
+        return 1;
+    }
+
+    output << "Morning REPL, :quit to exit\n";
+
+    std::string source;
+    std::string line;
+
+    while (true) {
+        output << (source.empty() ? "morning> " : "...      ") << std::flush;
+
+        if (!std::getline(input, line)) {
+            output << "\n";
+            break;
+        }
+
+        if (source.empty() && (line == ":quit" || line == ":q")) {
+            break;
+        }
+
+        source += line;
+        source += '\n';
+
+        // Keep reading until every bracket is closed
+        if (bracket_depth(source) > 0) {
+            continue;
+        }
+
+        if (!is_blank(source)) {
+            evaluate(source, output);
+        }
+        source.clear();
+    }
+
+    return 0;
+}
+
+auto repl_session::evaluate(const std::string& source, std::ostream& output) -> bool {
+    // Errors are reported when raised, a bad input must not end the session
+    Logger::recoverable_errors recoverable;
+
+    try {
+        auto unit = m_COMPILER.compile_repl_input(source);
+        if (!unit) {
+            return false;
+        }
+
+        const auto ENTRY = unit->entry;
+        const auto KIND = unit->kind;
+
+        if (!m_JIT.load(std::move(unit->module))) {
+            return false;
+        }
+
+        auto entry = m_JIT.lookup(ENTRY);
+        if (entry == nullptr) {
+            return false;
+        }
+
+        int64_t result = entry();
+        std::fflush(stdout);
+
+        switch (KIND) {
+            case ReplValueKind::INTEGER:
+                output << result << "\n";
+                break;
+            case ReplValueKind::FRACTIONAL: {
+                double value = 0;
+                std::memcpy(&value, &result, sizeof(value));
+                output << value << "\n";
+                break;
+            }
+            case ReplValueKind::POINTER:
+                output << "0x" << std::hex << result << std::dec << "\n";
+                break;
+            case ReplValueKind::NONE:
+                break;
+        }
+    } catch (const compile_error&) {
+        return false;
+    } catch (const std::exception& e) {
+        LOG_ERROR("%s", e.what());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <iosfwd>
+#include <string>
+
+#include <llvm/Passes/OptimizationLevel.h>
+
+#include "jit.hpp"
+#include "morningllvm.hpp"
+
+/**
+ * @brief Interactive session on top of a lazily compiling JIT
+ *
+ * One compiler (context and global environment) and one JIT live for the
+ * whole session. Every input becomes its own small module that is run
+ * right away; functions stay callable from later inputs and are compiled
+ * only when first called.
+ */
+class repl_session {
+public:
+    /**
+     * @brief Create session
+     *
+     * @param level Optimization level applied to materialized functions
+     * @param ssa_locals Keep scalar locals in SSA registers, see MorningLanguageLLVM::set_ssa_locals()
+     */
+    repl_session(llvm::OptimizationLevel level, bool ssa_locals);
+
+    /**
+     * @brief Read-eval-print loop until end of input or :quit
+     *
+     * @param input Source of forms
+     * @param output Stream for prompts and results
+     * @return int Exit code
+     */
+    auto run(std::istream& input, std::ostream& output) -> int;
+
+private:
+    MorningLanguageLLVM m_COMPILER;
+    jit_runner m_JIT;
+
+    /**
+     * @brief Compile, run and print one input
+     *
+     * @return true if input was evaluated
+     */
+    auto evaluate(const std::string& source, std::ostream& output) -> bool;
+};
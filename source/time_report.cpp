@@ -0,0 +1,187 @@
+#include "time_report.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+
+#ifndef _WIN32
+#    include <sys/resource.h>
+#endif
+#if defined(__GLIBC__)
+#    include <malloc.h>
+#endif
+
+namespace {
+    auto wall_now_ms() -> double {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // CPU time of the calling thread, so units compiled in parallel do not count each other
+    auto cpu_now_ms() -> double {
+#ifdef _WIN32
+        return 1000.0 * static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#else
+        timespec now {};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return 1000.0 * static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) / 1.0e6;
+#endif
+    }
+
+    auto peak_rss_kb() -> int64_t {
+#ifdef _WIN32
+        return 0;
+#else
+        rusage usage {};
+        getrusage(RUSAGE_SELF, &usage);
+#    ifdef __APPLE__
+        return static_cast<int64_t>(usage.ru_maxrss) / 1024;    // Bytes on macOS
+#    else
+        return static_cast<int64_t>(usage.ru_maxrss);
+#    endif
+#endif
+    }
+
+    auto heap_in_use_kb() -> int64_t {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+        return static_cast<int64_t>(mallinfo2().uordblks / 1024);
+#else
+        return 0;
+#endif
+    }
+
+    /**
+     * @brief Quote string for JSON, names here never contain control characters
+     */
+    auto json_string(const std::string& value) -> std::string {
+        std::string quoted = "\"";
+        for (char c : value) {
+            if (c == '"' || c == '\\') {
+                quoted += '\\';
+            }
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+}    // namespace
+
+time_report::scoped_phase::scoped_phase(time_report* report, std::string name)
+    : m_REPORT(report)
+    , m_NAME(std::move(name)) {
+    if (m_REPORT == nullptr) {
+        return;
+    }
+
+    m_PEAK_RSS_START = peak_rss_kb();
+    m_HEAP_START = heap_in_use_kb();
+    m_CPU_START = cpu_now_ms();
+    m_WALL_START = wall_now_ms();
+}
+
+time_report::scoped_phase::~scoped_phase() {
+    if (m_REPORT == nullptr) {
+        return;
+    }
+
+    m_REPORT->m_PHASES.push_back({m_NAME,
+                                  wall_now_ms() - m_WALL_START,
+                                  cpu_now_ms() - m_CPU_START,
+                                  peak_rss_kb() - m_PEAK_RSS_START,
+                                  heap_in_use_kb() - m_HEAP_START});
+}
+
+void time_report::set_counter(const std::string& name, uint64_t value) {
+    for (auto& counter : m_COUNTERS) {
+        if (counter.first == name) {
+            counter.second = value;
+            return;
+        }
+    }
+    m_COUNTERS.emplace_back(name, value);
+}
+
+void time_report::set_pass_timings(std::string text, std::string json) {
+    m_PASS_TIMINGS_TEXT = std::move(text);
+    m_PASS_TIMINGS_JSON = std::move(json);
+}
+
+void time_report::merge(const time_report& unit, const std::string& prefix) {
+    for (const auto& entry : unit.m_PHASES) {
+        m_PHASES.push_back(entry);
+        m_PHASES.back().name = prefix + entry.name;
+    }
+
+    for (const auto& counter : unit.m_COUNTERS) {
+        auto existing = std::find_if(m_COUNTERS.begin(), m_COUNTERS.end(), [&](const auto& own) {
+            return own.first == counter.first;
+        });
+
+        if (existing != m_COUNTERS.end()) {
+            existing->second += counter.second;
+        } else {
+            m_COUNTERS.push_back(counter);
+        }
+    }
+}
+
+void time_report::print(std::ostream& out) const {
+    int name_width = 16;
+    for (const auto& entry : m_PHASES) {
+        name_width = std::max(name_width, static_cast<int>(entry.name.size()) + 2);
+    }
+
+    out << "===-------------------------------------------------------------------------===\n"
+        << "                          Morning compile time report\n"
+        << "===-------------------------------------------------------------------------===\n"
+        << std::left << std::setw(name_width) << "Phase" << std::right << std::setw(12) << "Wall (ms)" << std::setw(12)
+        << "CPU (ms)" << std::setw(16) << "Peak RSS (KB)" << std::setw(14) << "Heap (KB)" << "\n";
+
+    double total_wall = 0;
+    double total_cpu = 0;
+
+    for (const auto& entry : m_PHASES) {
+        out << std::left << std::setw(name_width) << entry.name << std::right << std::fixed << std::setprecision(3)
+            << std::setw(12) << entry.wall_ms << std::setw(12) << entry.cpu_ms << std::setw(16)
+            << entry.peak_rss_delta_kb << std::setw(14) << entry.heap_delta_kb << "\n";
+        total_wall += entry.wall_ms;
+        total_cpu += entry.cpu_ms;
+    }
+
+    out << std::left << std::setw(name_width) << "Total" << std::right << std::setw(12) << total_wall << std::setw(12)
+        << total_cpu << "\n\n";
+
+    for (const auto& counter : m_COUNTERS) {
+        out << std::left << std::setw(28) << counter.first << std::right << counter.second << "\n";
+    }
+
+    if (!m_PASS_TIMINGS_TEXT.empty()) {
+        out << "\n" << m_PASS_TIMINGS_TEXT;
+    }
+    out.flush();
+}
+
+auto time_report::write_json(const std::string& filename) const -> bool {
+    std::ofstream out(filename);
+    if (!out) {
+        return false;
+    }
+
+    out << "{\n  \"phases\": [";
+    for (size_t i = 0; i < m_PHASES.size(); ++i) {
+        const auto& entry = m_PHASES[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": " << json_string(entry.name)
+            << ", \"wall_ms\": " << entry.wall_ms << ", \"cpu_ms\": " << entry.cpu_ms
+            << ", \"peak_rss_delta_kb\": " << entry.peak_rss_delta_kb << ", \"heap_delta_kb\": " << entry.heap_delta_kb
+            << "}";
+    }
+
+    out << "\n  ],\n  \"counters\": {";
+    for (size_t i = 0; i < m_COUNTERS.size(); ++i) {
+        out << (i == 0 ? "\n" : ",\n") << "    " << json_string(m_COUNTERS[i].first) << ": " << m_COUNTERS[i].second;
+    }
+
+    out << "\n  },\n  \"passes\": {" << m_PASS_TIMINGS_JSON << "\n  }\n}\n";
+
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Per-phase compile statistics for --time-report
+ *
+ * Phases are measured with scoped_phase; every phase records wall and CPU
+ * time, growth of the peak resident set and, where the C library reports
+ * it, the change in heap bytes in use. Counters hold sizes such as AST
+ * nodes and IR instructions, and the optimizer contributes LLVM's own pass
+ * timings. The report prints as a table and as JSON for CI.
+ */
+class time_report {
+public:
+    struct phase {
+        std::string name;
+        double wall_ms;
+        double cpu_ms;
+        int64_t peak_rss_delta_kb;    ///< Growth of the peak resident set
+        int64_t heap_delta_kb;    ///< Change in heap bytes in use, 0 if unknown
+    };
+
+    /**
+     * @brief Measures one phase from construction to destruction
+     *
+     * Does nothing when constructed with a null report, so call sites
+     * need no checks when reporting is disabled.
+     */
+    class scoped_phase {
+    public:
+        scoped_phase(time_report* report, std::string name);
+        ~scoped_phase();
+
+        scoped_phase(const scoped_phase&) = delete;
+        auto operator=(const scoped_phase&) -> scoped_phase& = delete;
+
+    private:
+        time_report* m_REPORT;
+        std::string m_NAME;
+        double m_WALL_START {};
+        double m_CPU_START {};
+        int64_t m_PEAK_RSS_START {};
+        int64_t m_HEAP_START {};
+    };
+
+    /**
+     * @brief Set counter, replacing earlier value with the same name
+     */
+    void set_counter(const std::string& name, uint64_t value);
+
+    /**
+     * @brief Store LLVM pass timings
+     *
+     * @param text Report printed by TimePassesHandler
+     * @param json Comma separated JSON members from TimerGroup::printAllJSONValues
+     */
+    void set_pass_timings(std::string text, std::string json);
+
+    /**
+     * @brief Append phases of another report with prefixed names and add up its counters
+     *
+     * Used to combine the reports of units compiled in parallel; their pass
+     * timings are not carried over.
+     *
+     * @param unit Report of one unit
+     * @param prefix Prepended to the unit's phase names, e.g. "util.morning/"
+     */
+    void merge(const time_report& unit, const std::string& prefix);
+
+    /**
+     * @brief Print phases, counters and pass timings as tables
+     */
+    void print(std::ostream& out) const;
+
+    /**
+     * @brief Write the report as a JSON document
+     *
+     * @return true if the file was written
+     */
+    auto write_json(const std::string& filename) const -> bool;
+
+    /**
+     * @brief Get recorded phases in the order they finished
+     */
+    auto phases() const -> const std::vector<phase>& { return m_PHASES; }
+
+private:
+    std::vector<phase> m_PHASES;
+    std::vector<std::pair<std::string, uint64_t>> m_COUNTERS;
+    std::string m_PASS_TIMINGS_TEXT;
+    std::string m_PASS_TIMINGS_JSON;
+};
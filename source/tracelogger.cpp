@@ -1,26 +1,144 @@
-#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "tracelogger.hpp"
 
-#include "_default.hpp"
+namespace {
+    constexpr size_t RING_CAPACITY = size_t {1} << 20;    ///< Records kept per thread, older ones are overwritten
 
-std::string TraceLogger::Indent;
+    enum class Phase : uint8_t {
+        ENTER,
+        EXIT
+    };
 
-TraceLogger::TraceLogger(const char* filename, const char* funcname, int linenumber)
-    : m_FILENAME(filename)
-    , m_FUNCNAME(funcname) {
-    std::cout << GREY_COLOR << "::Trace::  " << Indent << "Entering " << m_FUNCNAME << "() - (" << m_FILENAME
-              << ":" << linenumber << ")" << RESET_STYLE << '\n';
-    if (Indent.empty()) {
-        Indent.append(START_INDENT_SYMBOL);
-    } else {
-        Indent.append(INDENT_SYMBOL);
+    struct Record {
+        uint64_t timestamp_ns;
+        uint32_t function_id;
+        Phase phase;
+    };
+
+    struct FunctionInfo {
+        std::string name;
+        std::string file;
+        int line;
+    };
+
+    struct ThreadRing {
+        explicit ThreadRing(uint32_t thread_id)
+            : thread_id(thread_id)
+            , records(RING_CAPACITY) {}
+
+        uint32_t thread_id;
+        std::vector<Record> records;
+        size_t count = 0;    ///< Records ever written, the ring holds the last RING_CAPACITY
+    };
+
+    /**
+     * @brief Owns the function table and every thread's ring, writes the trace at exit
+     */
+    class trace_registry {
+      public:
+        trace_registry()
+            : m_START(std::chrono::steady_clock::now()) {}
+
+        ~trace_registry() { write(); }
+
+        trace_registry(const trace_registry&) = delete;
+        auto operator=(const trace_registry&) -> trace_registry& = delete;
+
+        auto register_function(const char* filename, const char* funcname, int linenumber) -> uint32_t {
+            // Backslashes of Windows paths would have to be escaped in JSON
+            std::string file = filename;
+            std::replace(file.begin(), file.end(), '\\', '/');
+
+            std::lock_guard<std::mutex> lock(m_MUTEX);
+            m_FUNCTIONS.push_back({funcname, file, linenumber});
+            return static_cast<uint32_t>(m_FUNCTIONS.size() - 1);
+        }
+
+        auto create_ring() -> ThreadRing* {
+            std::lock_guard<std::mutex> lock(m_MUTEX);
+            m_RINGS.push_back(std::make_unique<ThreadRing>(static_cast<uint32_t>(m_RINGS.size() + 1)));
+            return m_RINGS.back().get();
+        }
+
+        auto now_ns() const -> uint64_t {
+            return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_START)
+                    .count());
+        }
+
+      private:
+        void write() {
+            std::lock_guard<std::mutex> lock(m_MUTEX);
+
+            const char* path = std::getenv("MORNING_TRACE_FILE");
+            std::FILE* out = std::fopen(path != nullptr ? path : "morning-trace.json", "w");
+            if (out == nullptr) {
+                return;
+            }
+
+            std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", out);
+
+            bool first = true;
+            for (const auto& ring : m_RINGS) {
+                const size_t KEPT = ring->count < RING_CAPACITY ? ring->count : RING_CAPACITY;
+
+                for (size_t i = ring->count - KEPT; i < ring->count; ++i) {
+                    const auto& record = ring->records[i % RING_CAPACITY];
+                    const auto& function = m_FUNCTIONS[record.function_id];
+
+                    std::fprintf(out,
+                                 "%s{\"name\":\"%s\",\"cat\":\"%s:%d\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                                 first ? "" : ",\n",
+                                 function.name.c_str(),
+                                 function.file.c_str(),
+                                 function.line,
+                                 record.phase == Phase::ENTER ? 'B' : 'E',
+                                 static_cast<double>(record.timestamp_ns) / 1000.0,
+                                 ring->thread_id);
+                    first = false;
+                }
+            }
+
+            std::fputs("\n]}\n", out);
+            std::fclose(out);
+        }
+
+        std::chrono::steady_clock::time_point m_START;
+        std::mutex m_MUTEX;
+        std::vector<FunctionInfo> m_FUNCTIONS;
+        std::vector<std::unique_ptr<ThreadRing>> m_RINGS;    ///< Outlive their threads, so nothing is lost
+    };
+
+    auto registry() -> trace_registry& {
+        static trace_registry instance;
+        return instance;
     }
+
+    void append(uint32_t function_id, Phase phase) {
+        thread_local ThreadRing* ring = registry().create_ring();
+
+        ring->records[ring->count % RING_CAPACITY] = {registry().now_ns(), function_id, phase};
+        ++ring->count;
+    }
+}    // namespace
+
+auto TraceLogger::register_function(const char* filename, const char* funcname, int linenumber) -> uint32_t {
+    return registry().register_function(filename, funcname, linenumber);
+}
+
+TraceLogger::TraceLogger(uint32_t function_id)
+    : m_FUNCTION_ID(function_id) {
+    append(m_FUNCTION_ID, Phase::ENTER);
 }
 
 TraceLogger::~TraceLogger() {
-    Indent.resize(Indent.length() - INDENT_LENGTH);
-    std::cout << GREY_COLOR << "::Trace::  " << Indent << "Leaving " << m_FUNCNAME << "() - (" << m_FILENAME
-              << ")" << RESET_STYLE << '\n';
+    append(m_FUNCTION_ID, Phase::EXIT);
 }
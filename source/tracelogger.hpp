@@ -1,9 +1,11 @@
 #pragma once
 
-#include <string>
+#include <cstdint>
 
 #ifdef __DEBUG
-#    define LOG_TRACE TraceLogger logger(__FILE__, __FUNCTION__, __LINE__);
+#    define LOG_TRACE \
+        static const uint32_t morning_trace_id_ = TraceLogger::register_function(__FILE__, __FUNCTION__, __LINE__); \
+        TraceLogger morning_trace_scope_(morning_trace_id_);
 #else
 #    define LOG_TRACE
 #endif
@@ -12,27 +14,40 @@ class TraceLogger {
     /**
      * @brief TraceLogger - use LOG_TRACE for tracing function calls
      *
+     * Every traced call appends an enter and an exit record to a ring buffer
+     * owned by the calling thread. Nothing is formatted while the compiler
+     * runs: at exit the buffers are written as Chrome Trace Event JSON to
+     * $MORNING_TRACE_FILE (morning-trace.json by default), which
+     * chrome://tracing and ui.perfetto.dev open directly.
      **/
 
   public:
-    static std::string Indent;
+    /**
+     * @brief Assign an id to a traced function, done once per LOG_TRACE site
+     *
+     * @param filename traced filename
+     * @param funcname traced function name
+     * @param linenumber line of the LOG_TRACE site
+     * @return uint32_t function id stored in the records
+     **/
+    static auto register_function(const char* filename, const char* funcname, int linenumber) -> uint32_t;
 
     /**
-     * @brief Construct a new Trace Logger object
+     * @brief Construct a new Trace Logger object, recording function entry
      *
-     * @param filename logged filename
-     * @param funcname logged function name
-     * @param linenumber logged line number where function called
+     * @param function_id id returned by register_function
      **/
-    TraceLogger(const char* filename, const char* funcname, int linenumber);
+    explicit TraceLogger(uint32_t function_id);
 
     /**
-     * @brief Destroy the Trace Logger object
+     * @brief Destroy the Trace Logger object, recording function exit
      *
      **/
     ~TraceLogger();
 
+    TraceLogger(const TraceLogger&) = delete;
+    auto operator=(const TraceLogger&) -> TraceLogger& = delete;
+
   private:
-    const char* m_FILENAME;
-    const char* m_FUNCNAME;
+    uint32_t m_FUNCTION_ID;
 };
@@ -6,15 +6,20 @@
 /**
  * @brief Implicit cast
  *
+ * Integers are sign-extended unless is_unsigned is set; booleans (i1) are
+ * always zero-extended.
+ *
  * @param value value
  * @param target_type target type
  * @param builder IR builder
+ * @param is_unsigned whether integer value is unsigned
  * @return llvm::Value*
  **/
 inline auto implicit_cast(
     llvm::Value* value,
     llvm::Type* target_type,
-    llvm::IRBuilder<>& builder
+    llvm::IRBuilder<>& builder,
+    bool is_unsigned = false
 ) -> llvm::Value* {
     if (value->getType() == target_type) {
         return value;
@@ -22,6 +27,9 @@ inline auto implicit_cast(
 
     // Handle integer to fractional conversion
     if (value->getType()->isIntegerTy() && target_type->isDoubleTy()) {
+        if (is_unsigned || value->getType()->isIntegerTy(1)) {
+            return builder.CreateUIToFP(value, target_type, "cast_uint_to_double");
+        }
         return builder.CreateSIToFP(value, target_type, "cast_int_to_double");
     }
 
@@ -35,7 +43,10 @@ inline auto implicit_cast(
         unsigned target_bits = target_type->getIntegerBitWidth();
 
         if (value_bits < target_bits) {
-            return builder.CreateZExt(value, target_type, "zext_cast");
+            if (is_unsigned || value_bits == 1) {
+                return builder.CreateZExt(value, target_type, "zext_cast");
+            }
+            return builder.CreateSExt(value, target_type, "sext_cast");
         } else if (value_bits > target_bits) {
             return builder.CreateTrunc(value, target_type, "trunc_cast");
         }
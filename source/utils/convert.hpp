@@ -1,7 +1,14 @@
 #include <llvm/IR/Type.h>
 #include "../logger.hpp"
 
-inline auto type_to_string(llvm::Type* type) -> std::string {
+/**
+ * @brief Get morning spelling of type, e.g. !int32 or !uint8 for integers
+ *
+ * @param type LLVM type
+ * @param is_unsigned whether an integer type holds unsigned values
+ * @return std::string
+ **/
+inline auto type_to_string(llvm::Type* type, bool is_unsigned = false) -> std::string {
         std::string type_str;
 
         llvm::raw_string_ostream rso(type_str);
@@ -10,17 +17,20 @@ inline auto type_to_string(llvm::Type* type) -> std::string {
 
         auto value = rso.str();
 
+        // LLVM integers carry no sign, the caller knows it
+        const std::string INT_PREFIX = is_unsigned ? "!uint" : "!int";
+
         if (value == "i64") {
-            return "!int64";
+            return INT_PREFIX + "64";
         }
         if (value == "i32") {
-            return "!int64";
+            return INT_PREFIX + "32";
         }
         if (value == "i16") {
-            return "!int64";
+            return INT_PREFIX + "16";
         }
         if (value == "i8") {
-            return "!int64";
+            return INT_PREFIX + "8";
         }
         if (value == "ptr") {
             return "!str";
@@ -35,11 +45,6 @@ inline auto type_to_string(llvm::Type* type) -> std::string {
             return "!none";
         }
 
-        // TODO
-        // if (type_str == "i8*") {
-        //     return "!str";
-        // }
-
         LOG_WARN("In codegen process type_to_string function get unknown type: %s", value.c_str());
 
         return value;
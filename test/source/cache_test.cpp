@@ -0,0 +1,131 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "cache.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+    /**
+     * @brief Empty cache directory used by one test, removed afterwards
+     */
+    class scratch_cache_dir {
+    public:
+        explicit scratch_cache_dir(const std::string& name)
+            : m_PATH(fs::temp_directory_path() / ("morninglang_" + name)) {
+            fs::remove_all(m_PATH);
+#ifdef _WIN32
+            _putenv_s("MORNING_CACHE_DIR", m_PATH.string().c_str());
+#else
+            setenv("MORNING_CACHE_DIR", m_PATH.c_str(), /* overwrite */ 1);
+#endif
+        }
+
+        ~scratch_cache_dir() {
+            std::error_code err_code;
+            fs::remove_all(m_PATH, err_code);
+        }
+
+        scratch_cache_dir(const scratch_cache_dir&) = delete;
+        auto operator=(const scratch_cache_dir&) -> scratch_cache_dir& = delete;
+
+        auto path() const -> const fs::path& { return m_PATH; }
+
+    private:
+        fs::path m_PATH;
+    };
+
+    void write_text(const fs::path& file, const std::string& text) {
+        std::ofstream output(file, std::ios::binary | std::ios::trunc);
+        output << text;
+    }
+
+    auto read_text(const fs::path& file) -> std::string {
+        std::ifstream input(file, std::ios::binary);
+        return {std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+    }
+
+    /**
+     * @brief Make entry look last used hours_ago hours ago
+     */
+    void age_entry(const scratch_cache_dir& dir, const std::string& key, int hours_ago) {
+        fs::last_write_time(dir.path() / (key + ".entry"),
+                            fs::file_time_type::clock::now() - std::chrono::hours(hours_ago));
+    }
+}    // namespace
+
+TEST_CASE("Cache keys separate every input", "[CACHE]") {
+    const auto KEY = compilation_cache::make_key("42", "0.1.0", "O2", "x86_64", "object");
+
+    REQUIRE(KEY.size() == 64);
+    REQUIRE(KEY == compilation_cache::make_key("42", "0.1.0", "O2", "x86_64", "object"));
+
+    CHECK(KEY != compilation_cache::make_key("43", "0.1.0", "O2", "x86_64", "object"));
+    CHECK(KEY != compilation_cache::make_key("42", "0.1.1", "O2", "x86_64", "object"));
+    CHECK(KEY != compilation_cache::make_key("42", "0.1.0", "O3", "x86_64", "object"));
+    CHECK(KEY != compilation_cache::make_key("42", "0.1.0", "O2", "aarch64", "object"));
+    CHECK(KEY != compilation_cache::make_key("42", "0.1.0", "O2", "x86_64", "binary"));
+
+    // Moving text from one part to the next must change the key
+    CHECK(compilation_cache::make_key("src", "ab", "c", "t", "a")
+          != compilation_cache::make_key("src", "a", "bc", "t", "a"));
+    CHECK(compilation_cache::make_key("src", "v", "O2", "t", "object")
+          != compilation_cache::make_key("objectsrc", "v", "O2", "t", ""));
+}
+
+TEST_CASE("Cache restores what was stored", "[CACHE]") {
+    scratch_cache_dir dir("cache_round_trip");
+    compilation_cache cache;
+    REQUIRE(cache.is_available());
+
+    const auto ARTIFACT = dir.path() / "artifact.o";
+    const auto RESTORED = dir.path() / "restored.o";
+    const auto KEY = compilation_cache::make_key("42", "0.1.0", "O2", "x86_64", "object");
+    write_text(ARTIFACT, std::string("object\0bytes", 12));
+
+    REQUIRE_FALSE(cache.restore(KEY, RESTORED));
+
+    cache.store(KEY, ARTIFACT);
+    REQUIRE(cache.restore(KEY, RESTORED));
+    REQUIRE(read_text(RESTORED) == std::string("object\0bytes", 12));
+
+    const auto STATS = cache.get_stats();
+    CHECK(STATS.entries == 1);
+    CHECK(STATS.total_size == 12);
+    CHECK(STATS.hits == 1);
+    CHECK(STATS.misses == 1);
+}
+
+TEST_CASE("Cache evicts least recently used entries over the size limit", "[CACHE]") {
+    scratch_cache_dir dir("cache_eviction");
+    compilation_cache cache(/* size_limit */ 100);
+
+    const auto ARTIFACT = dir.path() / "artifact.o";
+    const auto RESTORED = dir.path() / "restored.o";
+    write_text(ARTIFACT, std::string(40, 'x'));
+
+    const auto FIRST = compilation_cache::make_key("1", "0.1.0", "O2", "x86_64", "object");
+    const auto SECOND = compilation_cache::make_key("2", "0.1.0", "O2", "x86_64", "object");
+    const auto THIRD = compilation_cache::make_key("3", "0.1.0", "O2", "x86_64", "object");
+
+    cache.store(FIRST, ARTIFACT);
+    cache.store(SECOND, ARTIFACT);
+    age_entry(dir, FIRST, 2);
+    age_entry(dir, SECOND, 1);
+
+    // A hit makes the older entry the most recently used one
+    REQUIRE(cache.restore(FIRST, RESTORED));
+
+    cache.store(THIRD, ARTIFACT);
+
+    CHECK(cache.get_stats().entries == 2);
+    CHECK(cache.restore(FIRST, RESTORED));
+    CHECK_FALSE(cache.restore(SECOND, RESTORED));
+    CHECK(cache.restore(THIRD, RESTORED));
+}
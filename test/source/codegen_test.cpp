@@ -0,0 +1,452 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <regex>
+#include <string>
+
+#ifdef _WIN32
+#    include <io.h>
+#else
+#    include <unistd.h>
+#endif
+
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "logger.hpp"
+#include "morningllvm.hpp"
+#include "utils/cast.hpp"
+#include "utils/convert.hpp"
+
+namespace {
+#ifdef _WIN32
+    const auto FILE_DESCRIPTOR = _fileno;
+    const auto DUP = _dup;
+    const auto DUP2 = _dup2;
+    const auto CLOSE = _close;
+#else
+    const auto FILE_DESCRIPTOR = fileno;
+    const auto DUP = dup;
+    const auto DUP2 = dup2;
+    const auto CLOSE = close;
+#endif
+
+    /**
+     * @brief Compile program and print its module as textual IR
+     *
+     * @param ssa_locals Keep scalar locals in SSA registers, as --ssa does
+     */
+    auto compile_to_ir(const std::string& program, bool ssa_locals = false) -> std::string {
+        MorningLanguageLLVM morning_vm;
+        morning_vm.set_ssa_locals(ssa_locals);
+        REQUIRE(morning_vm.execute(program) == 0);
+
+        std::string ir;
+        llvm::raw_string_ostream stream(ir);
+        morning_vm.get_module().print(stream, nullptr);
+        return stream.str();
+    }
+
+    /**
+     * @brief Get message of the compile error program raises, empty if it compiles
+     */
+    auto compile_error_message(const std::string& program) -> std::string {
+        Logger::recoverable_errors recoverable;
+        MorningLanguageLLVM morning_vm;
+
+        try {
+            morning_vm.execute(program);
+        } catch (const compile_error& error) {
+            return error.what();
+        }
+        return {};
+    }
+
+    /**
+     * @brief Compile program and get what it writes to stderr, i.e. its warnings
+     */
+    auto compile_warnings(const std::string& program) -> std::string {
+        std::fflush(stderr);
+        auto* capture = std::tmpfile();
+        const int STDERR = FILE_DESCRIPTOR(stderr);
+        const int SAVED_STDERR = DUP(STDERR);
+        DUP2(FILE_DESCRIPTOR(capture), STDERR);
+
+        MorningLanguageLLVM morning_vm;
+        const auto RESULT = morning_vm.execute(program);
+
+        std::fflush(stderr);
+        DUP2(SAVED_STDERR, STDERR);
+        CLOSE(SAVED_STDERR);
+
+        std::string warnings;
+        std::rewind(capture);
+        for (int c = std::fgetc(capture); c != EOF; c = std::fgetc(capture)) {
+            warnings += static_cast<char>(c);
+        }
+        std::fclose(capture);
+
+        REQUIRE(RESULT == 0);
+        return warnings;
+    }
+
+    auto contains(const std::string& text, const std::string& part) -> bool {
+        return text.find(part) != std::string::npos;
+    }
+
+    /**
+     * @brief Get text of block label, from its label to the blank line after it
+     */
+    auto block_ir(const std::string& ir, const std::string& label) -> std::string {
+        const auto START = ir.find("\n" + label + ":");
+        if (START == std::string::npos) {
+            return {};
+        }
+        return ir.substr(START, ir.find("\n\n", START + 1) - START);
+    }
+
+    /**
+     * @brief Check that block starts with a phi of variable, whose name may carry a counter
+     */
+    auto has_phi(const std::string& ir, const std::string& label, const std::string& variable) -> bool {
+        return std::regex_search(block_ir(ir, label), std::regex("\n  %" + variable + "[0-9]* = phi "));
+    }
+}    // namespace
+
+TEST_CASE("Type aliases resolve through other aliases", "[TYPES]") {
+    const auto IR = compile_to_ir("[type A !int32] [type B A] [var (x B) 7] x");
+    CHECK(contains(IR, "alloca i32"));
+}
+
+TEST_CASE("Type aliases must resolve where they are defined", "[TYPES]") {
+    CHECK(compile_error_message("[type A A] [var (x A) 0]") == "Type alias \"A\" refers to itself");
+    CHECK(compile_error_message("[type A !array<A,3>]") == "Type alias \"A\" refers to itself");
+    CHECK(compile_error_message("[type A B] [type B A]") == "Type alias \"A\" names unknown type B");
+    CHECK(compile_error_message("[type A !int] [type A !frac]")
+          == "Type alias \"A\" is already defined as !int");
+}
+
+TEST_CASE("Initializers must convert to the declared type", "[TYPES]") {
+    CHECK(compile_error_message(R"([var (x !int) "s"])")
+          == "Type mismatch for 'x': declared as !int64 but initialized with !str");
+    CHECK(compile_error_message("[var (x !str) 1.5]")
+          == "Type mismatch for 'x': declared as !str but initialized with !frac");
+    CHECK(compile_error_message("[var x 1.5]")
+          == "Type mismatch for 'x': declared as !int64 but initialized with !frac");
+
+    CHECK(compile_error_message("[var (x !int8) 300]").empty());
+    CHECK(compile_error_message("[var (x !frac) 3]").empty());
+    CHECK(compile_error_message(R"([var (x !ptr) "s"])").empty());
+}
+
+TEST_CASE("SSA locals live in registers", "[SSA]") {
+    const auto IR = compile_to_ir("[func f ((n !int)) -> !int (scope [var x (+ n 1)] (set x (* x n)) x)]",
+                                  /* ssa_locals */ true);
+
+    CHECK_FALSE(contains(IR, "alloca"));
+    CHECK_FALSE(contains(IR, "load"));
+    CHECK_FALSE(contains(IR, "store"));
+
+    // Without --ssa every local gets a stack slot for mem2reg to promote
+    CHECK(contains(compile_to_ir("[func f ((n !int)) -> !int (scope [var x (+ n 1)] x)]"), "alloca i64"));
+}
+
+TEST_CASE("SSA locals merge in phis where control flow joins", "[SSA]") {
+    const auto IF_IR = compile_to_ir(R"([func f ((n !int)) -> !int (scope
+        [var x 0]
+        [if (> n 2) (set x 1) else (set x 2)]
+        x)])",
+                                     /* ssa_locals */ true);
+    CHECK(has_phi(IF_IR, "if.end", "x"));
+
+    const auto WHILE_IR = compile_to_ir(R"([func f ((n !int)) -> !int (scope
+        [while (> n 0) (set n (- n 3))]
+        n)])",
+                                        /* ssa_locals */ true);
+    CHECK(has_phi(WHILE_IR, "cond", "n"));
+
+    const auto FOR_IR = compile_to_ir(R"([func f ((n !int)) -> !int (scope
+        [var x n]
+        [for (var i 0) (< i 10) (set i (+ i 1)) (set x (+ x i))]
+        x)])",
+                                      /* ssa_locals */ true);
+    CHECK(has_phi(FOR_IR, "for.cond", "x"));
+    CHECK(has_phi(FOR_IR, "for.cond", "i"));
+
+    for (const auto& ir : {IF_IR, WHILE_IR, FOR_IR}) {
+        CHECK_FALSE(contains(ir, "alloca"));
+    }
+}
+
+TEST_CASE("SSA leaves locals whose address is taken in memory", "[SSA]") {
+    const auto IR = compile_to_ir(R"([func f ((n !int)) -> !int (scope
+        [var x n]
+        [var y 5]
+        [var (p !ptr) (mem-ptr y)]
+        [var h 0]
+        [finput "%d" h]
+        (+ x (+ y h)))])",
+                                  /* ssa_locals */ true);
+
+    CHECK(contains(IR, "%y = alloca i64"));
+    CHECK(contains(IR, "%h = alloca i64"));
+    CHECK_FALSE(contains(IR, "%x = alloca"));
+    CHECK_FALSE(contains(IR, "%p = alloca"));
+}
+
+TEST_CASE("SSA removes phis that merge a single value", "[SSA]") {
+    const auto IR = compile_to_ir(R"([func f ((n !int)) -> !int (scope
+        [var x 7]
+        [var k 3]
+        [while (> n 0) (set n (- n k))]
+        (+ n x))])",
+                                  /* ssa_locals */ true);
+
+    CHECK(has_phi(IR, "cond", "n"));
+    CHECK_FALSE(has_phi(IR, "cond", "k"));
+    CHECK_FALSE(has_phi(IR, "cond", "x"));
+    CHECK(std::regex_search(IR, std::regex("sub i64 %n[0-9]*, 3")));
+}
+
+TEST_CASE("Branches behind constant conditions are not generated", "[FOLDING]") {
+    const auto IR = compile_to_ir(R"([func f ((n !int)) -> !int (scope
+        [var a (check (> 2 1) (fprint "live1") (fprint "dead1"))]
+        [var b (check (< 2 1) (fprint "dead2") (fprint "live2"))]
+        [if (== 1 2) (fprint "dead3") elif (> n 0) (fprint "live3") else (fprint "live4")]
+        (+ a b))])");
+
+    for (const auto* dead : {"dead1", "dead2", "dead3"}) {
+        CHECK_FALSE(contains(IR, dead));
+    }
+    for (const auto* live : {"live1", "live2", "live3", "live4"}) {
+        CHECK(contains(IR, live));
+    }
+
+    // The checks are taken without a test, only the elif condition branches
+    CHECK_FALSE(contains(IR, "br i1 false"));
+    CHECK(contains(IR, "icmp sgt"));
+}
+
+TEST_CASE("A false check without else gives null of the then type", "[FOLDING]") {
+    const auto FOLDED = compile_to_ir("[func f () -> !frac (check (< 2 1) 2.5)]");
+    const auto TESTED = compile_to_ir("[func f ((n !int)) -> !frac (check (< n 1) 2.5)]");
+
+    CHECK(contains(FOLDED, "phi double [ 2.500000e+00, %then ], [ 0.000000e+00, %else ]"));
+    CHECK(contains(TESTED, "phi double [ 2.500000e+00, %then ], [ 0.000000e+00, %else ]"));
+}
+
+TEST_CASE("Loops whose condition never holds are not generated", "[FOLDING]") {
+    const auto IR = compile_to_ir(R"([func f ((n !int)) -> !int (scope
+        [while (> 1 2) (fprint "dead1")]
+        [for (var i 0) (!= 0 0) (set i (+ i 1)) (fprint "dead2")]
+        n)])");
+
+    CHECK_FALSE(contains(IR, "dead1"));
+    CHECK_FALSE(contains(IR, "dead2"));
+    CHECK_FALSE(contains(IR, "br "));
+}
+
+TEST_CASE("Arithmetic on sizeof folds to a constant", "[FOLDING]") {
+    const auto IR = compile_to_ir("[func f () -> !int (scope [var s (* 4 (sizeof !int))] s)]");
+
+    CHECK(contains(IR, "store i64 32"));
+    CHECK_FALSE(contains(IR, "mul"));
+    CHECK_FALSE(contains(IR, "getelementptr"));
+}
+
+TEST_CASE("Integers widen by the sign of their value", "[TYPES]") {
+    llvm::LLVMContext context;
+    llvm::Module module("widening", context);
+    llvm::IRBuilder<> builder(context);
+
+    auto* fn_type = llvm::FunctionType::get(
+        builder.getVoidTy(), {builder.getInt8Ty(), builder.getInt1Ty()}, /* varargs */ false);
+    auto* fn = llvm::Function::Create(fn_type, llvm::Function::ExternalLinkage, "f", module);
+    builder.SetInsertPoint(llvm::BasicBlock::Create(context, "entry", fn));
+
+    auto* byte = fn->getArg(0);
+    auto* flag = fn->getArg(1);
+
+    CHECK(llvm::isa<llvm::SExtInst>(implicit_cast(byte, builder.getInt64Ty(), builder)));
+    CHECK(llvm::isa<llvm::ZExtInst>(
+        implicit_cast(byte, builder.getInt64Ty(), builder, /* is_unsigned */ true)));
+    CHECK(llvm::isa<llvm::ZExtInst>(implicit_cast(flag, builder.getInt64Ty(), builder)));
+    CHECK(llvm::isa<llvm::TruncInst>(implicit_cast(byte, builder.getInt1Ty(), builder)));
+    CHECK(implicit_cast(byte, builder.getInt8Ty(), builder) == byte);
+
+    CHECK(llvm::isa<llvm::SIToFPInst>(implicit_cast(byte, builder.getDoubleTy(), builder)));
+    CHECK(llvm::isa<llvm::UIToFPInst>(implicit_cast(byte, builder.getDoubleTy(), builder, true)));
+
+    // Declarations pick the extension from the sign of the value
+    CHECK(contains(compile_to_ir("[func f ((a !int8)) -> !int a]"), "sext i8"));
+    CHECK(contains(compile_to_ir("[func f ((a !uint8)) -> !int a]"), "zext i8"));
+    CHECK(contains(compile_to_ir("[func f ((a !uint16)) -> !int (+ a 1)]"), "zext i16"));
+}
+
+TEST_CASE("Unsigned operands use unsigned operations", "[TYPES]") {
+    const auto SIGNED = compile_to_ir(R"(
+        [func div ((a !int32) (b !int32)) -> !int32 (/ a b)]
+        [func shr ((a !int32)) -> !int32 (bit-shr a 1)]
+        [func gt ((a !int32) (b !int32)) -> !bool (> a b)]
+        [func le ((a !int32) (b !int32)) -> !bool (<= a b)])");
+    const auto UNSIGNED = compile_to_ir(R"(
+        [func div ((a !uint32) (b !uint32)) -> !uint32 (/ a b)]
+        [func shr ((a !uint32)) -> !uint32 (bit-shr a 1)]
+        [func gt ((a !uint32) (b !uint32)) -> !bool (> a b)]
+        [func le ((a !uint32) (b !uint32)) -> !bool (<= a b)])");
+
+    CHECK(contains(SIGNED, "sdiv i32"));
+    CHECK(contains(SIGNED, "ashr i32"));
+    CHECK(contains(SIGNED, "icmp sgt i32"));
+    CHECK(contains(SIGNED, "icmp sle i32"));
+
+    CHECK(contains(UNSIGNED, "udiv i32"));
+    CHECK(contains(UNSIGNED, "lshr i32"));
+    CHECK(contains(UNSIGNED, "icmp ugt i32"));
+    CHECK(contains(UNSIGNED, "icmp ule i32"));
+
+    // One unsigned operand makes the operation unsigned, through operator tags as well
+    CHECK(contains(compile_to_ir("[func f ((a !uint32) (b !int32)) -> !int32 (/ b a)]"), "udiv i32"));
+    CHECK(contains(compile_to_ir("[func f ((a !uint32)) -> !int (/ (__PLUS_OPERAND__ a 1) 2)]"), "udiv i32"));
+}
+
+TEST_CASE("Mixed-width operands widen by their own sign", "[TYPES]") {
+    const auto ADD = compile_to_ir("[func f ((a !int8) (b !uint32)) -> !uint32 (+ a b)]");
+    CHECK(std::regex_search(ADD, std::regex("sext i8 %a[0-9]* to i32")));
+    CHECK_FALSE(contains(ADD, "zext i8"));
+
+    const auto DIV = compile_to_ir("[func f ((a !uint8) (b !int32)) -> !int32 (/ b a)]");
+    CHECK(std::regex_search(DIV, std::regex("zext i8 %a[0-9]* to i32")));
+    CHECK(contains(DIV, "udiv i32"));
+
+    const auto SHIFT = compile_to_ir("[func f ((x !uint32) (n !int8)) -> !uint32 (bit-shr x n)]");
+    CHECK(std::regex_search(SHIFT, std::regex("sext i8 %n[0-9]* to i32")));
+    CHECK(contains(SHIFT, "lshr i32"));
+
+    const auto MASK = compile_to_ir("[func f ((x !int16) (m !uint32)) -> !uint32 (bit-and x m)]");
+    CHECK(std::regex_search(MASK, std::regex("sext i16 %x[0-9]* to i32")));
+}
+
+TEST_CASE("Literals take the sign of the type they are given", "[TYPES]") {
+    const auto IR = compile_to_ir(R"(
+        [var (half !uint32) (/ 4000000000 2)]
+        [var (nested !uint32) (/ (+ 4000000000 0) 2)]
+        [func ret () -> !uint32 (/ 4000000000 2)]
+        [func cmp ((a !uint32)) -> !bool (> a 4000000000)]
+        [func keep ((a !int32)) -> !uint32 (/ a 2)])");
+
+    CHECK(contains(IR, "store i32 2000000000, ptr %half"));
+    CHECK(contains(IR, "store i32 2000000000, ptr %nested"));
+    CHECK(contains(IR, "ret i32 2000000000"));
+    CHECK(contains(IR, "icmp ugt i32"));
+
+    // The declared type does not change the sign of variables
+    CHECK(contains(IR, "sdiv i32"));
+    CHECK_FALSE(contains(IR, "udiv"));
+}
+
+TEST_CASE("Integer types are named by their width", "[TYPES]") {
+    llvm::LLVMContext context;
+
+    CHECK(type_to_string(llvm::Type::getInt64Ty(context)) == "!int64");
+    CHECK(type_to_string(llvm::Type::getInt32Ty(context)) == "!int32");
+    CHECK(type_to_string(llvm::Type::getInt16Ty(context)) == "!int16");
+    CHECK(type_to_string(llvm::Type::getInt8Ty(context)) == "!int8");
+    CHECK(type_to_string(llvm::Type::getInt1Ty(context)) == "!bool");
+    CHECK(type_to_string(llvm::Type::getDoubleTy(context)) == "!frac");
+
+    CHECK(type_to_string(llvm::Type::getInt64Ty(context), /* is_unsigned */ true) == "!uint64");
+    CHECK(type_to_string(llvm::Type::getInt32Ty(context), /* is_unsigned */ true) == "!uint32");
+    CHECK(type_to_string(llvm::Type::getInt16Ty(context), /* is_unsigned */ true) == "!uint16");
+    CHECK(type_to_string(llvm::Type::getInt8Ty(context), /* is_unsigned */ true) == "!uint8");
+    CHECK(type_to_string(llvm::Type::getInt1Ty(context), /* is_unsigned */ true) == "!bool");
+
+    // Diagnostics name the declared sign
+    CHECK(compile_error_message(R"([var (x !uint16) "s"])")
+          == "Type mismatch for 'x': declared as !uint16 but initialized with !str");
+}
+
+TEST_CASE("Literals that do not fit their type are reported", "[TYPES]") {
+    CHECK(contains(compile_warnings("[var (x !uint8) 300]"), "Literal 300 does not fit !uint8, truncated"));
+    CHECK(contains(compile_warnings("[var (x !int16) -40000]"),
+                   "Literal -40000 does not fit !int16, truncated"));
+    CHECK(contains(compile_warnings("[var (x !int32) 0x100000000]"),
+                   "Literal 4294967296 does not fit !int32, truncated"));
+
+    // Either reading of the bits is fine
+    for (const auto* program : {"[var (x !uint8) 255]",
+                                "[var (x !int8) -128]",
+                                "[var (x !uint32) 4294967295]",
+                                "[var (x !uint64) 18446744073709551615]"})
+    {
+        CHECK_FALSE(contains(compile_warnings(program), "does not fit"));
+    }
+}
+
+TEST_CASE("Arrays of !uint8 hold one byte per element", "[TYPES]") {
+    const auto IR = compile_to_ir(R"(
+        [var (bytes !array<!uint8,4>) (array 1 2 3 255)]
+        [var size (sizeof !array<!uint8,4>)])");
+
+    CHECK(contains(IR, "[4 x i8]"));
+    CHECK(contains(IR, "store i64 4"));
+}
+
+TEST_CASE("Operator tags type literals like their operators", "[TYPES]") {
+    // Literals only warn about the width they are given by the declaration
+    CHECK(contains(compile_warnings("[var (a !int8) (+ 300 1)]"), "Literal 300 does not fit"));
+    CHECK(contains(compile_warnings("[var (a !int8) (__PLUS_OPERAND__ 300 1)]"), "Literal 300 does not fit"));
+    CHECK(contains(compile_warnings("[var (a !int8) (__DIV_OPERAND__ 300 1)]"), "Literal 300 does not fit"));
+}
+
+TEST_CASE("Equal string literals share one global", "[STRINGS]") {
+    const auto IR = compile_to_ir(R"([fprint "v=%d\n" 1] [fprint "v=%d\n" 2])");
+
+    const std::string GLOBAL = "private unnamed_addr constant [6 x i8] c\"v=%d\\0A\\00\"";
+    const auto FIRST = IR.find(GLOBAL);
+    REQUIRE(FIRST != std::string::npos);
+    CHECK(IR.find(GLOBAL, FIRST + 1) == std::string::npos);
+}
+
+TEST_CASE("String literals reach the IR as the lexer decoded them", "[STRINGS]") {
+    const auto IR = compile_to_ir(R"([fprint "a\tb\\c\"d\n"])");
+
+    CHECK(contains(IR, "c\"a\\09b\\\\c\\22d\\0A\\00\""));
+}
+
+TEST_CASE("Imports declare what the library interface exports", "[MODULES]") {
+    MorningLanguageLLVM library;
+    library.set_library_unit(true);
+    REQUIRE(library.execute("[func add (a b) (+ a b)] [const SCALE 3]") == 0);
+
+    const auto INTERFACE = library.get_interface();
+    CHECK(contains(INTERFACE, "func add i64 (i64, i64)\n"));
+    CHECK(contains(INTERFACE, "const SCALE i64\n"));
+
+    MorningLanguageLLVM importer;
+    importer.add_module_interface("util", INTERFACE);
+    REQUIRE(importer.execute("[import util] [var r (add SCALE 2)]") == 0);
+
+    std::string ir;
+    llvm::raw_string_ostream stream(ir);
+    importer.get_module().print(stream, nullptr);
+    const auto IR = stream.str();
+    CHECK(contains(IR, "declare i64 @add(i64, i64)"));
+    CHECK(contains(IR, "@SCALE = external global i64"));
+
+    Logger::recoverable_errors recoverable;
+    MorningLanguageLLVM writer;
+    writer.add_module_interface("util", INTERFACE);
+
+    std::string message;
+    try {
+        writer.execute("[import util] [set SCALE 4]");
+    } catch (const compile_error& error) {
+        message = error.what();
+    }
+    CHECK(contains(message, "Var name \"SCALE\" is constant"));
+}
@@ -1,5 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include "logger.hpp"
 #include "morningllvm.hpp"
 
 TEST_CASE("Check base", "[BASIC]") {
@@ -12,3 +13,48 @@ TEST_CASE("Check base", "[BASIC]") {
     int status = morning_vm.execute(PROGRAM);
     REQUIRE(status == 0);
 }
+
+TEST_CASE("Failed REPL input leaves the session usable", "[REPL]") {
+    MorningLanguageLLVM morning_vm;
+    morning_vm.begin_repl();
+
+    Logger::recoverable_errors recoverable;
+
+    REQUIRE_THROWS_AS(morning_vm.compile_repl_input("[var x 1] (+ x undefined)"), compile_error);
+    REQUIRE_THROWS_AS(morning_vm.compile_repl_input("(+ 1 @)"), compile_error);
+
+    // x of the failed input was dropped, so it can be declared again
+    REQUIRE(morning_vm.compile_repl_input("[var x 2] x").has_value());
+    REQUIRE_THROWS_AS(morning_vm.compile_repl_input("[var x 3]"), compile_error);
+
+    REQUIRE(morning_vm.compile_repl_input("[func twice (a) (* a 2)]").has_value());
+    REQUIRE_THROWS_AS(morning_vm.compile_repl_input("[func twice (a) (+ a a)]"), compile_error);
+    REQUIRE(morning_vm.compile_repl_input("(twice x)").has_value());
+}
+
+TEST_CASE("REPL globals keep their const and unsigned marks", "[REPL]") {
+    MorningLanguageLLVM morning_vm;
+    morning_vm.begin_repl();
+
+    Logger::recoverable_errors recoverable;
+
+    REQUIRE(morning_vm.compile_repl_input("[const c 1] [var (u !uint32) 4000000000]").has_value());
+
+    std::string message;
+    try {
+        morning_vm.compile_repl_input("[set c 2]");
+    } catch (const compile_error& error) {
+        message = error.what();
+    }
+    REQUIRE(message.find("Var name \"c\" is constant") != std::string::npos);
+
+    auto unit = morning_vm.compile_repl_input("(/ u 2)");
+    REQUIRE(unit.has_value());
+
+    std::string ir;
+    unit->module.withModuleDo([&ir](llvm::Module& module) {
+        llvm::raw_string_ostream stream(ir);
+        module.print(stream, nullptr);
+    });
+    REQUIRE(ir.find("udiv") != std::string::npos);
+}
@@ -0,0 +1,233 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fragments.hpp"
+#include "logger.hpp"
+#include "parser/MorningLangGrammar.h"
+
+namespace fs = std::filesystem;
+
+using syntax::TokenType;
+
+namespace {
+    using token_list = std::vector<std::pair<TokenType, std::string>>;
+
+    auto tokenize(const std::string& source) -> token_list {
+        syntax::Tokenizer tokenizer;
+        tokenizer.initString(source);
+
+        token_list tokens;
+        for (auto token = tokenizer.getNextToken(); token.type != TokenType::__EOF;
+             token = tokenizer.getNextToken())
+        {
+            tokens.emplace_back(token.type, std::string(token.value));
+        }
+        return tokens;
+    }
+
+    auto read_text(const fs::path& file) -> std::string {
+        std::ifstream input(file, std::ios::binary);
+        return {std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+    }
+
+    /**
+     * @brief Get message of the syntax error source raises, empty if it parses
+     */
+    auto syntax_error(const std::string& source) -> std::string {
+        Logger::recoverable_errors recoverable;
+        syntax::MorningLangGrammar parser;
+
+        try {
+            parser.parse(source);
+        } catch (const compile_error& error) {
+            return error.what();
+        }
+        return {};
+    }
+}    // namespace
+
+TEST_CASE("Tokens end where the next rule starts", "[LEXER]") {
+    const token_list EXPECTED {
+        {TokenType::TOKEN_TYPE_11, "["},
+        {TokenType::SYMBOL, "x+1"},
+        {TokenType::DECIMAL, "-2"},
+        {TokenType::TOKEN_TYPE_13, "("},
+        {TokenType::SYMBOL, "!array<!int,4>"},
+        {TokenType::TOKEN_TYPE_14, ")"},
+        {TokenType::TOKEN_TYPE_15, "{"},
+        {TokenType::DECIMAL, "12"},
+        {TokenType::SYMBOL, "abc"},
+        {TokenType::TOKEN_TYPE_16, "}"},
+        {TokenType::SYMBOL, "-"},
+        {TokenType::TOKEN_TYPE_12, "]"},
+    };
+
+    REQUIRE(tokenize("[x+1 -2 (!array<!int,4>){12abc} -]") == EXPECTED);
+}
+
+TEST_CASE("Numbers are lexed and parsed in every base", "[LEXER]") {
+    const token_list EXPECTED {
+        {TokenType::HEX, "0x1F"},
+        {TokenType::BINARY, "-0b101"},
+        {TokenType::OCTAL, "017"},
+        {TokenType::DECIMAL, "+42"},
+        {TokenType::FRACTIONAL, "1.5"},
+        {TokenType::FRACTIONAL, ".5"},
+        {TokenType::FRACTIONAL, "1e3"},
+        {TokenType::FRACTIONAL, "2.e-1"},
+    };
+    REQUIRE(tokenize("0x1F -0b101 017 +42 1.5 .5 1e3 2.e-1") == EXPECTED);
+
+    syntax::MorningLangGrammar parser;
+
+    CHECK(parser.parse("0x1F").number == 31);
+    CHECK(parser.parse("-0x10").number == -16);
+    CHECK(parser.parse("0b101").number == 5);
+    CHECK(parser.parse("017").number == 15);
+    CHECK(parser.parse("+42").number == 42);
+    CHECK(parser.parse("0").number == 0);
+
+    const auto& fractional = parser.parse("1e3");
+    REQUIRE(fractional.type == ExpType::FRACTIONAL);
+    CHECK(fractional.fractional > 999.0);
+    CHECK(fractional.fractional < 1001.0);
+}
+
+TEST_CASE("Integer literals hold 64 bits", "[LEXER]") {
+    syntax::MorningLangGrammar parser;
+
+    CHECK(parser.parse("9223372036854775807").number == INT64_MAX);
+    CHECK(parser.parse("-9223372036854775808").number == INT64_MIN);
+    CHECK(parser.parse("-0x8000000000000000").number == INT64_MIN);
+
+    // Literals above INT64_MAX keep their bit pattern for !uint64
+    CHECK(static_cast<uint64_t>(parser.parse("18446744073709551615").number) == UINT64_MAX);
+    CHECK(static_cast<uint64_t>(parser.parse("0xFFFFFFFFFFFFFFFF").number) == UINT64_MAX);
+
+    CHECK(syntax_error("18446744073709551616")
+          == "Integer literal 18446744073709551616 does not fit 64 bits");
+}
+
+TEST_CASE("String escapes are decoded once", "[LEXER]") {
+    const token_list EXPECTED {
+        {TokenType::STRING, R"("a\"b")"},
+        {TokenType::STRING, R"("c")"},
+    };
+    REQUIRE(tokenize(R"("a\"b" "c")") == EXPECTED);
+
+    syntax::MorningLangGrammar parser;
+
+    const auto& text = parser.parse(R"("tab\tnew\nquote\"slash\\ret\r")");
+    REQUIRE(text.type == ExpType::STRING);
+    CHECK(text.string == "tab\tnew\nquote\"slash\\ret\r");
+
+    // Unknown escapes are kept as written
+    CHECK(parser.parse(R"("\q")").string == "\\q");
+}
+
+TEST_CASE("Comments and whitespace separate tokens", "[LEXER]") {
+    const token_list EXPECTED {
+        {TokenType::TOKEN_TYPE_11, "["},
+        {TokenType::SYMBOL, "a"},
+        {TokenType::SYMBOL, "b"},
+        {TokenType::SYMBOL, "c"},
+        {TokenType::TOKEN_TYPE_12, "]"},
+    };
+
+    REQUIRE(tokenize("[a // line ] comment\n\tb /* block\n ] comment */c]") == EXPECTED);
+    REQUIRE(tokenize("[a /**/b\r\nc]") == EXPECTED);
+
+    // Slashes belong to symbols, a comment only starts where a token would
+    REQUIRE(tokenize("a/**/b") == token_list {{TokenType::SYMBOL, "a/**/b"}});
+}
+
+TEST_CASE("Token locations count lines and columns from the token start", "[LEXER]") {
+    syntax::Tokenizer tokenizer;
+    tokenizer.initString("[a\n  /* x\n */ \"s\"]");
+
+    tokenizer.getNextToken();
+    tokenizer.getNextToken();
+
+    const auto TOKEN = tokenizer.getNextToken();
+    REQUIRE(TOKEN.type == TokenType::STRING);
+    CHECK(TOKEN.startLine == 3);
+    CHECK(TOKEN.startColumn == 4);
+    CHECK(TOKEN.endColumn == 7);
+    CHECK(TOKEN.startOffset == 14);
+    CHECK(TOKEN.endOffset == 17);
+}
+
+TEST_CASE("Characters no rule accepts are reported where they are", "[LEXER]") {
+    CHECK(syntax_error("[var x\n  @]").find("\"@\" at 2:2") != std::string::npos);
+    CHECK(syntax_error("[a 'b]").find("\"'\" at 1:3") != std::string::npos);
+    CHECK(syntax_error("[a b]").empty());
+}
+
+TEST_CASE("Tokens the table does not expect are reported where they are", "[PARSER]") {
+    CHECK(syntax_error("[var x)").find("\")\" at 1:6") != std::string::npos);
+    CHECK(syntax_error("[var x\n  ]]").find("\"]\" at 2:3") != std::string::npos);
+    CHECK(syntax_error("{a b]").find("\"]\" at 1:4") != std::string::npos);
+
+    syntax::MorningLangGrammar parser;
+    REQUIRE_THROWS_AS(parser.parse("[var x"), std::runtime_error);
+}
+
+TEST_CASE("Form splitter reads symbols like the lexer", "[PARSER]") {
+    const auto FORMS = split_top_level_forms("[func a:b;c () (+ x:y 1)] (a:b;c)");
+
+    REQUIRE(FORMS.size() == 2);
+    CHECK(FORMS[0].function == "a:b;c");
+    CHECK(FORMS[0].symbols == std::vector<std::string> {"func", "a:b;c", "+", "x:y", "1"});
+    CHECK(FORMS[1].symbols == std::vector<std::string> {"a:b;c"});
+}
+
+TEST_CASE("Parser builds nested lists", "[PARSER]") {
+    syntax::MorningLangGrammar parser;
+
+    const auto& ast = parser.parse("[func f ((a !int)) {+ a 1.5}]");
+    REQUIRE(ast.type == ExpType::LIST);
+    REQUIRE(ast.list.size() == 4);
+    CHECK(ast.list[0].string == "func");
+    CHECK(ast.list[0].string.form() == SpecialForm::FUNC);
+    CHECK(ast.list[2].list[0].list[1].string == "!int");
+    CHECK(ast.list[3].list[2].type == ExpType::FRACTIONAL);
+
+    // The tree of the previous parse is dropped, the parser is reusable
+    CHECK(parser.parse("[]").list.empty());
+    CHECK(parser.parse("[a [b] c]").to_string() == "[a [b] c]");
+}
+
+TEST_CASE("Examples parse into the trees of the generated parser", "[PARSER]") {
+    syntax::MorningLangGrammar parser;
+    size_t checked = 0;
+
+    for (const auto& entry : fs::directory_iterator(MORNING_EXAMPLES_DIR)) {
+        if (entry.path().extension() != ".morning") {
+            continue;
+        }
+
+        // Trees of the std::regex and std::map based parser, one top-level form per line
+        const auto EXPECTED_FILE =
+            fs::path(MORNING_TEST_DATA_DIR) / "parser" / (entry.path().stem().string() + ".ast");
+        REQUIRE(fs::exists(EXPECTED_FILE));
+
+        const auto& ast = parser.parse("[scope " + read_text(entry.path()) + "]");
+        std::string forms;
+        for (size_t i = 1; i < ast.list.size(); ++i) {
+            forms += ast.list[i].to_string() + "\n";
+        }
+
+        CHECK(forms == read_text(EXPECTED_FILE));
+        checked++;
+    }
+
+    REQUIRE(checked > 0);
+}